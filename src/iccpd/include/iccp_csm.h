@@ -36,6 +36,7 @@
 #include "../include/app_csm.h"
 #include "../include/msg_format.h"
 #include "../include/port.h"
+#include "../include/scheduler.h"
 
 #define CSM_BUFFER_SIZE 65536
 
@@ -77,6 +78,7 @@ struct Msg
     char* buf;
     size_t len;
     TAILQ_ENTRY(Msg) tail;
+    RB_ENTRY(Msg) neigh_entry_rb;   /* ARP/ND list or msg queue index */
 };
 
 /* Connection state */
@@ -106,6 +108,7 @@ struct CSM
 
     /* Socket info */
     int sock_fd;
+    struct iccp_event sock_event;
     pthread_mutex_t conn_mutex;
     time_t connTimePrev;
     time_t heartbeat_send_time;
@@ -57,11 +57,22 @@ enum MLACP_SYNC_STATE
     MLACP_SYNC_PEERLINKINFO,
     MLACP_SYNC_ARP_INFO,
     MLACP_SYNC_NDISC_INFO,
+    MLACP_SYNC_MAC_SEQ,
     MLACP_SYNC_DONE,
 };
 
 typedef enum MLACP_SYNC_STATE MLACP_SYNC_STATE_E;
 
+/* MAC freed before its MAC_SYNC_DEL reached the peer */
+#define MAC_TOMBSTONE_MAX   4096
+
+struct MACTombstone
+{
+    uint16_t vid;
+    uint8_t mac_addr[ETHER_ADDR_LEN];
+    uint32_t seq;       /* 0 until the MAC_SYNC_DEL is sent */
+};
+
 struct Remote_System
 {
     uint8_t system_id[ETHER_ADDR_LEN];
@@ -148,6 +159,18 @@ typedef struct mlacp_dbg_counter_info
     uint64_t iccp_counters[ICCP_DBG_CNTR_MSG_MAX][ICCP_DBG_CNTR_DIR_MAX][ICCP_DBG_CNTR_STS_MAX];
 }mlacp_dbg_counter_info_t;
 
+/* ARP/ND lists hold one entry per IP */
+RB_HEAD(arp_rb_tree, Msg);
+RB_PROTOTYPE(arp_rb_tree, Msg, neigh_entry_rb, ARPMsg_compare);
+RB_HEAD(ndisc_rb_tree, Msg);
+RB_PROTOTYPE(ndisc_rb_tree, Msg, neigh_entry_rb, NDISCMsg_compare);
+
+/* ARP/ND msg queues may hold several messages per IP */
+RB_HEAD(arp_msg_rb_tree, Msg);
+RB_PROTOTYPE(arp_msg_rb_tree, Msg, neigh_entry_rb, ARPMsg_queue_compare);
+RB_HEAD(ndisc_msg_rb_tree, Msg);
+RB_PROTOTYPE(ndisc_msg_rb_tree, Msg, neigh_entry_rb, NDISCMsg_queue_compare);
+
 struct mLACP
 {
     int id;
@@ -173,11 +196,32 @@ struct mLACP
     TAILQ_HEAD(mac_msg_list, MACMsg) mac_msg_list;
 
     struct mac_rb_tree mac_rb;
+    struct arp_rb_tree arp_rb;
+    struct ndisc_rb_tree ndisc_rb;
+    struct arp_msg_rb_tree arp_msg_rb;
+    struct ndisc_msg_rb_tree ndisc_msg_rb;
 
     LIST_HEAD(lif_list, LocalInterface) lif_list;
     LIST_HEAD(lif_purge_list, LocalInterface) lif_purge_list;
     LIST_HEAD(pif_list, PeerInterface) pif_list;
 
+    /* MAC sequence sync, local history sent to peer */
+    uint32_t mac_epoch;
+    uint32_t mac_seq;
+    uint8_t mac_seq_mark;           /* MAC_SEQ_MARK owed to peer */
+    struct MACTombstone* mac_tombstones;
+    uint32_t mac_tombstone_num;
+    uint8_t mac_tombstone_overflow;
+
+    /* MAC sequence sync, peer history applied locally */
+    uint8_t peer_mac_seq_support;
+    uint32_t peer_ack_epoch;        /* local history as last applied by peer */
+    uint32_t peer_ack_seq;
+    uint32_t peer_mac_epoch;
+    uint32_t peer_mac_seq;
+    struct mLACPMACData* peer_mac_replay;   /* peer MACs held at session down */
+    uint32_t peer_mac_replay_num;
+
     /* ICCP message tx/rx debug counters */
     mlacp_dbg_counter_info_t  dbg_counters;
 };
@@ -188,6 +232,7 @@ void mlacp_fsm_transit(struct CSM* csm);
 void mlacp_enqueue_msg(struct CSM*, struct Msg*);
 struct Msg* mlacp_dequeue_msg(struct CSM*);
 char* mlacp_state(struct CSM* csm);
+void mlacp_mac_msg_free(struct CSM* csm, struct MACMsg* mac_msg);
 
 /* from app_csm*/
 extern int mlacp_bind_local_if(struct CSM* csm, struct LocalInterface* local_if);
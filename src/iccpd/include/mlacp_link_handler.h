@@ -53,6 +53,7 @@ void peerlink_port_isolate_cleanup(struct CSM* csm);
 void update_peerlink_isolate_from_all_csm_lif(struct CSM* csm);
 
 ssize_t iccp_send_to_mclagsyncd(uint8_t msg_type, char *send_buff, uint16_t send_len);
+void iccp_flush_fdb_batch_to_syncd(void);
 
 void del_mac_from_chip(struct MACMsg* mac_msg);
 void add_mac_to_chip(struct MACMsg* mac_msg, uint8_t mac_type);
@@ -82,7 +83,7 @@ int mlacp_link_set_peerlink_port_isolation(int mlag_id, char *po_name, bool is_i
 void mlacp_mlag_intf_detach_handler(struct CSM* csm, struct LocalInterface* local_if);
 void mlacp_peer_mlag_intf_delete_handler(struct CSM* csm, char *mlag_if_name);
 
-int iccp_mclagsyncd_msg_handler(struct System *sys);
+int iccp_mclagsyncd_msg_handler(struct System *sys, struct iccp_event *ev);
 int syn_local_neigh_mac_info_to_peer(struct LocalInterface *local_if, int sync_add,
         int is_v4, int is_v6, int sync_mac, int ack, int is_ipv6_ll, int dir);
 int syn_local_mac_info_to_peer(struct CSM* csm, struct LocalInterface *local_if, int sync_add, int is_sag);
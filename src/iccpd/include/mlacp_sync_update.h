@@ -44,8 +44,17 @@ int mlacp_fsm_update_warmboot(struct CSM* csm, struct mLACPWarmbootTLV* tlv);
 
 void mlacp_enqueue_arp(struct CSM* csm, struct Msg* msg);
 void mlacp_enqueue_ndisc(struct CSM *csm, struct Msg *msg);
+struct Msg* mlacp_find_arp(struct CSM* csm, uint32_t ipv4_addr);
+void mlacp_dequeue_arp(struct CSM* csm, struct Msg* msg);
+struct Msg* mlacp_find_ndisc(struct CSM *csm, const uint8_t *ipv6_addr);
+void mlacp_dequeue_ndisc(struct CSM *csm, struct Msg *msg);
+void mlacp_enqueue_arp_msg(struct CSM* csm, struct Msg* msg);
+void mlacp_dequeue_arp_msg(struct CSM* csm, struct Msg* msg);
+void mlacp_enqueue_ndisc_msg(struct CSM *csm, struct Msg *msg);
+void mlacp_dequeue_ndisc_msg(struct CSM *csm, struct Msg *msg);
 int mlacp_fsm_update_Agg_conf(struct CSM* csm, mLACPAggConfigTLV* portconf);
 int mlacp_fsm_update_port_channel_info(struct CSM* csm, struct mLACPPortChannelInfoTLV* tlv);
 int mlacp_fsm_update_peerlink_info(struct CSM* csm, struct mLACPPeerLinkInfoTLV* tlv);
 int mlacp_fsm_update_mac_info_from_peer(struct CSM* csm, struct mLACPMACInfoTLV* tlv);
+int mlacp_fsm_update_mac_seq(struct CSM* csm, struct mLACPMACSeqTLV* tlv);
 #endif
@@ -469,6 +469,27 @@ struct mLACPIfUpAckTLV {
     uint16_t        if_id;                   /* LAG: agg_id */
 }__attribute__ ((packed));
 
+/*
+ * NOS: MAC sequence sync
+ * Each side numbers the MAC updates it sends. After a reconnect the peer
+ * reports how far it got, and only the MACs changed since are resent.
+ */
+enum MAC_SEQ_TYPE
+{
+    MAC_SEQ_ACK  = 1,   /* epoch/seq of the peer MAC history applied locally */
+    MAC_SEQ_FULL = 2,   /* full MAC sync follows */
+    MAC_SEQ_INCR = 3,   /* only MACs changed after seq follow */
+    MAC_SEQ_MARK = 4,   /* all MAC updates up to seq are sent */
+};
+
+struct mLACPMACSeqTLV
+{
+    ICCParameter    icc_parameter;
+    uint8_t         type;
+    uint32_t        epoch;
+    uint32_t        seq;
+} __attribute__ ((packed));
+
 enum NEIGH_OP_TYPE
 {
     NEIGH_SYNC_LIF = 0,
@@ -526,6 +547,12 @@ struct MACMsg
     uint8_t pending_local_del;
     uint8_t add_to_syncd;
 
+    /*What this MAC was last sent to peer as, and the mac_seq it was sent with*/
+    uint8_t  sent_op;
+    uint8_t  sent_fdb_type;
+    char     sent_ifname[MAX_L_PORT_NAME];
+    uint32_t seq;
+
     TAILQ_ENTRY(MACMsg) tail;     // entry into mac_msg_list
 };
 
@@ -167,12 +167,27 @@ struct LocalInterface
     LIST_ENTRY(LocalInterface) system_purge_next;
     LIST_ENTRY(LocalInterface) mlacp_next;
     LIST_ENTRY(LocalInterface) mlacp_purge_next;
+
+    /* Lookup indexes of sys->lif_list */
+    RB_ENTRY(LocalInterface) name_entry;
+    RB_ENTRY(LocalInterface) ifindex_entry;
+    RB_ENTRY(LocalInterface) po_id_entry;   /* Port channels only */
 };
 
+RB_HEAD(lif_name_rb_tree, LocalInterface);
+RB_PROTOTYPE(lif_name_rb_tree, LocalInterface, name_entry, lif_name_compare);
+
+RB_HEAD(lif_ifindex_rb_tree, LocalInterface);
+RB_PROTOTYPE(lif_ifindex_rb_tree, LocalInterface, ifindex_entry, lif_ifindex_compare);
+
+RB_HEAD(lif_po_id_rb_tree, LocalInterface);
+RB_PROTOTYPE(lif_po_id_rb_tree, LocalInterface, po_id_entry, lif_po_id_compare);
+
 struct LocalInterface* local_if_create(int ifindex, char* ifname, int type, uint8_t state);
 struct LocalInterface* local_if_find_by_name(const char* ifname);
 struct LocalInterface* local_if_find_by_ifindex(int ifindex);
 struct LocalInterface* local_if_find_by_po_id(int po_id);
+void local_if_set_ifindex(struct LocalInterface* lif, int ifindex);
 
 void local_if_destroy(char *ifname);
 void local_if_change_flag_clear(void);
@@ -41,7 +41,27 @@ struct System;
 #define CONNECT_TIMEOUT_MSEC        100
 #define HEARTBEAT_TIMEOUT_SEC       15
 #define TRANSIT_INTERVAL_SEC        1
-#define EPOLL_TIMEOUT_MSEC          100
+#define SCHEDULER_TIMER_MSEC        100
+/* Heartbeat, aging and the other timeouts of a settled session count seconds */
+#define SCHEDULER_IDLE_TIMER_MSEC   1000
+
+struct iccp_event;
+typedef int (*iccp_event_handler)(struct System* sys, struct iccp_event* ev);
+
+/* One epoll registration, epoll_event.data.ptr points back at it */
+struct iccp_event
+{
+    int fd;
+    iccp_event_handler handler;
+    void* owner;
+};
+
+#define ICCP_EVENT_INIT(ev) \
+    do { \
+        (ev)->fd = -1; \
+        (ev)->handler = NULL; \
+        (ev)->owner = NULL; \
+    } while (0)
 
 int scheduler_prepare_session(struct CSM*);
 int scheduler_check_csm_config(struct CSM*);
@@ -55,7 +75,10 @@ void scheduler_server_sock_init();
 int scheduler_csm_read_callback(struct CSM* csm);
 int iccp_get_server_sock_fd();
 int scheduler_server_accept();
-int iccp_receive_signal_handler(struct System* sys);
+int iccp_receive_signal_handler(struct System* sys, struct iccp_event* ev);
 void scheduler_csm_socket_cleanup(struct CSM* csm, int location);
+int scheduler_event_add(struct System* sys, struct iccp_event* ev, int fd,
+                        iccp_event_handler handler, void* owner);
+int scheduler_event_del(struct System* sys, struct iccp_event* ev);
 
 #endif /* SCHEDULER_H_ */
@@ -37,6 +37,7 @@
 #include <linux/netlink.h>
 
 #include "../include/port.h"
+#include "../include/scheduler.h"
 
 #define FRONT_PANEL_PORT_PREFIX "Ethernet"
 #define PORTCHANNEL_PREFIX      "PortChannel"
@@ -312,6 +313,18 @@ struct System
 
     int sig_pipe_r;
     int sig_pipe_w;
+
+    /* Events owned by the system, peer sockets live in their CSM */
+    struct iccp_event sync_event;
+    struct iccp_event sync_ctrl_event;
+    struct iccp_event sig_pipe_event;
+    struct iccp_event fsm_timer_event;
+    int fsm_timer_msec;
+    /* Batch being dispatched, so a removed event is not run afterwards */
+    struct epoll_event* epoll_events;
+    int epoll_nfds;
+    /* Set by every dispatched event, the FSM transit runs once per batch */
+    int fsm_pending;
     int warmboot_start;
     int warmboot_exit;
 
@@ -319,6 +332,9 @@ struct System
     LIST_HEAD(csm_list, CSM) csm_list;
     LIST_HEAD(lif_all_list, LocalInterface) lif_list;
     LIST_HEAD(lif_purge_all_list, LocalInterface) lif_purge_list;
+    struct lif_name_rb_tree lif_name_tree;
+    struct lif_ifindex_rb_tree lif_ifindex_tree;
+    struct lif_po_id_rb_tree lif_po_id_tree;
     LIST_HEAD(unq_ip_all_if_list, Unq_ip_If_info) unq_ip_if_list;
     LIST_HEAD(pending_vlan_mbr_if_list, PendingVlanMbrIf) pending_vlan_mbr_if_list;
 
@@ -329,8 +345,7 @@ struct System
     char* mclagdctl_file_path;
     int pid_file_fd;
     int telnet_port;
-    fd_set readfd; /*record socket need to listen*/
-    int readfd_count;
+    int event_count; /*registered epoll events*/
     time_t csm_trans_time;
     int need_sync_team_again;
     int need_sync_netlink_again;
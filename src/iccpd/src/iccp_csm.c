@@ -138,6 +138,7 @@ void iccp_csm_status_reset(struct CSM* csm, int all)
     }
 
     csm->sock_fd = -1;
+    ICCP_EVENT_INIT(&csm->sock_event);
     pthread_mutex_init(&csm->conn_mutex, NULL);
     csm->connTimePrev = 0;
     csm->heartbeat_send_time = 0;
@@ -277,17 +277,16 @@ static void do_arp_learn_from_kernel(struct ndmsg *ndm, struct rtattr *tb[], int
     }
 
     /* update lif ARP*/
-    TAILQ_FOREACH(msg, &MLACP(csm).arp_list, tail)
+    msg = mlacp_find_arp(csm, arp_msg->ipv4_addr);
+    if (msg)
     {
         arp_info = (struct ARPMsg *)msg->buf;
-        if (arp_info->ipv4_addr != arp_msg->ipv4_addr)
-            continue;
 
         entry_exists = 1;
         if (msgtype == RTM_DELNEIGH)
         {
             /* delete ARP*/
-            TAILQ_REMOVE(&MLACP(csm).arp_list, msg, tail);
+            mlacp_dequeue_arp(csm, msg);
             free(msg->buf);
             free(msg);
             msg = NULL;
@@ -307,7 +306,6 @@ static void do_arp_learn_from_kernel(struct ndmsg *ndm, struct rtattr *tb[], int
                 ICCPD_LOG_DEBUG(__FUNCTION__, "Update ARP for %s", show_ip_str(arp_msg->ipv4_addr));
             }
         }
-        break;
     }
 
     if (msg && !arp_update)
@@ -338,7 +336,7 @@ static void do_arp_learn_from_kernel(struct ndmsg *ndm, struct rtattr *tb[], int
             arp_msg->flag = 0;
             if (iccp_csm_init_msg(&msg_send, (char *)arp_msg, msg_len) == 0)
             {
-                TAILQ_INSERT_TAIL(&(MLACP(csm).arp_msg_list), msg_send, tail);
+                mlacp_enqueue_arp_msg(csm, msg_send);
                 /*ICCPD_LOG_DEBUG(__FUNCTION__, "Enqueue ARP[ADD] message for %s",
                                 show_ip_str(arp_msg->ipv4_addr));*/
             }
@@ -356,7 +354,7 @@ static void do_arp_learn_from_kernel(struct ndmsg *ndm, struct rtattr *tb[], int
             arp_msg->flag = 0;
             if (iccp_csm_init_msg(&msg_send, (char *)arp_msg, msg_len) == 0)
             {
-                TAILQ_INSERT_TAIL(&(MLACP(csm).arp_msg_list), msg_send, tail);
+                mlacp_enqueue_arp_msg(csm, msg_send);
                 /*ICCPD_LOG_DEBUG(__FUNCTION__, "Enqueue ARP[DEL] message for %s",
                                 show_ip_str(arp_msg->ipv4_addr));*/
             }
@@ -551,18 +549,16 @@ static void do_ndisc_learn_from_kernel(struct ndmsg *ndm, struct rtattr *tb[], i
     }
 
     /* update lif ND */
-    TAILQ_FOREACH(msg, &MLACP(csm).ndisc_list, tail)
+    msg = mlacp_find_ndisc(csm, (uint8_t *)ndisc_msg->ipv6_addr);
+    if (msg)
     {
         ndisc_info = (struct NDISCMsg *)msg->buf;
 
-        if (memcmp(&ndisc_info->ipv6_addr, &ndisc_msg->ipv6_addr, 16) != 0)
-            continue;
-
         entry_exists = 1;
         if (msgtype == RTM_DELNEIGH)
         {
             /* delete ND */
-            TAILQ_REMOVE(&MLACP(csm).ndisc_list, msg, tail);
+            mlacp_dequeue_ndisc(csm, msg);
             free(msg->buf);
             free(msg);
             msg = NULL;
@@ -581,7 +577,6 @@ static void do_ndisc_learn_from_kernel(struct ndmsg *ndm, struct rtattr *tb[], i
                 ICCPD_LOG_DEBUG(__FUNCTION__, "Update neighbor for %s", show_ipv6_str((char *)ndisc_msg->ipv6_addr));
             }
         }
-        break;
     }
 
     if (msg && !neigh_update)
@@ -611,7 +606,7 @@ static void do_ndisc_learn_from_kernel(struct ndmsg *ndm, struct rtattr *tb[], i
             ndisc_msg->flag = 0;
             if (iccp_csm_init_msg(&msg_send, (char *)ndisc_msg, msg_len) == 0)
             {
-                TAILQ_INSERT_TAIL(&(MLACP(csm).ndisc_msg_list), msg_send, tail);
+                mlacp_enqueue_ndisc_msg(csm, msg_send);
                 /* ICCPD_LOG_DEBUG(__FUNCTION__, "Enqueue Ndisc[ADD] for %s", show_ipv6_str((char *)ndisc_msg->ipv6_addr)); */
             }
             else
@@ -628,7 +623,7 @@ static void do_ndisc_learn_from_kernel(struct ndmsg *ndm, struct rtattr *tb[], i
             ndisc_msg->flag = 0;
             if (iccp_csm_init_msg(&msg_send, (char *)ndisc_msg, msg_len) == 0)
             {
-                TAILQ_INSERT_TAIL(&(MLACP(csm).ndisc_msg_list), msg_send, tail);
+                mlacp_enqueue_ndisc_msg(csm, msg_send);
                 /* ICCPD_LOG_DEBUG(__FUNCTION__, "Enqueue Ndisc[DEL] for %s", show_ipv6_str((char *)ndisc_msg->ipv6_addr)); */
             }
             else
@@ -960,11 +955,10 @@ void do_arp_update_from_reply_packet(unsigned int ifindex, unsigned int addr, ui
     }
 
     /* update lif ARP*/
-    TAILQ_FOREACH(msg, &MLACP(csm).arp_list, tail)
+    msg = mlacp_find_arp(csm, arp_msg->ipv4_addr);
+    if (msg)
     {
         arp_info = (struct ARPMsg*)msg->buf;
-        if (arp_info->ipv4_addr != arp_msg->ipv4_addr)
-            continue;
 
         /* update ARP*/
         if (arp_info->op_type != arp_msg->op_type
@@ -977,7 +971,6 @@ void do_arp_update_from_reply_packet(unsigned int ifindex, unsigned int addr, ui
             ICCPD_LOG_DEBUG(__FUNCTION__, "Update ARP for %s",
                             show_ip_str(arp_msg->ipv4_addr));
         }
-        break;
     }
 
     /* enquene lif_msg (add)*/
@@ -1003,7 +996,7 @@ void do_arp_update_from_reply_packet(unsigned int ifindex, unsigned int addr, ui
         arp_msg->flag = 0;
         if (iccp_csm_init_msg(&msg_send, (char*)arp_msg, msg_len) == 0)
         {
-            TAILQ_INSERT_TAIL(&(MLACP(csm).arp_msg_list), msg_send, tail);
+            mlacp_enqueue_arp_msg(csm, msg_send);
             /*ICCPD_LOG_DEBUG(__FUNCTION__, "Enqueue ARP[ADD] for %s",
                             show_ip_str(arp_msg->ipv4_addr));*/
         }
@@ -1182,13 +1175,11 @@ void do_ndisc_update_from_reply_packet(unsigned int ifindex, char *ipv6_addr, ui
     }
 
     /* update lif ND */
-    TAILQ_FOREACH(msg, &MLACP(csm).ndisc_list, tail)
+    msg = mlacp_find_ndisc(csm, (uint8_t *)ndisc_msg->ipv6_addr);
+    if (msg)
     {
         ndisc_info = (struct NDISCMsg *)msg->buf;
 
-        if (memcmp((char *)ndisc_info->ipv6_addr, (char *)ndisc_msg->ipv6_addr, 16) != 0)
-            continue;
-
         /* If MAC addr is NULL, use the old one */
         if (memcmp(mac_addr, null_mac, ETHER_ADDR_LEN) == 0)
         {
@@ -1206,7 +1197,6 @@ void do_ndisc_update_from_reply_packet(unsigned int ifindex, char *ipv6_addr, ui
             memcpy(ndisc_info->mac_addr, ndisc_msg->mac_addr, ETHER_ADDR_LEN);
              ICCPD_LOG_DEBUG(__FUNCTION__, "Update ND for %s", show_ipv6_str((char *)ndisc_msg->ipv6_addr));
         }
-        break;
     }
 
     /* enquene lif_msg (add) */
@@ -1247,7 +1237,7 @@ void do_ndisc_update_from_reply_packet(unsigned int ifindex, char *ipv6_addr, ui
         ndisc_msg->flag = 0;
         if (iccp_csm_init_msg(&msg_send, (char *)ndisc_msg, msg_len) == 0)
         {
-            TAILQ_INSERT_TAIL(&(MLACP(csm).ndisc_msg_list), msg_send, tail);
+            mlacp_enqueue_ndisc_msg(csm, msg_send);
             /* ICCPD_LOG_DEBUG(__FUNCTION__, "Enqueue ND[ADD] for %s", show_ipv6_str((char *)ndisc_msg->ipv6_addr)); */
         }
         else
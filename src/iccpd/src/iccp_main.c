@@ -144,7 +144,6 @@ static int iccpd_signal_init(struct System* sys)
     int err;
     sigset_t ss;
     struct sigaction sa = { 0 };
-    struct epoll_event event;
 
     err = pipe(fds);
     if (err)
@@ -181,17 +180,12 @@ static int iccpd_signal_init(struct System* sys)
         goto close_pipe;
     }
 
-    event.data.fd = fds[0];
-    event.events = EPOLLIN;
-    err = epoll_ctl(sys->epoll_fd, EPOLL_CTL_ADD, fds[0], &event);
+    err = scheduler_event_add(sys, &sys->sig_pipe_event, fds[0], iccp_receive_signal_handler, NULL);
     if (err)
     {
         goto close_pipe;
     }
 
-    FD_SET( fds[0], &(sys->readfd));
-    sys->readfd_count++;
-
     return 0;
 
  close_pipe:
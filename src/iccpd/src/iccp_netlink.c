@@ -500,6 +500,7 @@ void iccp_set_interface_ipadd_mac(struct LocalInterface *lif, char * mac_addr )
     msg_hdr->len += sub_msg->op_len;
 
     /*send msg*/
+    iccp_flush_fdb_batch_to_syncd();
     if (sys->sync_fd)
     {
         if (write(sys->sync_fd,msg_buf, msg_hdr->len) == -1)
@@ -957,7 +958,7 @@ void iccp_event_handler_obj_input_newlink(struct nl_object *obj, void *arg)
 
     if (lif && (lif->ifindex == -1) && (lif->type == IF_T_VLAN))
     {
-        lif->ifindex = ifindex;
+        local_if_set_ifindex(lif, ifindex);
         lif->state = (op_state == IF_OPER_UP) ? PORT_STATE_UP : PORT_STATE_DOWN;
 
         if (addr_type == AF_LLC)
@@ -1226,8 +1227,8 @@ int iccp_del_self_ip_from_neigh_table (struct LocalInterface *lif, int addr_fami
     struct System *sys = NULL;
     struct CSM *csm = NULL;
     struct Msg *msg = NULL;
-    struct ARPMsg *arp_msg = NULL, *arp_info = NULL;
-    struct NDISCMsg *ndisc_msg = NULL, *ndisc_info = NULL;
+    struct ARPMsg *arp_msg = NULL;
+    struct NDISCMsg *ndisc_msg = NULL;
     int err = 0;
 
     if (!(sys = system_get_instance()))
@@ -1239,18 +1240,11 @@ int iccp_del_self_ip_from_neigh_table (struct LocalInterface *lif, int addr_fami
 
         LIST_FOREACH(csm, &(sys->csm_list), next)
         {
-            TAILQ_FOREACH(msg, &MLACP(csm).arp_list, tail)
-            {
-                arp_info = (struct ARPMsg *)msg->buf;
-                if (arp_info->ipv4_addr == lif->ipv4_addr) {
-                    ICCPD_LOG_NOTICE(__FUNCTION__, " Delete ARP %s", show_ip_str(lif->ipv4_addr));
-                    break;
-                }
-            }
-
+            msg = mlacp_find_arp(csm, lif->ipv4_addr);
             if (msg)
             {
-                TAILQ_REMOVE(&(MLACP(csm).arp_list), msg, tail);
+                ICCPD_LOG_NOTICE(__FUNCTION__, " Delete ARP %s", show_ip_str(lif->ipv4_addr));
+                mlacp_dequeue_arp(csm, msg);
                 free(msg->buf);
                 free(msg);
                 msg = NULL;
@@ -1261,19 +1255,11 @@ int iccp_del_self_ip_from_neigh_table (struct LocalInterface *lif, int addr_fami
 
         LIST_FOREACH(csm, &(sys->csm_list), next)
         {
-            TAILQ_FOREACH(msg, &MLACP(csm).ndisc_list, tail)
-            {
-                ndisc_info = (struct NDISCMsg *)msg->buf;
-
-                if (memcmp(&ndisc_info->ipv6_addr, &lif->ipv6_addr, 16) == 0) {
-                    ICCPD_LOG_DEBUG(__FUNCTION__, " Delete neighbor %s", show_ipv6_str((char *)lif->ipv6_addr));
-                    break;
-                }
-            }
-
+            msg = mlacp_find_ndisc(csm, (uint8_t *)lif->ipv6_addr);
             if (msg)
             {
-                TAILQ_REMOVE(&MLACP(csm).ndisc_list, msg, tail);
+                ICCPD_LOG_DEBUG(__FUNCTION__, " Delete neighbor %s", show_ipv6_str((char *)lif->ipv6_addr));
+                mlacp_dequeue_ndisc(csm, msg);
                 free(msg->buf);
                 free(msg);
                 msg = NULL;
@@ -2113,6 +2099,16 @@ static const struct iccp_eventfd iccp_eventfds[] = {
 /* \cond HIDDEN_SYMBOLS */
 #define ICCP_EVENT_FDS_COUNT ARRAY_SIZE(iccp_eventfds)
 /* \endcond */
+
+static struct iccp_event iccp_eventfd_events[ICCP_EVENT_FDS_COUNT];
+
+static int iccp_eventfd_handler(struct System *sys, struct iccp_event *ev)
+{
+    const struct iccp_eventfd *eventfd = ev->owner;
+
+    return eventfd->event_handler(sys);
+}
+
 /*
    @return fd.
  *
@@ -2127,33 +2123,30 @@ int iccp_init_netlink_event_fd(struct System *sys)
 {
     int efd;
     int i;
-    struct epoll_event event;
     int err;
 
     efd = epoll_create1(0);
     if (efd == -1)
         return -errno;
 
+    sys->epoll_fd = efd;
+
     for (i = 0; i < ICCP_EVENT_FDS_COUNT; i++)
     {
         int fd = iccp_eventfds[i].get_fd(sys);
 
-        event.data.fd = fd;
-        event.events = EPOLLIN;
-        err = epoll_ctl(efd, EPOLL_CTL_ADD, fd, &event);
-        if (err == -1)
-        {
-            err = -errno;
+        err = scheduler_event_add(sys, &iccp_eventfd_events[i], fd,
+                                  iccp_eventfd_handler, (void *)&iccp_eventfds[i]);
+        if (err)
             goto close_efd;
-        }
     }
 
-    sys->epoll_fd = efd;
-
     return 0;
 
 close_efd:
     close(efd);
+    sys->epoll_fd = -1;
+    sys->event_count = 0;
 
     return err;
 }
@@ -2167,77 +2160,41 @@ close_efd:
 
 int iccp_handle_events(struct System * sys)
 {
-    struct epoll_event events[ICCP_EVENT_FDS_COUNT + sys->readfd_count];
-    struct CSM* csm = NULL;
+    int max_nfds = sys->event_count > 0 ? sys->event_count : 1;
+    struct epoll_event events[max_nfds];
+    struct iccp_event *ev;
+    int timeout;
     int nfds;
-    int n;
     int i;
     int err;
-    int max_nfds;
-    struct mLACPHeartbeatTLV dummy_tlv;
 
-    max_nfds = ICCP_EVENT_FDS_COUNT + sys->readfd_count;
+    /* Periodic FSM work runs off the FSM timer, poll for it if there is none */
+    timeout = (sys->fsm_timer_event.fd >= 0) ? -1 : SCHEDULER_TIMER_MSEC;
 
-    nfds = epoll_wait(sys->epoll_fd, events, max_nfds, EPOLL_TIMEOUT_MSEC);
+    nfds = epoll_wait(sys->epoll_fd, events, max_nfds, timeout);
 
-    /* Go over list of event fds and handle them sequentially */
-    for (i = 0; i < nfds; i++)
-    {
-        for (n = 0; n < ICCP_EVENT_FDS_COUNT; n++)
-        {
-            const struct iccp_eventfd *eventfd = &iccp_eventfds[n];
-            if (events[i].data.fd == eventfd->get_fd(sys))
-            {
-                err = eventfd->event_handler(sys);
-                if (err)
-                    ICCPD_LOG_INFO(__FUNCTION__, "Scheduler fd %d handler error %d !", events[i].data.fd, err );
-                break;
-            }
-        }
+    if (timeout >= 0)
+        sys->fsm_pending = 1;
 
-        if (n < ICCP_EVENT_FDS_COUNT)
-            continue;
-
-        if (events[i].data.fd == sys->sync_ctrl_fd)
-        {
-            int client_fd = mclagd_ctl_sock_accept(sys->sync_ctrl_fd);
-            if (client_fd > 0)
-            {
-                mclagd_ctl_interactive_process(client_fd);
-                close(client_fd);
-            }
-            continue;
-        }
+    /* Each event points at its owner, no lookup is needed to dispatch it */
+    sys->epoll_events = events;
+    sys->epoll_nfds = nfds > 0 ? nfds : 0;
+    for (i = 0; i < sys->epoll_nfds; i++)
+    {
+        ev = events[i].data.ptr;
 
-        if (events[i].data.fd == sys->sync_fd)
-        {
-            iccp_mclagsyncd_msg_handler(sys);
+        /* Removed by an earlier handler of this batch */
+        if (ev == NULL)
             continue;
-        }
 
-        if (events[i].data.fd == sys->sig_pipe_r)
-        {
-            iccp_receive_signal_handler(sys);
+        err = ev->handler(sys, ev);
+        if (err)
+            ICCPD_LOG_INFO(__FUNCTION__, "Scheduler fd %d handler error %d !", ev->fd, err);
 
-            continue;
-        }
-
-        if (FD_ISSET(events[i].data.fd, &sys->readfd))
-        {
-            LIST_FOREACH(csm, &(sys->csm_list), next)
-            {
-                if (csm->sock_fd == events[i].data.fd )
-                {
-                    if (scheduler_csm_read_callback(csm) != MCLAG_ERROR)
-                    {
-                        //consider any msg from peer as heartbeat update, this will be in scenarios of scaled msg sync b/w peers
-                        mlacp_fsm_update_heartbeat(csm, &dummy_tlv);
-                    }
-                    break;
-                }
-            }
-        }
+        sys->fsm_pending = 1;
     }
+    sys->epoll_events = NULL;
+    sys->epoll_nfds = 0;
 
     return 0;
 }
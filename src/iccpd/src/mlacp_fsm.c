@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <unistd.h>
 
 #include <sys/queue.h>
 
@@ -61,14 +62,14 @@
         TAILQ_INIT(&(list)); \
     }
 
-#define MLACP_MAC_MSG_QUEUE_REINIT(list) \
+#define MLACP_MAC_MSG_QUEUE_REINIT(csm, list) \
     { \
         struct MACMsg* mac_msg = NULL; \
         while (!TAILQ_EMPTY(&(list))) { \
             mac_msg = TAILQ_FIRST(&(list)); \
             TAILQ_REMOVE(&(list), mac_msg, tail); \
             if (mac_msg->op_type == MAC_SYNC_DEL) \
-                free(mac_msg); \
+                mlacp_mac_msg_free(csm, mac_msg); \
         } \
         TAILQ_INIT(&(list)); \
     }
@@ -134,6 +135,62 @@ static int MACMsg_compare(const struct MACMsg *mac1, const struct MACMsg *mac2)
 
 RB_GENERATE(mac_rb_tree, MACMsg, mac_entry_rb, MACMsg_compare);
 
+static int ARPMsg_compare(const struct Msg *msg1, const struct Msg *msg2)
+{
+    const struct ARPMsg *arp1 = (const struct ARPMsg *)msg1->buf;
+    const struct ARPMsg *arp2 = (const struct ARPMsg *)msg2->buf;
+
+    if (arp1->ipv4_addr < arp2->ipv4_addr)
+        return -1;
+
+    if (arp1->ipv4_addr > arp2->ipv4_addr)
+        return 1;
+
+    return 0;
+}
+
+RB_GENERATE(arp_rb_tree, Msg, neigh_entry_rb, ARPMsg_compare);
+
+static int NDISCMsg_compare(const struct Msg *msg1, const struct Msg *msg2)
+{
+    const struct NDISCMsg *ndisc1 = (const struct NDISCMsg *)msg1->buf;
+    const struct NDISCMsg *ndisc2 = (const struct NDISCMsg *)msg2->buf;
+
+    return memcmp(ndisc1->ipv6_addr, ndisc2->ipv6_addr, 16);
+}
+
+RB_GENERATE(ndisc_rb_tree, Msg, neigh_entry_rb, NDISCMsg_compare);
+
+/* Messages queued for the same IP are kept apart by their address */
+static int Msg_addr_compare(const struct Msg *msg1, const struct Msg *msg2)
+{
+    if ((uintptr_t)msg1 < (uintptr_t)msg2)
+        return -1;
+
+    if ((uintptr_t)msg1 > (uintptr_t)msg2)
+        return 1;
+
+    return 0;
+}
+
+static int ARPMsg_queue_compare(const struct Msg *msg1, const struct Msg *msg2)
+{
+    int ret = ARPMsg_compare(msg1, msg2);
+
+    return ret ? ret : Msg_addr_compare(msg1, msg2);
+}
+
+RB_GENERATE(arp_msg_rb_tree, Msg, neigh_entry_rb, ARPMsg_queue_compare);
+
+static int NDISCMsg_queue_compare(const struct Msg *msg1, const struct Msg *msg2)
+{
+    int ret = NDISCMsg_compare(msg1, msg2);
+
+    return ret ? ret : Msg_addr_compare(msg1, msg2);
+}
+
+RB_GENERATE(ndisc_msg_rb_tree, Msg, neigh_entry_rb, NDISCMsg_queue_compare);
+
 #define WARM_REBOOT_TIMEOUT 90
 #define PEER_REBOOT_TIMEOUT 300
 
@@ -151,6 +208,7 @@ static void mlacp_sync_send_aggState(struct CSM* csm);
 static void mlacp_sync_send_syncArpInfo(struct CSM* csm);
 static void mlacp_sync_send_syncNdiscInfo(struct CSM *csm);
 static void mlacp_sync_send_heartbeat(struct CSM* csm);
+static void mlacp_sync_send_macSeq(struct CSM* csm, uint8_t type, uint32_t epoch, uint32_t seq);
 static void mlacp_sync_send_syncDoneData(struct CSM* csm);
 /* Sync Reciever APIs*/
 static void mlacp_sync_recv_sysConf(struct CSM* csm, struct Msg* msg);
@@ -275,6 +333,13 @@ static void mlacp_sync_send_syncMacInfo(struct CSM* csm)
         msg_len = mlacp_prepare_for_mac_info_to_peer(csm, g_csm_buf, CSM_BUFFER_SIZE, mac_msg, count);
         count++;
 
+        /*Remember what the peer was told, see mlacp_sync_mac()*/
+        mac_msg->seq = ++MLACP(csm).mac_seq;
+        mac_msg->sent_op = mac_msg->op_type;
+        mac_msg->sent_fdb_type = mac_msg->fdb_type;
+        memcpy(mac_msg->sent_ifname, mac_msg->origin_ifname, MAX_L_PORT_NAME);
+        MLACP(csm).mac_seq_mark = 1;
+
         //free mac_msg if marked for delete.
         if (mac_msg->op_type == MAC_SYNC_DEL)
         {
@@ -285,7 +350,7 @@ static void mlacp_sync_send_syncMacInfo(struct CSM* csm)
                 mac_find.vid = mac_msg->vid ;
                 memcpy(mac_find.mac_addr, mac_msg->mac_addr, ETHER_ADDR_LEN);
                 if (!RB_FIND(mac_rb_tree, &MLACP(csm).mac_rb ,&mac_find))
-                    free(mac_msg);
+                    mlacp_mac_msg_free(csm, mac_msg);
             }
         }
 
@@ -301,6 +366,13 @@ static void mlacp_sync_send_syncMacInfo(struct CSM* csm)
     if (count)
         iccp_csm_send(csm, g_csm_buf, msg_len);
 
+    /*Everything up to mac_seq is out, let peer move its watermark*/
+    if (MLACP(csm).peer_mac_seq_support && MLACP(csm).mac_seq_mark)
+    {
+        mlacp_sync_send_macSeq(csm, MAC_SEQ_MARK, MLACP(csm).mac_epoch, MLACP(csm).mac_seq);
+        MLACP(csm).mac_seq_mark = 0;
+    }
+
     return;
 }
 
@@ -315,7 +387,7 @@ static void mlacp_sync_send_syncArpInfo(struct CSM* csm)
     while (!TAILQ_EMPTY(&(MLACP(csm).arp_msg_list)))
     {
         msg = TAILQ_FIRST(&(MLACP(csm).arp_msg_list));
-        TAILQ_REMOVE(&(MLACP(csm).arp_msg_list), msg, tail);
+        mlacp_dequeue_arp_msg(csm, msg);
 
         msg_len = mlacp_prepare_for_arp_info(csm, g_csm_buf, CSM_BUFFER_SIZE, (struct ARPMsg*)msg->buf, count, NEIGH_SYNC_CLIENT_IP);
         count++;
@@ -347,7 +419,7 @@ static void mlacp_sync_send_syncNdiscInfo(struct CSM *csm)
     while (!TAILQ_EMPTY(&(MLACP(csm).ndisc_msg_list)))
     {
         msg = TAILQ_FIRST(&(MLACP(csm).ndisc_msg_list));
-        TAILQ_REMOVE(&(MLACP(csm).ndisc_msg_list), msg, tail);
+        mlacp_dequeue_ndisc_msg(csm, msg);
 
         msg_len = mlacp_prepare_for_ndisc_info(csm, g_csm_buf, CSM_BUFFER_SIZE, (struct NDISCMsg *)msg->buf, count, NEIGH_SYNC_CLIENT_IP);
         count++;
@@ -426,6 +498,17 @@ static void mlacp_sync_send_heartbeat(struct CSM* csm)
     return;
 }
 
+static void mlacp_sync_send_macSeq(struct CSM* csm, uint8_t type, uint32_t epoch, uint32_t seq)
+{
+    int msg_len = 0;
+
+    memset(g_csm_buf, 0, CSM_BUFFER_SIZE);
+    msg_len = mlacp_prepare_for_mac_seq(csm, g_csm_buf, CSM_BUFFER_SIZE, type, epoch, seq);
+    iccp_csm_send(csm, g_csm_buf, msg_len);
+
+    return;
+}
+
 static void mlacp_sync_send_syncDoneData(struct CSM* csm)
 {
     int msg_len = 0;
@@ -744,6 +827,22 @@ static void mlacp_sync_recv_heartbeat(struct CSM* csm, struct Msg* msg)
     return;
 }
 
+static void mlacp_sync_recv_macSeq(struct CSM* csm, struct Msg* msg)
+{
+    struct mLACPMACSeqTLV *tlv = NULL;
+
+    if (msg->len < sizeof(ICCHdr) + sizeof(struct mLACPMACSeqTLV))
+    {
+        ICCPD_LOG_WARN(__FUNCTION__, "Received MAC seq TLV too short: %zu", msg->len);
+        return;
+    }
+
+    tlv = (struct mLACPMACSeqTLV *)(&msg->buf[sizeof(ICCHdr)]);
+    mlacp_fsm_update_mac_seq(csm, tlv);
+
+    return;
+}
+
 static void mlacp_sync_recv_warmboot(struct CSM* csm, struct Msg* msg)
 {
     struct mLACPWarmbootTLV *tlv = NULL;
@@ -826,12 +925,72 @@ void mlacp_peer_link_learning_handler(struct CSM* csm)
     }
 }
 
+/* Start a new local MAC history, peer can no longer resync against the old one */
+static void mlacp_mac_seq_reset(struct CSM* csm)
+{
+    static uint32_t reset_count = 0;
+    uint32_t epoch;
+
+    epoch = ((uint32_t)time(NULL) ^ ((uint32_t)getpid() << 16)) + (++reset_count);
+    if (epoch == 0 || epoch == MLACP(csm).mac_epoch)
+        epoch = MLACP(csm).mac_epoch + 1;
+
+    MLACP(csm).mac_epoch = epoch;
+    MLACP(csm).mac_seq = 0;
+    MLACP(csm).mac_seq_mark = 0;
+    MLACP(csm).mac_tombstone_num = 0;
+    MLACP(csm).mac_tombstone_overflow = 0;
+    if (MLACP(csm).mac_tombstones)
+    {
+        free(MLACP(csm).mac_tombstones);
+        MLACP(csm).mac_tombstones = NULL;
+    }
+
+    MLACP(csm).peer_mac_epoch = 0;
+    MLACP(csm).peer_mac_seq = 0;
+    MLACP(csm).peer_mac_replay_num = 0;
+    if (MLACP(csm).peer_mac_replay)
+    {
+        free(MLACP(csm).peer_mac_replay);
+        MLACP(csm).peer_mac_replay = NULL;
+    }
+    return;
+}
+
+/* Free a MAC entry, remembering it if the peer still holds it as added */
+void mlacp_mac_msg_free(struct CSM* csm, struct MACMsg* mac_msg)
+{
+    struct MACTombstone* tomb = NULL;
+
+    if (mac_msg->sent_op == MAC_SYNC_ADD)
+    {
+        if (!MLACP(csm).mac_tombstones)
+            MLACP(csm).mac_tombstones = (struct MACTombstone*)malloc(sizeof(struct MACTombstone) * MAC_TOMBSTONE_MAX);
+
+        if (MLACP(csm).mac_tombstones && MLACP(csm).mac_tombstone_num < MAC_TOMBSTONE_MAX)
+        {
+            tomb = &MLACP(csm).mac_tombstones[MLACP(csm).mac_tombstone_num++];
+            tomb->vid = mac_msg->vid;
+            memcpy(tomb->mac_addr, mac_msg->mac_addr, ETHER_ADDR_LEN);
+            tomb->seq = 0;
+        }
+        else
+        {
+            /*Next reconnect has to fall back to full MAC sync*/
+            MLACP(csm).mac_tombstone_overflow = 1;
+        }
+    }
+
+    free(mac_msg);
+    return;
+}
+
 void mlacp_mac_msg_queue_reinit(struct CSM* csm)
 {
 
     struct MACMsg* mac_msg = NULL;
 
-    MLACP_MAC_MSG_QUEUE_REINIT(MLACP(csm).mac_msg_list);
+    MLACP_MAC_MSG_QUEUE_REINIT(csm, MLACP(csm).mac_msg_list);
 
     ICCPD_LOG_NOTICE("ICCP_FDB", "mlacp_mac_msg_queue_reinit clear mac_msg_list pointers in existing MAC entries");
 
@@ -864,18 +1023,25 @@ void mlacp_init(struct CSM* csm, int all)
 
     MLACP_MSG_QUEUE_REINIT(MLACP(csm).mlacp_msg_list);
     MLACP_MSG_QUEUE_REINIT(MLACP(csm).arp_msg_list);
+    RB_INIT(arp_msg_rb_tree, &MLACP(csm).arp_msg_rb);
     MLACP_MSG_QUEUE_REINIT(MLACP(csm).ndisc_msg_list);
+    RB_INIT(ndisc_msg_rb_tree, &MLACP(csm).ndisc_msg_rb);
     mlacp_mac_msg_queue_reinit(csm);
 
     PIF_QUEUE_REINIT(MLACP(csm).pif_list);
     LIF_PURGE_QUEUE_REINIT(MLACP(csm).lif_purge_list);
 
+    MLACP(csm).peer_mac_seq_support = 0;
+
     if (all != 0)
     {
         /* if no clean all, keep the arp info & local interface info for next connection*/
         MLACP_MSG_QUEUE_REINIT(MLACP(csm).arp_list);
+        RB_INIT(arp_rb_tree, &MLACP(csm).arp_rb);
         MLACP_MSG_QUEUE_REINIT(MLACP(csm).ndisc_list);
+        RB_INIT(ndisc_rb_tree, &MLACP(csm).ndisc_rb);
         RB_INIT(mac_rb_tree, &MLACP(csm).mac_rb );
+        mlacp_mac_seq_reset(csm);
         LIF_QUEUE_REINIT(MLACP(csm).lif_list);
 
         MLACP(csm).node_id = MLACP_SYSCONF_NODEID_MSB_MASK;
@@ -898,12 +1064,17 @@ void mlacp_finalize(struct CSM* csm)
     /* msg destroy*/
     MLACP_MSG_QUEUE_REINIT(MLACP(csm).mlacp_msg_list);
     MLACP_MSG_QUEUE_REINIT(MLACP(csm).arp_msg_list);
+    RB_INIT(arp_msg_rb_tree, &MLACP(csm).arp_msg_rb);
     MLACP_MSG_QUEUE_REINIT(MLACP(csm).ndisc_msg_list);
+    RB_INIT(ndisc_msg_rb_tree, &MLACP(csm).ndisc_msg_rb);
     mlacp_mac_msg_queue_reinit(csm);
     MLACP_MSG_QUEUE_REINIT(MLACP(csm).arp_list);
+    RB_INIT(arp_rb_tree, &MLACP(csm).arp_rb);
     MLACP_MSG_QUEUE_REINIT(MLACP(csm).ndisc_list);
+    RB_INIT(ndisc_rb_tree, &MLACP(csm).ndisc_rb);
 
     RB_INIT(mac_rb_tree, &MLACP(csm).mac_rb );
+    mlacp_mac_seq_reset(csm);
 
     /* remove lif & lif-purge queue */
     LIF_QUEUE_REINIT(MLACP(csm).lif_list);
@@ -940,8 +1111,11 @@ void mlacp_fsm_transit(struct CSM* csm)
         {
             MLACP_MSG_QUEUE_REINIT(MLACP(csm).mlacp_msg_list);
             MLACP_MSG_QUEUE_REINIT(MLACP(csm).arp_msg_list);
+            RB_INIT(arp_msg_rb_tree, &MLACP(csm).arp_msg_rb);
             MLACP_MSG_QUEUE_REINIT(MLACP(csm).ndisc_msg_list);
+            RB_INIT(ndisc_msg_rb_tree, &MLACP(csm).ndisc_msg_rb);
             mlacp_mac_msg_queue_reinit(csm);
+            MLACP(csm).peer_mac_seq_support = 0;
             MLACP(csm).current_state = MLACP_STATE_INIT;
             if (csm->sock_fd > 0)
             {
@@ -1099,9 +1273,105 @@ struct Msg* mlacp_dequeue_msg(struct CSM* csm)
     return msg;
 }
 
+/* Withdraw MACs freed since the peer watermark, they are not in mac_rb anymore */
+static void mlacp_sync_mac_tombstones(struct CSM* csm)
+{
+    struct MACTombstone* tomb = NULL;
+    struct MACMsg mac_find;
+    int msg_len = 0;
+    int count = 0;
+    uint32_t i, num = 0;
+
+    memset(g_csm_buf, 0, CSM_BUFFER_SIZE);
+    memset(&mac_find, 0, sizeof(struct MACMsg));
+    mac_find.op_type = MAC_SYNC_DEL;
+
+    for (i = 0; i < MLACP(csm).mac_tombstone_num; i++)
+    {
+        tomb = &MLACP(csm).mac_tombstones[i];
+
+        /*DEL already acknowledged by peer*/
+        if (tomb->seq != 0 && tomb->seq <= MLACP(csm).peer_ack_seq)
+            continue;
+
+        mac_find.vid = tomb->vid;
+        memcpy(mac_find.mac_addr, tomb->mac_addr, ETHER_ADDR_LEN);
+
+        /*MAC learnt again, the walk over mac_rb takes care of it*/
+        if (RB_FIND(mac_rb_tree, &MLACP(csm).mac_rb, &mac_find))
+            continue;
+
+        msg_len = mlacp_prepare_for_mac_info_to_peer(csm, g_csm_buf, CSM_BUFFER_SIZE, &mac_find, count);
+        count++;
+        tomb->seq = ++MLACP(csm).mac_seq;
+        MLACP(csm).mac_seq_mark = 1;
+        MLACP(csm).mac_tombstones[num++] = *tomb;
+
+        if (count >= MAX_MAC_ENTRY_NUM)
+        {
+            iccp_csm_send(csm, g_csm_buf, msg_len);
+            count = 0;
+            memset(g_csm_buf, 0, CSM_BUFFER_SIZE);
+        }
+    }
+
+    if (count)
+        iccp_csm_send(csm, g_csm_buf, msg_len);
+
+    MLACP(csm).mac_tombstone_num = num;
+    return;
+}
+
+/*
+ * Peer reconnected. If it reported having applied our MAC history up to
+ * some seq of the current epoch, only send what changed after it: MACs
+ * sent later, MACs whose state changed while disconnected, and freed MACs
+ * the peer still holds. Otherwise sync the whole table as before.
+ */
 void mlacp_sync_mac(struct CSM* csm)
 {
     struct MACMsg* mac_msg = NULL;
+    uint8_t incremental = 0;
+    uint32_t ack_seq = MLACP(csm).peer_ack_seq;
+
+    if (MLACP(csm).peer_mac_seq_support)
+    {
+        if (MLACP(csm).peer_ack_epoch == MLACP(csm).mac_epoch
+            && ack_seq <= MLACP(csm).mac_seq
+            && !MLACP(csm).mac_tombstone_overflow)
+            incremental = 1;
+
+        ICCPD_LOG_NOTICE("ICCP_FDB", "Sync MAC: %s, epoch %u seq %u, peer acked epoch %u seq %u",
+            incremental ? "incremental" : "full", MLACP(csm).mac_epoch, MLACP(csm).mac_seq,
+            MLACP(csm).peer_ack_epoch, ack_seq);
+
+        mlacp_sync_send_macSeq(csm, incremental ? MAC_SEQ_INCR : MAC_SEQ_FULL, MLACP(csm).mac_epoch, ack_seq);
+        MLACP(csm).mac_seq_mark = 1;
+    }
+    else
+    {
+        /*Peer without MAC seq support does not tell us what it kept*/
+        MLACP(csm).peer_mac_epoch = 0;
+        MLACP(csm).peer_mac_seq = 0;
+        MLACP(csm).peer_mac_replay_num = 0;
+        if (MLACP(csm).peer_mac_replay)
+        {
+            free(MLACP(csm).peer_mac_replay);
+            MLACP(csm).peer_mac_replay = NULL;
+        }
+    }
+
+    if (incremental)
+    {
+        mlacp_sync_mac_tombstones(csm);
+    }
+    else
+    {
+        /*Full sync replaces the whole peer view*/
+        MLACP(csm).mac_tombstone_num = 0;
+        MLACP(csm).mac_tombstone_overflow = 0;
+    }
+
     RB_FOREACH (mac_msg, mac_rb_tree, &MLACP(csm).mac_rb)
     {
         /*If MAC with local age flag, dont sync to peer. Such MAC only exist when peer is warm-reboot.
@@ -1110,6 +1380,12 @@ void mlacp_sync_mac(struct CSM* csm)
           After warm-reboot, this MAC must be learnt by peer and sync to local switch*/
         if (!(mac_msg->age_flag & MAC_AGE_LOCAL))
         {
+            /*Peer already has this MAC as it is now*/
+            if (incremental && mac_msg->sent_op == MAC_SYNC_ADD && mac_msg->seq <= ack_seq
+                && mac_msg->sent_fdb_type == mac_msg->fdb_type
+                && strcmp(mac_msg->sent_ifname, mac_msg->origin_ifname) == 0)
+                continue;
+
             mac_msg->op_type = MAC_SYNC_ADD;
             //As part of local sync do not delete peer age
             //mac_msg->age_flag &= ~MAC_AGE_PEER;
@@ -1125,6 +1401,22 @@ void mlacp_sync_mac(struct CSM* csm)
         }
         else
         {
+            if (incremental && (mac_msg->sent_op == MAC_SYNC_ADD
+                || (mac_msg->sent_op == MAC_SYNC_DEL && mac_msg->seq > ack_seq)))
+            {
+                /*Peer restores the MAC it had from us, withdraw it*/
+                mac_msg->op_type = MAC_SYNC_DEL;
+                if (!MAC_IN_MSG_LIST(&(MLACP(csm).mac_msg_list), mac_msg, tail))
+                {
+                    TAILQ_INSERT_TAIL(&(MLACP(csm).mac_msg_list), mac_msg, tail);
+                }
+            }
+            else if (!incremental && mac_msg->sent_op == MAC_SYNC_ADD)
+            {
+                /*Not part of the full sync, so not held by peer either*/
+                mac_msg->sent_op = MAC_SYNC_DEL;
+            }
+
             /*If MAC with local age flag and is point to MCLAG enabled port, reomove local age flag*/
             if (strcmp(mac_msg->ifname, csm->peer_itf_name) != 0)
             {
@@ -1162,7 +1454,7 @@ void mlacp_local_lif_clear_pending_mac(struct CSM* csm, struct LocalInterface *l
                 mac_msg->op_type = MAC_SYNC_DEL;
                 if (!MAC_IN_MSG_LIST(&(MLACP(csm).mac_msg_list), mac_msg, tail))
                 {
-                    free(mac_msg);
+                    mlacp_mac_msg_free(csm, mac_msg);
                 }
             }
             else
@@ -1192,7 +1484,7 @@ static void mlacp_resync_arp(struct CSM* csm)
             arp_msg->flag = 0;
             if (iccp_csm_init_msg(&msg_send, (char*)arp_msg, sizeof(struct ARPMsg)) == 0)
             {
-                TAILQ_INSERT_TAIL(&(MLACP(csm).arp_msg_list), msg_send, tail);
+                mlacp_enqueue_arp_msg(csm, msg_send);
             }
         }
     }
@@ -1218,7 +1510,7 @@ static void mlacp_resync_ndisc(struct CSM *csm)
             ndisc_msg->flag = 0;
             if (iccp_csm_init_msg(&msg_send, (char *)ndisc_msg, sizeof(struct NDISCMsg)) == 0)
             {
-                TAILQ_INSERT_TAIL(&(MLACP(csm).ndisc_msg_list), msg_send, tail);
+                mlacp_enqueue_ndisc_msg(csm, msg_send);
             }
         }
     }
@@ -1375,6 +1667,10 @@ static void mlacp_sync_receiver_handler(struct CSM* csm, struct Msg* msg)
             mlacp_fsm_recv_if_up_ack(csm, msg);
             break;
 
+        case TLV_T_MLACP_MAC_SEQ:
+            mlacp_sync_recv_macSeq(csm, msg);
+            break;
+
         default:
             ICCPD_LOG_ERR("ICCP_FSM", "Receive unsupported msg 0x%x from peer",
                 icc_param->type);
@@ -1424,6 +1720,11 @@ static void mlacp_sync_sender_handler(struct CSM* csm)
             mlacp_sync_send_syncNdiscInfo(csm);
             break;
 
+        case MLACP_SYNC_MAC_SEQ:
+            /*Tell peer how much of its MAC history is already applied*/
+            mlacp_sync_send_macSeq(csm, MAC_SEQ_ACK, MLACP(csm).peer_mac_epoch, MLACP(csm).peer_mac_seq);
+            break;
+
         case MLACP_SYNC_DONE:
             mlacp_sync_send_syncDoneData(csm);
             break;
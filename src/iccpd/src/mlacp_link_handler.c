@@ -44,6 +44,7 @@
 #include "../include/iccp_cmd.h"
 #include "../include/mlacp_link_handler.h"
 #include "../include/mlacp_sync_prepare.h"
+#include "../include/mlacp_sync_update.h"
 #include "../include/iccp_netlink.h"
 #include "../include/scheduler.h"
 #include "../include/iccp_ifm.h"
@@ -68,6 +69,17 @@ char g_ipv6_str[INET6_ADDRSTRLEN];
 char g_iccp_mlagsyncd_recv_buf[ICCP_MLAGSYNCD_RECV_MSG_BUFFER_SIZE] = { 0 };
 char g_iccp_mlagsyncd_send_buf[ICCP_MLAGSYNCD_SEND_MSG_BUFFER_SIZE] = { 0 };
 
+/* FDB entries to mclagsyncd are batched into one MCLAG_MSG_TYPE_SET_FDB
+ * message, which mclagsyncd parses as a list of mclag_fdb_info. The batch is
+ * flushed when full, before any other message to mclagsyncd and at the end of
+ * each scheduler loop pass.
+ */
+#define ICCP_FDB_BATCH_MAX_ENTRIES \
+    ((MCLAG_MAX_MSG_LEN - sizeof(struct IccpSyncdHDr)) / sizeof(struct mclag_fdb_info))
+
+static char g_iccp_fdb_batch_buf[MCLAG_MAX_MSG_LEN] = { 0 };
+static uint16_t g_iccp_fdb_batch_count = 0;
+
 
 extern void mlacp_sync_mac(struct CSM* csm);
 
@@ -377,6 +389,10 @@ ssize_t iccp_send_to_mclagsyncd(uint8_t msg_type, char *send_buff, uint16_t msg_
         return MCLAG_ERROR;
     }
 
+    /* Keep queued FDB entries ahead of anything sent after them */
+    if (send_buff != g_iccp_fdb_batch_buf)
+        iccp_flush_fdb_batch_to_syncd();
+
     if (sys->sync_fd)
     {
         while (msg_len > 0)
@@ -505,6 +521,7 @@ void set_peerlink_mlag_port_learn(struct LocalInterface *lif, int enable)
                     sub_msg->op_type == MCLAG_SUB_OPTION_TYPE_MAC_LEARN_DISABLE ? "DISABLE":"ENABLE", lif->name);
 
     /*send msg*/
+    iccp_flush_fdb_batch_to_syncd();
     if (sys->sync_fd)
     {
         rc = write(sys->sync_fd,msg_buf, msg_hdr->len);
@@ -807,6 +824,7 @@ int mlacp_link_del_iccp_info(
     memcpy(sub_msg->data, &mlag_id, sub_msg->op_len);
     msg_hdr->len += (sizeof(mclag_sub_option_hdr_t) + sub_msg->op_len);
 
+    iccp_flush_fdb_batch_to_syncd();
     if (sys->sync_fd)
         rc = send(sys->sync_fd,msg_buf, msg_hdr->len, MSG_DONTWAIT);
 
@@ -1166,6 +1184,7 @@ void update_peerlink_isolate_from_all_csm_lif(
     }
 
     /*send msg*/
+    iccp_flush_fdb_batch_to_syncd();
     if (sys->sync_fd)
     {
         rc = write(sys->sync_fd,msg_buf, msg_hdr->len);
@@ -1481,7 +1500,7 @@ void syn_arp_info_to_peer(struct CSM *csm, struct LocalInterface *local_if)
 
             if (iccp_csm_init_msg(&msg_send, (char*)arp_msg, sizeof(struct ARPMsg)) == 0)
             {
-                TAILQ_INSERT_TAIL(&(MLACP(csm).arp_msg_list), msg_send, tail);
+                mlacp_enqueue_arp_msg(csm, msg_send);
                 /*ICCPD_LOG_DEBUG( __FUNCTION__, "Enqueue ARP[ADD] for %s",
                                  show_ip_str(htonl(arp_msg->ipv4_addr)));*/
             }
@@ -1518,7 +1537,7 @@ void syn_ndisc_info_to_peer(struct CSM *csm, struct LocalInterface *local_if)
 
             if (iccp_csm_init_msg(&msg_send, (char *)ndisc_msg, sizeof(struct NDISCMsg)) == 0)
             {
-                TAILQ_INSERT_TAIL(&(MLACP(csm).ndisc_msg_list), msg_send, tail);
+                mlacp_enqueue_ndisc_msg(csm, msg_send);
                 ICCPD_LOG_DEBUG(__FUNCTION__, "Enqueue ND[ADD] for %s", show_ipv6_str((char *)ndisc_msg->ipv6_addr));
             }
             else
@@ -1599,14 +1618,18 @@ void update_stp_peer_link(struct CSM *csm,
     return;
 }
 
-void iccp_send_fdb_entry_to_syncd( struct MACMsg* mac_msg, uint8_t mac_type, uint8_t oper)
+void iccp_flush_fdb_batch_to_syncd(void)
 {
     struct IccpSyncdHDr * msg_hdr;
-    char *msg_buf = g_iccp_mlagsyncd_send_buf;
     struct System *sys;
-    struct mclag_fdb_info * mac_info;
+    uint16_t count = g_iccp_fdb_batch_count;
     ssize_t rc;
-    uint8_t null_mac[] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+    if (count == 0)
+        return;
+
+    /* Empty the batch before sending, the send path flushes it too */
+    g_iccp_fdb_batch_count = 0;
 
     sys = system_get_instance();
     if (sys == NULL)
@@ -1615,38 +1638,20 @@ void iccp_send_fdb_entry_to_syncd( struct MACMsg* mac_msg, uint8_t mac_type, uin
         return;
     }
 
-    if (memcmp(mac_msg->mac_addr, null_mac, ETHER_ADDR_LEN) == 0)
-    {
-        ICCPD_LOG_ERR(__FUNCTION__, "Invalid MAC address do not send to Syncd.");
-        return;
-    }
-
-    memset(msg_buf, 0, ICCP_MLAGSYNCD_SEND_MSG_BUFFER_SIZE);
-
-    msg_hdr = (struct IccpSyncdHDr *)msg_buf;
+    msg_hdr = (struct IccpSyncdHDr *)g_iccp_fdb_batch_buf;
     msg_hdr->ver = ICCPD_TO_MCLAGSYNCD_HDR_VERSION;
     msg_hdr->type = MCLAG_MSG_TYPE_SET_FDB;
+    msg_hdr->len = sizeof(struct IccpSyncdHDr) + count * sizeof(struct mclag_fdb_info);
 
-    /*mac msg */
-    mac_info = (struct mclag_fdb_info *)&msg_buf[sizeof(struct IccpSyncdHDr)];
-    mac_info->vid = mac_msg->vid;
-    memcpy(mac_info->port_name, mac_msg->ifname, MAX_L_PORT_NAME);
-    memcpy(mac_info->mac, mac_msg->mac_addr, ETHER_ADDR_LEN);
-    mac_info->type = mac_type;
-    mac_info->op_type = oper;
-    msg_hdr->len = sizeof(struct IccpSyncdHDr) + sizeof(struct mclag_fdb_info);
-
-    ICCPD_LOG_DEBUG("ICCP_FDB", "Send fdb to syncd: write mac msg vid : %d ; ifname %s ; mac %s fdb type %d ; op type %s",
-        mac_info->vid, mac_info->port_name, mac_addr_to_str(mac_info->mac), mac_info->type,
-        oper == MAC_SYNC_ADD ? "add" : "del");
+    ICCPD_LOG_DEBUG("ICCP_FDB", "Send fdb to syncd: %u entries, len %u", count, msg_hdr->len);
 
     /*send msg*/
     if (sys->sync_fd > 0 )
     {
-        rc = iccp_send_to_mclagsyncd(msg_hdr->type, msg_buf, msg_hdr->len);
+        rc = iccp_send_to_mclagsyncd(msg_hdr->type, g_iccp_fdb_batch_buf, msg_hdr->len);
         if (rc <= 0)
         {
-            ICCPD_LOG_WARN(__FUNCTION__, "Send to Mclagsyncd failed rc: %d",rc);
+            ICCPD_LOG_WARN(__FUNCTION__, "Send to Mclagsyncd failed rc: %d, %u fdb entries dropped", rc, count);
         }
     }
     else
@@ -1655,6 +1660,45 @@ void iccp_send_fdb_entry_to_syncd( struct MACMsg* mac_msg, uint8_t mac_type, uin
         ICCPD_LOG_ERR(__FUNCTION__, "Invalid sync_fd Failed to write, fd %d", sys->sync_fd);
     }
 
+    return;
+}
+
+void iccp_send_fdb_entry_to_syncd( struct MACMsg* mac_msg, uint8_t mac_type, uint8_t oper)
+{
+    struct System *sys;
+    struct mclag_fdb_info * mac_info;
+    uint8_t null_mac[] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+    sys = system_get_instance();
+    if (sys == NULL)
+    {
+        ICCPD_LOG_ERR(__FUNCTION__, "Invalid system instance");
+        return;
+    }
+
+    if (memcmp(mac_msg->mac_addr, null_mac, ETHER_ADDR_LEN) == 0)
+    {
+        ICCPD_LOG_ERR(__FUNCTION__, "Invalid MAC address do not send to Syncd.");
+        return;
+    }
+
+    /*mac msg, queued behind the entries already in the batch */
+    mac_info = (struct mclag_fdb_info *)&g_iccp_fdb_batch_buf[sizeof(struct IccpSyncdHDr) +
+                                                             g_iccp_fdb_batch_count * sizeof(struct mclag_fdb_info)];
+    memset(mac_info, 0, sizeof(struct mclag_fdb_info));
+    mac_info->vid = mac_msg->vid;
+    memcpy(mac_info->port_name, mac_msg->ifname, MAX_L_PORT_NAME);
+    memcpy(mac_info->mac, mac_msg->mac_addr, ETHER_ADDR_LEN);
+    mac_info->type = mac_type;
+    mac_info->op_type = oper;
+
+    ICCPD_LOG_DEBUG("ICCP_FDB", "Queue fdb to syncd: write mac msg vid : %d ; ifname %s ; mac %s fdb type %d ; op type %s",
+        mac_info->vid, mac_info->port_name, mac_addr_to_str(mac_info->mac), mac_info->type,
+        oper == MAC_SYNC_ADD ? "add" : "del");
+
+    if (++g_iccp_fdb_batch_count >= ICCP_FDB_BATCH_MAX_ENTRIES)
+        iccp_flush_fdb_batch_to_syncd();
+
     if (oper == MAC_SYNC_DEL)
         mac_msg->add_to_syncd = 0;
     else
@@ -1819,7 +1863,7 @@ static void update_l2_mac_state(struct CSM *csm,
                 // else free is taken care after sending the update to peer
                 if (!MAC_IN_MSG_LIST(&(MLACP(csm).mac_msg_list), mac_msg, tail))
                 {
-                    free(mac_msg);
+                    mlacp_mac_msg_free(csm, mac_msg);
                 }
             }
             else
@@ -1908,7 +1952,7 @@ static void update_l2_mac_state(struct CSM *csm,
                         mac_msg->op_type = MAC_SYNC_DEL;
                         if (!MAC_IN_MSG_LIST(&(MLACP(csm).mac_msg_list), mac_msg, tail))
                         {
-                            free(mac_msg);
+                            mlacp_mac_msg_free(csm, mac_msg);
                         }
                     }
                     else
@@ -2288,10 +2332,62 @@ void mlacp_peer_conn_handler(struct CSM* csm)
     return;
 }
 
+/* Keep the MACs peer had added, to restore them if peer resyncs incrementally */
+static void mlacp_peer_disconn_save_mac(struct CSM* csm)
+{
+    struct MACMsg* mac_msg = NULL;
+    struct mLACPMACData* mac_data = NULL;
+    uint32_t num = 0;
+
+    /*Nothing to resync against, or already saved by an earlier session down*/
+    if (MLACP(csm).peer_mac_epoch == 0 || MLACP(csm).peer_mac_replay)
+        return;
+
+    RB_FOREACH (mac_msg, mac_rb_tree, &MLACP(csm).mac_rb)
+    {
+        if (!(mac_msg->age_flag & MAC_AGE_PEER))
+            num++;
+    }
+
+    if (num == 0)
+        return;
+
+    MLACP(csm).peer_mac_replay = (struct mLACPMACData*)malloc(sizeof(struct mLACPMACData) * num);
+    if (!MLACP(csm).peer_mac_replay)
+    {
+        /*Peer will fall back to full sync*/
+        MLACP(csm).peer_mac_epoch = 0;
+        MLACP(csm).peer_mac_seq = 0;
+        return;
+    }
+
+    mac_data = MLACP(csm).peer_mac_replay;
+    RB_FOREACH (mac_msg, mac_rb_tree, &MLACP(csm).mac_rb)
+    {
+        if (mac_msg->age_flag & MAC_AGE_PEER)
+            continue;
+
+        memset(mac_data, 0, sizeof(struct mLACPMACData));
+        mac_data->type = MAC_SYNC_ADD;
+        mac_data->mac_type = mac_msg->fdb_type;
+        memcpy(mac_data->mac_addr, mac_msg->mac_addr, ETHER_ADDR_LEN);
+        mac_data->vid = htons(mac_msg->vid);
+        memcpy(mac_data->ifname, mac_msg->origin_ifname, MAX_L_PORT_NAME);
+        mac_data++;
+    }
+    MLACP(csm).peer_mac_replay_num = num;
+
+    ICCPD_LOG_NOTICE("ICCP_FDB", "ICCP session down: saved %u peer MACs at peer seq %u",
+        num, MLACP(csm).peer_mac_seq);
+    return;
+}
+
 void mlacp_peer_disconn_fdb_handler(struct CSM* csm)
 {
     struct MACMsg* mac_msg = NULL, *mac_temp = NULL;
 
+    mlacp_peer_disconn_save_mac(csm);
+
     RB_FOREACH_SAFE (mac_msg, mac_rb_tree, &MLACP(csm).mac_rb, mac_temp)
     {
         ICCPD_LOG_DEBUG("ICCP_FDB", "ICCP session down: existing flag %d interface %s, MAC %s vlan-id %d,"
@@ -2318,7 +2414,7 @@ void mlacp_peer_disconn_fdb_handler(struct CSM* csm)
                 // else free is taken care after sending the update to peer
                 if (!MAC_IN_MSG_LIST(&(MLACP(csm).mac_msg_list), mac_msg, tail))
                 {
-                    free(mac_msg);
+                    mlacp_mac_msg_free(csm, mac_msg);
                 }
             }
         }
@@ -2505,7 +2601,7 @@ void mlacp_peerlink_down_handler(struct CSM* csm)
             // else free is taken care after sending the update to peer
             if (!MAC_IN_MSG_LIST(&(MLACP(csm).mac_msg_list), mac_msg, tail))
             {
-                free(mac_msg);
+                mlacp_mac_msg_free(csm, mac_msg);
             }
         }
     }
@@ -2566,7 +2662,6 @@ int iccp_connect_syncd()
     int fd = 0;
     struct sockaddr_in serv;
     static int count = 0;
-    struct epoll_event event;
 
     if ((sys = system_get_instance()) == NULL)
     {
@@ -2610,9 +2705,7 @@ int iccp_connect_syncd()
     ICCPD_LOG_NOTICE(__FUNCTION__, "Success to link syncd");
     sys->sync_fd = fd;
 
-    event.data.fd = fd;
-    event.events = EPOLLIN;
-    ret = epoll_ctl(sys->epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    ret = scheduler_event_add(sys, &sys->sync_event, fd, iccp_mclagsyncd_msg_handler, NULL);
 
     count = 0;
     return 0;
@@ -2638,6 +2731,7 @@ void syncd_info_close()
 
     if (sys->sync_fd > 0)
     {
+        scheduler_event_del(sys, &sys->sync_event);
         close(sys->sync_fd);
         sys->sync_fd = -1;
     }
@@ -2976,7 +3070,7 @@ void do_mac_update_from_syncd(uint8_t mac_addr[ETHER_ADDR_LEN], uint16_t vid, ch
                     // else free is taken care after sending the update to peer
                     if (!MAC_IN_MSG_LIST(&(MLACP(csm).mac_msg_list), mac_info, tail))
                     {
-                        free(mac_info);
+                        mlacp_mac_msg_free(csm, mac_info);
                     }
                 }
                 else if (csm->peer_link_if && csm->peer_link_if->state != PORT_STATE_DOWN)
@@ -3013,7 +3107,7 @@ void do_mac_update_from_syncd(uint8_t mac_addr[ETHER_ADDR_LEN], uint16_t vid, ch
                 // else free is taken care after sending the update to peer
                 if (!MAC_IN_MSG_LIST(&(MLACP(csm).mac_msg_list), mac_info, tail))
                 {
-                    free(mac_info);
+                    mlacp_mac_msg_free(csm, mac_info);
                 }
             }
             else
@@ -3347,7 +3441,7 @@ int iccp_receive_fdb_handler_from_syncd(struct System *sys, char *msg_buf)
     return 0;
 }
 
-int iccp_mclagsyncd_msg_handler(struct System *sys)
+int iccp_mclagsyncd_msg_handler(struct System *sys, struct iccp_event *ev)
 {
     int num_bytes_rxed = 0;
     char *msg_buf = g_iccp_mlagsyncd_recv_buf;
@@ -3675,11 +3769,24 @@ char * mclagd_ctl_cmd_str(int req_type)
     return "error req type";
 }
 
+/* One mclagdctl request per connection, served before the next event */
+static int mclagd_ctl_sock_event_handler(struct System *sys, struct iccp_event *ev)
+{
+    int client_fd = mclagd_ctl_sock_accept(ev->fd);
+
+    if (client_fd > 0)
+    {
+        mclagd_ctl_interactive_process(client_fd);
+        close(client_fd);
+    }
+
+    return 0;
+}
+
 int mclagd_ctl_sock_create()
 {
     struct sockaddr_un addr;
     struct System* sys = NULL;
-    struct epoll_event event;
     int addr_len;
     int ret = 0;
 
@@ -3720,11 +3827,7 @@ int mclagd_ctl_sock_create()
         return MCLAG_ERROR;
     }
 
-    event.data.fd = sys->sync_ctrl_fd;
-    event.events = EPOLLIN;
-    epoll_ctl(sys->epoll_fd, EPOLL_CTL_ADD, sys->sync_ctrl_fd, &event);
-    FD_SET(sys->sync_ctrl_fd, &(sys->readfd));
-    sys->readfd_count++;
+    scheduler_event_add(sys, &sys->sync_ctrl_event, sys->sync_ctrl_fd, mclagd_ctl_sock_event_handler, NULL);
 
     return sys->sync_ctrl_fd;
 }
@@ -346,6 +346,47 @@ int mlacp_prepare_for_mac_info_to_peer(struct CSM* csm, char* buf, size_t max_bu
     return msg_len;
 }
 
+/*****************************************
+* Prepare Sync MAC sequence TLV
+*
+* ***************************************/
+int mlacp_prepare_for_mac_seq(struct CSM* csm, char* buf, size_t max_buf_size, uint8_t type, uint32_t epoch, uint32_t seq)
+{
+    ICCHdr* icc_hdr = NULL;
+    struct mLACPMACSeqTLV* tlv = NULL;
+    size_t msg_len = sizeof(ICCHdr) + sizeof(struct mLACPMACSeqTLV);
+
+    if (csm == NULL)
+        return MCLAG_ERROR;
+
+    if (buf == NULL)
+        return MCLAG_ERROR;
+
+    if (msg_len > max_buf_size)
+        return MCLAG_ERROR;
+
+    memset(buf, 0, max_buf_size);
+
+    icc_hdr = (ICCHdr*)buf;
+    tlv = (struct mLACPMACSeqTLV*)&buf[sizeof(ICCHdr)];
+
+    /* ICC header */
+    mlacp_fill_icc_header(csm, icc_hdr, msg_len);
+
+    /* MAC sequence TLV */
+    tlv->icc_parameter.u_bit = 0;
+    tlv->icc_parameter.f_bit = 0;
+    tlv->icc_parameter.type = htons(TLV_T_MLACP_MAC_SEQ);
+
+    tlv->icc_parameter.len = htons(sizeof(struct mLACPMACSeqTLV) - sizeof(ICCParameter));
+    tlv->type = type;
+    tlv->epoch = htonl(epoch);
+    tlv->seq = htonl(seq);
+
+    ICCPD_LOG_DEBUG("ICCP_FDB", "TX MAC seq: type %d, epoch %u, seq %u", type, epoch, seq);
+    return msg_len;
+}
+
 /*****************************************
 * Preprare Sync ARP-Info TLV
 *
@@ -361,7 +361,7 @@ int mlacp_fsm_update_mac_entry_from_peer( struct CSM* csm, struct mLACPMACData *
                             // else free is taken care after sending the update to peer
                             if (!MAC_IN_MSG_LIST(&(MLACP(csm).mac_msg_list), mac_msg, tail))
                             {
-                                free(mac_msg);
+                                mlacp_mac_msg_free(csm, mac_msg);
                             }
 
                             ICCPD_LOG_ERR(__FUNCTION__, "Ignore Recv MAC ADD "
@@ -467,7 +467,7 @@ int mlacp_fsm_update_mac_entry_from_peer( struct CSM* csm, struct mLACPMACData *
             // else free is taken care after sending the update to peer
             if (!MAC_IN_MSG_LIST(&(MLACP(csm).mac_msg_list), mac_msg, tail))
             {
-                free(mac_msg);
+                mlacp_mac_msg_free(csm, mac_msg);
             }
         }
         else
@@ -568,6 +568,63 @@ int mlacp_fsm_update_mac_info_from_peer(struct CSM* csm, struct mLACPMACInfoTLV*
     }
 }
 
+/*****************************************
+* Recv from peer, MAC sequence Update
+* ***************************************/
+int mlacp_fsm_update_mac_seq(struct CSM* csm, struct mLACPMACSeqTLV* tlv)
+{
+    uint32_t epoch, seq, i;
+
+    if (!csm || !tlv)
+        return MCLAG_ERROR;
+
+    epoch = ntohl(tlv->epoch);
+    seq = ntohl(tlv->seq);
+
+    ICCPD_LOG_DEBUG("ICCP_FDB", "RX MAC seq: type %d, epoch %u, seq %u", tlv->type, epoch, seq);
+
+    switch (tlv->type)
+    {
+        case MAC_SEQ_ACK:
+            MLACP(csm).peer_mac_seq_support = 1;
+            MLACP(csm).peer_ack_epoch = epoch;
+            MLACP(csm).peer_ack_seq = seq;
+            break;
+
+        case MAC_SEQ_INCR:
+            /*Put back what peer had sent before the session went down,
+              the MACs that follow are the changes since*/
+            ICCPD_LOG_NOTICE("ICCP_FDB", "Peer incremental MAC sync from seq %u, restore %u MACs",
+                seq, MLACP(csm).peer_mac_replay_num);
+            for (i = 0; i < MLACP(csm).peer_mac_replay_num; i++)
+                mlacp_fsm_update_mac_entry_from_peer(csm, &MLACP(csm).peer_mac_replay[i]);
+            /* fall through */
+
+        case MAC_SEQ_FULL:
+            /*No watermark until the first mark of this sync*/
+            MLACP(csm).peer_mac_epoch = 0;
+            MLACP(csm).peer_mac_seq = 0;
+            MLACP(csm).peer_mac_replay_num = 0;
+            if (MLACP(csm).peer_mac_replay)
+            {
+                free(MLACP(csm).peer_mac_replay);
+                MLACP(csm).peer_mac_replay = NULL;
+            }
+            break;
+
+        case MAC_SEQ_MARK:
+            MLACP(csm).peer_mac_epoch = epoch;
+            MLACP(csm).peer_mac_seq = seq;
+            break;
+
+        default:
+            ICCPD_LOG_WARN(__FUNCTION__, "Unknown MAC seq type %d", tlv->type);
+            break;
+    }
+
+    return 0;
+}
+
 /*****************************************
  * Tool : Add ARP Info into ARP list
  *
@@ -588,6 +645,15 @@ void mlacp_enqueue_arp(struct CSM* csm, struct Msg* msg)
     arp_msg = (struct ARPMsg*)msg->buf;
     if (arp_msg->op_type != NEIGH_SYNC_DEL)
     {
+        /* The list holds one entry per IP, callers look it up first */
+        if (RB_INSERT(arp_rb_tree, &(MLACP(csm).arp_rb), msg))
+        {
+            ICCPD_LOG_WARN(__FUNCTION__, "ARP entry %s already in ARP-list, drop it",
+                           show_ip_str(arp_msg->ipv4_addr));
+            free(msg->buf);
+            free(msg);
+            return;
+        }
         TAILQ_INSERT_TAIL(&(MLACP(csm).arp_list), msg, tail);
     }
 
@@ -614,12 +680,161 @@ void mlacp_enqueue_ndisc(struct CSM *csm, struct Msg *msg)
     ndisc_msg = (struct NDISCMsg *)msg->buf;
     if (ndisc_msg->op_type != NEIGH_SYNC_DEL)
     {
+        /* The list holds one entry per IP, callers look it up first */
+        if (RB_INSERT(ndisc_rb_tree, &(MLACP(csm).ndisc_rb), msg))
+        {
+            ICCPD_LOG_WARN(__FUNCTION__, "ND entry %s already in ndisc-list, drop it",
+                           show_ipv6_str((char *)ndisc_msg->ipv6_addr));
+            free(msg->buf);
+            free(msg);
+            return;
+        }
         TAILQ_INSERT_TAIL(&(MLACP(csm).ndisc_list), msg, tail);
     }
 
     return;
 }
 
+/*****************************************
+ * Tool : Find/Remove ARP Info in ARP list
+ *
+ ****************************************/
+struct Msg* mlacp_find_arp(struct CSM* csm, uint32_t ipv4_addr)
+{
+    struct Msg msg_key;
+    struct ARPMsg arp_key;
+
+    arp_key.ipv4_addr = ipv4_addr;
+    msg_key.buf = (char *)&arp_key;
+
+    return RB_FIND(arp_rb_tree, &(MLACP(csm).arp_rb), &msg_key);
+}
+
+void mlacp_dequeue_arp(struct CSM* csm, struct Msg* msg)
+{
+    TAILQ_REMOVE(&(MLACP(csm).arp_list), msg, tail);
+    RB_REMOVE(arp_rb_tree, &(MLACP(csm).arp_rb), msg);
+
+    return;
+}
+
+/*****************************************
+ * Tool : Find/Remove Ndisc Info in ndisc list
+ *
+ ****************************************/
+struct Msg* mlacp_find_ndisc(struct CSM *csm, const uint8_t *ipv6_addr)
+{
+    struct Msg msg_key;
+    struct NDISCMsg ndisc_key;
+
+    memcpy(ndisc_key.ipv6_addr, ipv6_addr, 16);
+    msg_key.buf = (char *)&ndisc_key;
+
+    return RB_FIND(ndisc_rb_tree, &(MLACP(csm).ndisc_rb), &msg_key);
+}
+
+void mlacp_dequeue_ndisc(struct CSM *csm, struct Msg *msg)
+{
+    TAILQ_REMOVE(&(MLACP(csm).ndisc_list), msg, tail);
+    RB_REMOVE(ndisc_rb_tree, &(MLACP(csm).ndisc_rb), msg);
+
+    return;
+}
+
+/*****************************************
+ * Tool : Add/Remove ARP msg in ARP msg queue
+ *
+ ****************************************/
+void mlacp_enqueue_arp_msg(struct CSM* csm, struct Msg* msg)
+{
+    TAILQ_INSERT_TAIL(&(MLACP(csm).arp_msg_list), msg, tail);
+    RB_INSERT(arp_msg_rb_tree, &(MLACP(csm).arp_msg_rb), msg);
+
+    return;
+}
+
+void mlacp_dequeue_arp_msg(struct CSM* csm, struct Msg* msg)
+{
+    TAILQ_REMOVE(&(MLACP(csm).arp_msg_list), msg, tail);
+    RB_REMOVE(arp_msg_rb_tree, &(MLACP(csm).arp_msg_rb), msg);
+
+    return;
+}
+
+/* Drop every queued ARP msg for this IP */
+static void mlacp_purge_arp_msg(struct CSM* csm, uint32_t ipv4_addr)
+{
+    struct Msg* msg = NULL;
+
+    /* Any node with the IP will do, the tree breaks ties by address only */
+    msg = RB_ROOT(arp_msg_rb_tree, &(MLACP(csm).arp_msg_rb));
+    while (msg)
+    {
+        uint32_t addr = ((struct ARPMsg*)msg->buf)->ipv4_addr;
+
+        if (ipv4_addr < addr)
+            msg = RB_LEFT(arp_msg_rb_tree, msg);
+        else if (ipv4_addr > addr)
+            msg = RB_RIGHT(arp_msg_rb_tree, msg);
+        else
+        {
+            mlacp_dequeue_arp_msg(csm, msg);
+            free(msg->buf);
+            free(msg);
+            msg = RB_ROOT(arp_msg_rb_tree, &(MLACP(csm).arp_msg_rb));
+        }
+    }
+
+    return;
+}
+
+/*****************************************
+ * Tool : Add/Remove Ndisc msg in ndisc msg queue
+ *
+ ****************************************/
+void mlacp_enqueue_ndisc_msg(struct CSM *csm, struct Msg *msg)
+{
+    TAILQ_INSERT_TAIL(&(MLACP(csm).ndisc_msg_list), msg, tail);
+    RB_INSERT(ndisc_msg_rb_tree, &(MLACP(csm).ndisc_msg_rb), msg);
+
+    return;
+}
+
+void mlacp_dequeue_ndisc_msg(struct CSM *csm, struct Msg *msg)
+{
+    TAILQ_REMOVE(&(MLACP(csm).ndisc_msg_list), msg, tail);
+    RB_REMOVE(ndisc_msg_rb_tree, &(MLACP(csm).ndisc_msg_rb), msg);
+
+    return;
+}
+
+/* Drop every queued ND msg for this IP */
+static void mlacp_purge_ndisc_msg(struct CSM *csm, const uint8_t *ipv6_addr)
+{
+    struct Msg *msg = NULL;
+    int ret = 0;
+
+    msg = RB_ROOT(ndisc_msg_rb_tree, &(MLACP(csm).ndisc_msg_rb));
+    while (msg)
+    {
+        ret = memcmp(ipv6_addr, ((struct NDISCMsg *)msg->buf)->ipv6_addr, 16);
+
+        if (ret < 0)
+            msg = RB_LEFT(ndisc_msg_rb_tree, msg);
+        else if (ret > 0)
+            msg = RB_RIGHT(ndisc_msg_rb_tree, msg);
+        else
+        {
+            mlacp_dequeue_ndisc_msg(csm, msg);
+            free(msg->buf);
+            free(msg);
+            msg = RB_ROOT(ndisc_msg_rb_tree, &(MLACP(csm).ndisc_msg_rb));
+        }
+    }
+
+    return;
+}
+
 /*****************************************
 * ARP-Info Update
 * ***************************************/
@@ -841,22 +1056,19 @@ int mlacp_fsm_update_arp_entry(struct CSM* csm, struct ARPMsg *arp_entry)
     }
 
     /* update ARP list*/
-    TAILQ_FOREACH(msg, &(MLACP(csm).arp_list), tail)
+    msg = mlacp_find_arp(csm, arp_entry->ipv4_addr);
+    if (msg)
     {
         arp_msg = (struct ARPMsg*)msg->buf;
-        if (arp_msg->ipv4_addr == arp_entry->ipv4_addr)
-        {
-            /*arp_msg->op_type = tlv->type;*/
-            sprintf(arp_msg->ifname, "%s", arp_entry->ifname);
-            memcpy(arp_msg->mac_addr, arp_entry->mac_addr, ETHER_ADDR_LEN);
-            break;
-        }
+        /*arp_msg->op_type = tlv->type;*/
+        sprintf(arp_msg->ifname, "%s", arp_entry->ifname);
+        memcpy(arp_msg->mac_addr, arp_entry->mac_addr, ETHER_ADDR_LEN);
     }
 
     /* delete/add ARP list*/
     if (msg && arp_entry->op_type == NEIGH_SYNC_DEL)
     {
-        TAILQ_REMOVE(&(MLACP(csm).arp_list), msg, tail);
+        mlacp_dequeue_arp(csm, msg);
         free(msg->buf);
         free(msg);
         /*ICCPD_LOG_INFO(__FUNCTION__, "Del arp queue successfully");*/
@@ -878,26 +1090,7 @@ int mlacp_fsm_update_arp_entry(struct CSM* csm, struct ARPMsg *arp_entry)
     }
 
     /* remove all ARP msg queue, when receive peer's ARP list at the same time*/
-    TAILQ_FOREACH(msg, &(MLACP(csm).arp_msg_list), tail)
-    {
-        arp_msg = (struct ARPMsg*)msg->buf;
-        if (arp_msg->ipv4_addr == arp_entry->ipv4_addr)
-            break;
-    }
-
-    while (msg)
-    {
-        arp_msg = (struct ARPMsg*)msg->buf;
-        TAILQ_REMOVE(&(MLACP(csm).arp_msg_list), msg, tail);
-        free(msg->buf);
-        free(msg);
-        TAILQ_FOREACH(msg, &(MLACP(csm).arp_msg_list), tail)
-        {
-            arp_msg = (struct ARPMsg*)msg->buf;
-            if (arp_msg->ipv4_addr == arp_entry->ipv4_addr)
-                break;
-        }
-    }
+    mlacp_purge_arp_msg(csm, arp_entry->ipv4_addr);
 
     return 0;
 }
@@ -1169,22 +1362,19 @@ int mlacp_fsm_update_ndisc_entry(struct CSM *csm, struct NDISCMsg *ndisc_entry)
     }
 
     /* update NDISC list */
-    TAILQ_FOREACH(msg, &(MLACP(csm).ndisc_list), tail)
+    msg = mlacp_find_ndisc(csm, (uint8_t *)ndisc_entry->ipv6_addr);
+    if (msg)
     {
         ndisc_msg = (struct NDISCMsg *)msg->buf;
-        if (memcmp((char *)ndisc_msg->ipv6_addr, (char *)ndisc_entry->ipv6_addr, 16) == 0)
-        {
-            /* ndisc_msg->op_type = tlv->type; */
-            sprintf(ndisc_msg->ifname, "%s", ndisc_entry->ifname);
-            memcpy(ndisc_msg->mac_addr, ndisc_entry->mac_addr, ETHER_ADDR_LEN);
-            break;
-        }
+        /* ndisc_msg->op_type = tlv->type; */
+        sprintf(ndisc_msg->ifname, "%s", ndisc_entry->ifname);
+        memcpy(ndisc_msg->mac_addr, ndisc_entry->mac_addr, ETHER_ADDR_LEN);
     }
 
     /* delete/add NDISC list */
     if (msg && ndisc_entry->op_type == NEIGH_SYNC_DEL)
     {
-        TAILQ_REMOVE(&(MLACP(csm).ndisc_list), msg, tail);
+        mlacp_dequeue_ndisc(csm, msg);
         free(msg->buf);
         free(msg);
         /* ICCPD_LOG_INFO(__FUNCTION__, "Del ndisc queue successfully"); */
@@ -1206,26 +1396,7 @@ int mlacp_fsm_update_ndisc_entry(struct CSM *csm, struct NDISCMsg *ndisc_entry)
     }
 
     /* remove all NDISC msg queue, when receive peer's NDISC list at the same time */
-    TAILQ_FOREACH(msg, &(MLACP(csm).ndisc_msg_list), tail)
-    {
-        ndisc_msg = (struct NDISCMsg *)msg->buf;
-        if (memcmp((char *)ndisc_msg->ipv6_addr, (char *)ndisc_entry->ipv6_addr, 16) == 0)
-            break;
-    }
-
-    while (msg)
-    {
-        ndisc_msg = (struct NDISCMsg *)msg->buf;
-        TAILQ_REMOVE(&(MLACP(csm).ndisc_msg_list), msg, tail);
-        free(msg->buf);
-        free(msg);
-        TAILQ_FOREACH(msg, &(MLACP(csm).ndisc_msg_list), tail)
-        {
-            ndisc_msg = (struct NDISCMsg *)msg->buf;
-            if (memcmp((char *)ndisc_msg->ipv6_addr, (char *)ndisc_entry->ipv6_addr, 16) == 0)
-                break;
-        }
-    }
+    mlacp_purge_ndisc_msg(csm, (uint8_t *)ndisc_entry->ipv6_addr);
 
     return 0;
 }
@@ -46,6 +46,109 @@ static int vlan_node_compare(const struct VLAN_ID *p_vlan_node1, const struct VL
 }
 RB_GENERATE(vlan_rb_tree, VLAN_ID, vlan_entry, vlan_node_compare);
 
+static int lif_name_compare(const struct LocalInterface *lif1, const struct LocalInterface *lif2)
+{
+    return strcmp(lif1->name, lif2->name);
+}
+RB_GENERATE(lif_name_rb_tree, LocalInterface, name_entry, lif_name_compare);
+
+static int lif_ifindex_compare(const struct LocalInterface *lif1, const struct LocalInterface *lif2)
+{
+    if (lif1->ifindex < lif2->ifindex)
+        return -1;
+
+    if (lif1->ifindex > lif2->ifindex)
+        return 1;
+
+    return 0;
+}
+RB_GENERATE(lif_ifindex_rb_tree, LocalInterface, ifindex_entry, lif_ifindex_compare);
+
+static int lif_po_id_compare(const struct LocalInterface *lif1, const struct LocalInterface *lif2)
+{
+    if (lif1->po_id < lif2->po_id)
+        return -1;
+
+    if (lif1->po_id > lif2->po_id)
+        return 1;
+
+    return 0;
+}
+RB_GENERATE(lif_po_id_rb_tree, LocalInterface, po_id_entry, lif_po_id_compare);
+
+/* The indexes hold one interface per key. An interface whose key is already
+ * taken (e.g. several Vlans still waiting for their ifindex) stays on
+ * sys->lif_list only, and is indexed once the holder of the key goes away. */
+static void local_if_unindex_ifindex(struct System *sys, struct LocalInterface *lif)
+{
+    struct LocalInterface *other = NULL;
+
+    if (RB_FIND(lif_ifindex_rb_tree, &(sys->lif_ifindex_tree), lif) != lif)
+        return;
+
+    RB_REMOVE(lif_ifindex_rb_tree, &(sys->lif_ifindex_tree), lif);
+    LIST_FOREACH(other, &(sys->lif_list), system_next)
+    {
+        if (other != lif && other->ifindex == lif->ifindex)
+        {
+            RB_INSERT(lif_ifindex_rb_tree, &(sys->lif_ifindex_tree), other);
+            break;
+        }
+    }
+
+    return;
+}
+
+static void local_if_index_add(struct System *sys, struct LocalInterface *lif)
+{
+    if (RB_INSERT(lif_name_rb_tree, &(sys->lif_name_tree), lif))
+        ICCPD_LOG_WARN(__FUNCTION__, "Duplicate local_if name %s", lif->name);
+
+    RB_INSERT(lif_ifindex_rb_tree, &(sys->lif_ifindex_tree), lif);
+
+    if (lif->type == IF_T_PORT_CHANNEL)
+        RB_INSERT(lif_po_id_rb_tree, &(sys->lif_po_id_tree), lif);
+
+    return;
+}
+
+/* Must be called before lif is taken off sys->lif_list */
+static void local_if_index_del(struct System *sys, struct LocalInterface *lif)
+{
+    struct LocalInterface *other = NULL;
+
+    if (RB_FIND(lif_name_rb_tree, &(sys->lif_name_tree), lif) == lif)
+    {
+        RB_REMOVE(lif_name_rb_tree, &(sys->lif_name_tree), lif);
+        LIST_FOREACH(other, &(sys->lif_list), system_next)
+        {
+            if (other != lif && strcmp(other->name, lif->name) == 0)
+            {
+                RB_INSERT(lif_name_rb_tree, &(sys->lif_name_tree), other);
+                break;
+            }
+        }
+    }
+
+    local_if_unindex_ifindex(sys, lif);
+
+    if (lif->type == IF_T_PORT_CHANNEL
+        && RB_FIND(lif_po_id_rb_tree, &(sys->lif_po_id_tree), lif) == lif)
+    {
+        RB_REMOVE(lif_po_id_rb_tree, &(sys->lif_po_id_tree), lif);
+        LIST_FOREACH(other, &(sys->lif_list), system_next)
+        {
+            if (other != lif && other->type == IF_T_PORT_CHANNEL && other->po_id == lif->po_id)
+            {
+                RB_INSERT(lif_po_id_rb_tree, &(sys->lif_po_id_tree), other);
+                break;
+            }
+        }
+    }
+
+    return;
+}
+
 void local_if_init(struct LocalInterface* local_if)
 {
     if (local_if == NULL)
@@ -165,6 +268,7 @@ struct LocalInterface* local_if_create(int ifindex, char* ifname, int type, uint
                    local_if->mac_addr[3], local_if->mac_addr[4], local_if->mac_addr[5], local_if->state ? "down" : "up");
 
     LIST_INSERT_HEAD(&(sys->lif_list), local_if, system_next);
+    local_if_index_add(sys, local_if);
 
     //if there is pending vlan membership for this interface move to system lif
     move_pending_vlan_mbr_to_lif(sys, local_if);
@@ -194,7 +298,7 @@ struct LocalInterface* local_if_create(int ifindex, char* ifname, int type, uint
 struct LocalInterface* local_if_find_by_name(const char* ifname)
 {
     struct System* sys = NULL;
-    struct LocalInterface* local_if = NULL;
+    struct LocalInterface key;
 
     if (!ifname)
         return NULL;
@@ -202,47 +306,56 @@ struct LocalInterface* local_if_find_by_name(const char* ifname)
     if (!(sys = system_get_instance()))
         return NULL;
 
-    LIST_FOREACH(local_if, &(sys->lif_list), system_next)
-    {
-        if (strcmp(local_if->name, ifname) == 0)
-            return local_if;
-    }
+    /* Names are stored truncated, a longer one never matched */
+    if (strlen(ifname) >= MAX_L_PORT_NAME)
+        return NULL;
 
-    return NULL;
+    snprintf(key.name, MAX_L_PORT_NAME, "%s", ifname);
+
+    return RB_FIND(lif_name_rb_tree, &(sys->lif_name_tree), &key);
 }
 
 struct LocalInterface* local_if_find_by_ifindex(int ifindex)
 {
     struct System* sys = NULL;
-    struct LocalInterface* local_if = NULL;
+    struct LocalInterface key;
 
     if ((sys = system_get_instance()) == NULL)
         return NULL;
 
-    LIST_FOREACH(local_if, &(sys->lif_list), system_next)
-    {
-        if (local_if->ifindex == ifindex)
-            return local_if;
-    }
+    key.ifindex = ifindex;
 
-    return NULL;
+    return RB_FIND(lif_ifindex_rb_tree, &(sys->lif_ifindex_tree), &key);
 }
 
 struct LocalInterface* local_if_find_by_po_id(int po_id)
 {
     struct System* sys = NULL;
-    struct LocalInterface* local_if = NULL;
+    struct LocalInterface key;
 
     if ((sys = system_get_instance()) == NULL)
         return NULL;
 
-    LIST_FOREACH(local_if, &(sys->lif_list), system_next)
-    {
-        if (local_if->type == IF_T_PORT_CHANNEL && local_if->po_id == po_id)
-            return local_if;
-    }
+    key.po_id = po_id;
 
-    return NULL;
+    return RB_FIND(lif_po_id_rb_tree, &(sys->lif_po_id_tree), &key);
+}
+
+void local_if_set_ifindex(struct LocalInterface* lif, int ifindex)
+{
+    struct System* sys = NULL;
+
+    if (lif == NULL || lif->ifindex == ifindex)
+        return;
+
+    if ((sys = system_get_instance()) == NULL)
+        return;
+
+    local_if_unindex_ifindex(sys, lif);
+    lif->ifindex = ifindex;
+    RB_INSERT(lif_ifindex_rb_tree, &(sys->lif_ifindex_tree), lif);
+
+    return;
 }
 
  void local_if_vlan_remove(struct LocalInterface *lif_vlan)
@@ -364,6 +477,7 @@ void local_if_destroy(char *ifname)
 
 to_sys_purge:
     /* sys purge */
+    local_if_index_del(sys, lif);
     LIST_REMOVE(lif, system_next);
     if (lif->csm)
         LIST_REMOVE(lif, mlacp_next);
@@ -372,6 +486,7 @@ to_sys_purge:
 
 to_mlacp_purge:
     /* sys & mlacp purge */
+    local_if_index_del(sys, lif);
     LIST_REMOVE(lif, system_next);
     LIST_REMOVE(lif, mlacp_next);
     LIST_INSERT_HEAD(&(sys->lif_purge_list), lif, system_purge_next);
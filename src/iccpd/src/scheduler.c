@@ -32,6 +32,7 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <sys/epoll.h>
+#include <sys/timerfd.h>
 
 #include "../include/logger.h"
 #include "../include/system.h"
@@ -41,6 +42,7 @@
 #include "../include/iccp_cmd.h"
 #include "../include/mlacp_link_handler.h"
 #include "../include/iccp_netlink.h"
+#include "../include/mlacp_sync_update.h"
 
 /******************************************************
 *
@@ -99,6 +101,168 @@ static void heartbeat_update(struct CSM *csm)
     return;
 }
 
+/* Peer socket event, any message from the peer also counts as a heartbeat */
+static int scheduler_csm_sock_event_handler(struct System* sys, struct iccp_event* ev)
+{
+    struct CSM* csm = ev->owner;
+    struct mLACPHeartbeatTLV dummy_tlv;
+
+    if (scheduler_csm_read_callback(csm) != MCLAG_ERROR)
+    {
+        //consider any msg from peer as heartbeat update, this will be in scenarios of scaled msg sync b/w peers
+        mlacp_fsm_update_heartbeat(csm, &dummy_tlv);
+    }
+
+    return 0;
+}
+
+/* The FSM timer only has to wake the loop, dispatching it marks the FSM pending */
+static int scheduler_fsm_timer_handler(struct System* sys, struct iccp_event* ev)
+{
+    uint64_t expirations;
+
+    if (read(ev->fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN)
+        return -errno;
+
+    return 0;
+}
+
+static int scheduler_fsm_timer_set(int fd, int msec)
+{
+    struct itimerspec its;
+
+    its.it_interval.tv_sec = msec / 1000;
+    its.it_interval.tv_nsec = (msec % 1000) * 1000000;
+    its.it_value = its.it_interval;
+
+    return timerfd_settime(fd, 0, &its, NULL);
+}
+
+static void scheduler_fsm_timer_init(struct System* sys)
+{
+    int fd;
+
+    fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0)
+    {
+        ICCPD_LOG_WARN(__FUNCTION__, "FSM timer create fail, errno %d", errno);
+        return;
+    }
+
+    if (scheduler_fsm_timer_set(fd, SCHEDULER_TIMER_MSEC) < 0
+        || scheduler_event_add(sys, &sys->fsm_timer_event, fd, scheduler_fsm_timer_handler, NULL) < 0)
+    {
+        ICCPD_LOG_WARN(__FUNCTION__, "FSM timer start fail, errno %d", errno);
+        close(fd);
+        return;
+    }
+    sys->fsm_timer_msec = SCHEDULER_TIMER_MSEC;
+
+    return;
+}
+
+/* A session still has work for the next FSM transit: it is connecting or
+ * syncing, or messages are queued for it
+ */
+static int scheduler_csm_busy(struct CSM* csm)
+{
+    if (csm->sock_fd <= 0)
+        return 0;
+
+    if (csm->current_state != ICCP_OPERATIONAL
+        || csm->app_csm.current_state != APP_OPERATIONAL
+        || MLACP(csm).current_state != MLACP_STATE_EXCHANGE)
+        return 1;
+
+    if (!TAILQ_EMPTY(&(csm->msg_list))
+        || !TAILQ_EMPTY(&(csm->app_csm.app_msg_list))
+        || !TAILQ_EMPTY(&(MLACP(csm).mlacp_msg_list))
+        || !TAILQ_EMPTY(&(MLACP(csm).mac_msg_list))
+        || !TAILQ_EMPTY(&(MLACP(csm).arp_msg_list))
+        || !TAILQ_EMPTY(&(MLACP(csm).ndisc_msg_list)))
+        return 1;
+
+    return MLACP(csm).need_to_sync || MLACP(csm).system_config_changed;
+}
+
+/* Tick every SCHEDULER_TIMER_MSEC while a session is busy. Otherwise only
+ * heartbeat, aging and reconnect run from the timer, and they count seconds
+ */
+static void scheduler_fsm_timer_update(struct System* sys)
+{
+    struct CSM* csm = NULL;
+    int msec = SCHEDULER_IDLE_TIMER_MSEC;
+
+    if (sys->fsm_timer_event.fd < 0)
+        return;
+
+    LIST_FOREACH(csm, &(sys->csm_list), next)
+    {
+        if (scheduler_csm_busy(csm))
+        {
+            msec = SCHEDULER_TIMER_MSEC;
+            break;
+        }
+    }
+
+    if (msec == sys->fsm_timer_msec)
+        return;
+
+    if (scheduler_fsm_timer_set(sys->fsm_timer_event.fd, msec) < 0)
+    {
+        ICCPD_LOG_WARN(__FUNCTION__, "FSM timer set %d msec fail, errno %d", msec, errno);
+        return;
+    }
+    sys->fsm_timer_msec = msec;
+
+    return;
+}
+
+int scheduler_event_add(struct System* sys, struct iccp_event* ev, int fd,
+                        iccp_event_handler handler, void* owner)
+{
+    struct epoll_event event;
+
+    ev->handler = handler;
+    ev->owner = owner;
+    event.data.ptr = ev;
+    event.events = EPOLLIN;
+    if (epoll_ctl(sys->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+        return -errno;
+
+    ev->fd = fd;
+    sys->event_count++;
+
+    return 0;
+}
+
+int scheduler_event_del(struct System* sys, struct iccp_event* ev)
+{
+    struct epoll_event event;
+    int err = 0;
+    int i;
+
+    if (ev->fd < 0)
+        return 0;
+
+    event.data.ptr = ev;
+    event.events = EPOLLIN;
+    if (epoll_ctl(sys->epoll_fd, EPOLL_CTL_DEL, ev->fd, &event) != 0)
+        err = -errno;
+
+    /* The owner may be freed before the rest of the batch is dispatched */
+    for (i = 0; i < sys->epoll_nfds; i++)
+    {
+        if (sys->epoll_events[i].data.ptr == ev)
+            sys->epoll_events[i].data.ptr = NULL;
+    }
+
+    ev->fd = -1;
+    sys->event_count--;
+
+    return err;
+}
+
 /* Transit FSM of all connections */
 static int scheduler_transit_fsm()
 {
@@ -319,13 +483,10 @@ int scheduler_server_accept()
     session_conn_thread_lock(&csm->conn_mutex);
     ICCPD_LOG_INFO(__FUNCTION__, "Server Accept, SocketFD [%d], %p", new_fd, csm);
 
-    struct epoll_event event;
     int err;
     int send_buf_len = PEER_SOCK_SND_BUF_LEN;
     int recv_buf_len = PEER_SOCK_RCV_BUF_LEN;
-    event.data.fd = new_fd;
-    event.events = EPOLLIN;
-    err = epoll_ctl(sys->epoll_fd, EPOLL_CTL_ADD, new_fd, &event);
+    err = scheduler_event_add(sys, &csm->sock_event, new_fd, scheduler_csm_sock_event_handler, csm);
     if (err)
     {
         session_conn_thread_unlock(&csm->conn_mutex);
@@ -342,8 +503,6 @@ int scheduler_server_accept()
         ICCPD_LOG_ERR(__FUNCTION__, "Set socket recv buf option failed. Error");
     }
     csm->current_state = ICCP_NONEXISTENT;
-    FD_SET(new_fd, &(sys->readfd));
-    sys->readfd_count++;
     session_conn_thread_unlock(&csm->conn_mutex);
     return 0;
 }
@@ -406,6 +565,8 @@ void scheduler_init()
         ICCPD_LOG_WARN(__FUNCTION__, "Mclagd ctl info socket connect fail");
     }
 
+    scheduler_fsm_timer_init(sys);
+
     return;
 }
 
@@ -431,7 +592,7 @@ void mlacp_sync_send_warmboot_flag()
     return;
 }
 
-int iccp_receive_signal_handler(struct System* sys)
+int iccp_receive_signal_handler(struct System* sys, struct iccp_event* ev)
 {
     char ctrl_byte;
     int err = 0;
@@ -473,10 +634,18 @@ void scheduler_loop()
             iccp_connect_syncd();
         }
 
-        /*handle socket slelect event ,If no message received, it will block 0.1s*/
+        /*handle socket events, the FSM timer wakes the loop every
+          SCHEDULER_TIMER_MSEC, or SCHEDULER_IDLE_TIMER_MSEC when no session is busy*/
         iccp_handle_events(sys);
-        /*csm, app state machine transit */
-        scheduler_transit_fsm();
+        /*csm, app state machine transit, once per batch of events */
+        if (sys->fsm_pending)
+        {
+            sys->fsm_pending = 0;
+            scheduler_transit_fsm();
+            scheduler_fsm_timer_update(sys);
+        }
+        /*send FDB entries queued during this pass*/
+        iccp_flush_fdb_batch_to_syncd();
 
         if (sys->warmboot_exit == WARM_REBOOT)
         {
@@ -617,13 +786,10 @@ void session_client_conn_handler(struct CSM *csm)
     else
     {
         /* Conn OK*/
-        struct epoll_event event;
         int err;
         int send_buf_len = PEER_SOCK_SND_BUF_LEN;
         int recv_buf_len = PEER_SOCK_RCV_BUF_LEN;
-        event.data.fd = connFd;
-        event.events = EPOLLIN;
-        err = epoll_ctl(sys->epoll_fd, EPOLL_CTL_ADD, connFd, &event);
+        err = scheduler_event_add(sys, &csm->sock_event, connFd, scheduler_csm_sock_event_handler, csm);
         if (err)
             goto conn_fail;
         csm->sock_fd = connFd;
@@ -636,8 +802,6 @@ void session_client_conn_handler(struct CSM *csm)
             ICCPD_LOG_ERR(__FUNCTION__, "Set socket recv buf option failed. Error");
         }
 
-        FD_SET(connFd, &(sys->readfd));
-        sys->readfd_count++;
         ICCPD_LOG_INFO(__FUNCTION__, "Connect to server %s sucess .", csm->peer_ip);
         goto conn_ok;
     }
@@ -820,10 +984,7 @@ int scheduler_unregister_sock_read_event_callback(struct CSM* csm)
         return MCLAG_ERROR;
     }
 
-    if (csm->sock_fd > 0)
-    {
-        FD_CLR(csm->sock_fd, &(sys->readfd));
-    }
+    scheduler_event_del(sys, &csm->sock_event);
 
     return 0;
 }
@@ -861,7 +1022,6 @@ void scheduler_session_disconnect_handler(struct CSM* csm)
 void scheduler_csm_socket_cleanup(struct CSM* csm, int location)
 {
     struct System* sys;
-    struct epoll_event event;
 
     sys = system_get_instance();
     if (sys == NULL)
@@ -873,9 +1033,7 @@ void scheduler_csm_socket_cleanup(struct CSM* csm, int location)
     if (csm->sock_fd <= 0)
         return;
 
-    event.data.fd = csm->sock_fd;
-    event.events = EPOLLIN;
-    if (epoll_ctl(sys->epoll_fd, EPOLL_CTL_DEL, csm->sock_fd, &event) != 0)
+    if (scheduler_event_del(sys, &csm->sock_event) != 0)
     {
         ICCPD_LOG_ERR("ICCP_FSM", "CSM socket %d epoll del error %d, location %d",
                       csm->sock_fd, errno, location);
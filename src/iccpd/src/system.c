@@ -72,6 +72,9 @@ void system_init(struct System* sys)
     LIST_INIT(&(sys->csm_list));
     LIST_INIT(&(sys->lif_list));
     LIST_INIT(&(sys->lif_purge_list));
+    RB_INIT(lif_name_rb_tree, &(sys->lif_name_tree));
+    RB_INIT(lif_ifindex_rb_tree, &(sys->lif_ifindex_tree));
+    RB_INIT(lif_po_id_rb_tree, &(sys->lif_po_id_tree));
     LIST_INIT(&(sys->unq_ip_if_list));
     LIST_INIT(&(sys->pending_vlan_mbr_if_list));
 
@@ -81,8 +84,12 @@ void system_init(struct System* sys)
     sys->mclagdctl_file_path = strdup("/var/run/iccpd/mclagdctl.sock");
     sys->pid_file_fd = 0;
     sys->telnet_port = 2015;
-    FD_ZERO(&(sys->readfd));
-    sys->readfd_count = 0;
+    ICCP_EVENT_INIT(&sys->sync_event);
+    ICCP_EVENT_INIT(&sys->sync_ctrl_event);
+    ICCP_EVENT_INIT(&sys->sig_pipe_event);
+    ICCP_EVENT_INIT(&sys->fsm_timer_event);
+    sys->fsm_timer_msec = 0;
+    sys->event_count = 0;
     sys->csm_trans_time = 0;
     sys->need_sync_team_again = 0;
     sys->need_sync_netlink_again = 0;
@@ -122,6 +129,9 @@ void system_finalize()
         LIST_REMOVE(local_if, system_next);
         local_if_finalize(local_if);
     }
+    RB_INIT(lif_name_rb_tree, &(sys->lif_name_tree));
+    RB_INIT(lif_ifindex_rb_tree, &(sys->lif_ifindex_tree));
+    RB_INIT(lif_po_id_rb_tree, &(sys->lif_po_id_tree));
 
     while (!LIST_EMPTY(&(sys->lif_purge_list)))
     {
@@ -164,6 +174,8 @@ void system_finalize()
         close(sys->sig_pipe_r);
     if (sys->sig_pipe_w > 0)
         close(sys->sig_pipe_w);
+    if (sys->fsm_timer_event.fd >= 0)
+        close(sys->fsm_timer_event.fd);
 
     if (sys->epoll_fd)
         close(sys->epoll_fd);
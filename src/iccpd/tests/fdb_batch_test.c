@@ -0,0 +1,124 @@
+/*
+ * fdb_batch_test.c
+ *
+ * FDB entries sent to mclagsyncd are batched. A socketpair stands in for
+ * mclagsyncd; the test checks how entries are packed into messages and that
+ * they keep their order, also relative to other messages.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#include "../include/system.h"
+#include "../include/mlacp_link_handler.h"
+#include "../include/msg_format.h"
+
+#define FDB_PER_MSG \
+    ((MCLAG_MAX_MSG_LEN - sizeof(struct IccpSyncdHDr)) / sizeof(struct mclag_fdb_info))
+
+static char g_recv_buf[1 << 20];
+
+static void queue_mac(int i, uint8_t oper)
+{
+    struct MACMsg mac_msg;
+
+    memset(&mac_msg, 0, sizeof(mac_msg));
+    mac_msg.vid = 10;
+    mac_msg.mac_addr[0] = 0x02;
+    mac_msg.mac_addr[4] = i >> 8;
+    mac_msg.mac_addr[5] = i & 0xff;
+    snprintf(mac_msg.ifname, sizeof(mac_msg.ifname), "PortChannel%d", i % 4);
+
+    if (oper == MAC_SYNC_DEL)
+        del_mac_from_chip(&mac_msg);
+    else
+        add_mac_to_chip(&mac_msg, MAC_TYPE_DYNAMIC);
+}
+
+/* Read all that was sent; returns the SET_FDB message count. Entries must
+ * come in queue order. *seen counts them, *other_at is the entry count at
+ * which a message of another type was read.
+ */
+static int read_syncd(int fd, int last_del, int *seen, int *other_at)
+{
+    ssize_t n = recv(fd, g_recv_buf, sizeof(g_recv_buf), MSG_DONTWAIT);
+    size_t pos = 0;
+    int msgs = 0;
+    int k, cnt;
+
+    while (n > 0 && pos < (size_t)n)
+    {
+        struct IccpSyncdHDr *hdr = (struct IccpSyncdHDr *)&g_recv_buf[pos];
+
+        assert(hdr->ver == ICCPD_TO_MCLAGSYNCD_HDR_VERSION);
+        assert(hdr->len >= sizeof(*hdr) && hdr->len <= MCLAG_MAX_MSG_LEN);
+        if (hdr->type == MCLAG_MSG_TYPE_SET_FDB)
+        {
+            cnt = (hdr->len - sizeof(*hdr)) / sizeof(struct mclag_fdb_info);
+            assert(cnt > 0 && cnt <= (int)FDB_PER_MSG);
+            for (k = 0; k < cnt; k++)
+            {
+                struct mclag_fdb_info *fdb = (struct mclag_fdb_info *)
+                    &g_recv_buf[pos + sizeof(*hdr) + k * sizeof(*fdb)];
+
+                assert(((fdb->mac[4] << 8) | fdb->mac[5]) == *seen);
+                assert(fdb->vid == 10);
+                assert(fdb->op_type == (*seen == last_del ? MAC_SYNC_DEL : MAC_SYNC_ADD));
+                (*seen)++;
+            }
+            msgs++;
+        }
+        else
+        {
+            *other_at = *seen;
+        }
+        pos += hdr->len;
+    }
+    return msgs;
+}
+
+int main(void)
+{
+    const int num = 300;
+    int sv[2];
+    int sz = 1 << 20;
+    int i, seen = 0, other_at = -1;
+    struct System *sys;
+    char other[sizeof(struct IccpSyncdHDr)];
+    struct IccpSyncdHDr *other_hdr = (struct IccpSyncdHDr *)other;
+
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+    setsockopt(sv[0], SOL_SOCKET, SO_SNDBUF, &sz, sizeof(sz));
+    sys = system_get_instance();
+    sys->sync_fd = sv[0];
+
+    /* Full batches go out as they fill, the rest waits for a flush */
+    for (i = 0; i < num; i++)
+        queue_mac(i, i == num - 1 ? MAC_SYNC_DEL : MAC_SYNC_ADD);
+    assert(read_syncd(sv[1], num - 1, &seen, &other_at) == num / FDB_PER_MSG);
+    assert(seen == (int)(num / FDB_PER_MSG * FDB_PER_MSG));
+
+    /* Another message does not overtake the queued entries */
+    memset(other, 0, sizeof(other));
+    other_hdr->ver = ICCPD_TO_MCLAGSYNCD_HDR_VERSION;
+    other_hdr->type = MCLAG_MSG_TYPE_FLUSH_FDB;
+    other_hdr->len = sizeof(other);
+    iccp_send_to_mclagsyncd(other_hdr->type, other, other_hdr->len);
+    assert(read_syncd(sv[1], num - 1, &seen, &other_at) == 1);
+    assert(seen == num && other_at == num);
+
+    /* The end of scheduler pass flush sends a partial batch, and nothing
+     * when the batch is empty
+     */
+    queue_mac(num, MAC_SYNC_ADD);
+    iccp_flush_fdb_batch_to_syncd();
+    iccp_flush_fdb_batch_to_syncd();
+    assert(read_syncd(sv[1], -1, &seen, &other_at) == 1);
+    assert(seen == num + 1);
+    assert(recv(sv[1], g_recv_buf, sizeof(g_recv_buf), MSG_DONTWAIT) < 0);
+
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * lif_index_test.c
+ *
+ * Local interfaces are indexed by name, ifindex and po_id. Each index holds
+ * one interface per key; the test changes ifindexes, renames and destroys
+ * interfaces, and checks that every lookup returns the right interface or
+ * NULL.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "../include/system.h"
+#include "../include/port.h"
+
+#define NUM_PORTS 500
+
+static struct LocalInterface* port_create(int i, int ifindex)
+{
+    char name[MAX_L_PORT_NAME];
+
+    snprintf(name, sizeof(name), "Ethernet%d", i);
+    return local_if_create(ifindex, name, IF_T_PORT, PORT_STATE_UP);
+}
+
+int main(void)
+{
+    char name[MAX_L_PORT_NAME];
+    struct LocalInterface *po, *po_new, *v10, *v20, *held, *e5, *renamed;
+    int i;
+
+    for (i = 0; i < NUM_PORTS; i++)
+        assert(port_create(i, 100 + i));
+    po = local_if_create(2000, "PortChannel0001", IF_T_PORT_CHANNEL, PORT_STATE_UP);
+    v10 = local_if_create(-1, "Vlan10", IF_T_VLAN, PORT_STATE_DOWN);
+    v20 = local_if_create(-1, "Vlan20", IF_T_VLAN, PORT_STATE_DOWN);
+
+    assert(local_if_find_by_name("Ethernet123")->ifindex == 223);
+    assert(local_if_find_by_ifindex(223) == local_if_find_by_name("Ethernet123"));
+    assert(local_if_find_by_po_id(1) == po);
+    assert(local_if_find_by_ifindex(2000) == po);
+    assert(local_if_find_by_po_id(2) == NULL);
+    assert(local_if_find_by_name("Ethernet9999") == NULL);
+    assert(local_if_find_by_name("Vlan20") == v20);
+
+    /* Both Vlans wait for their ifindex; one holds -1 in the index and the
+     * other takes over when it gets its ifindex
+     */
+    held = local_if_find_by_ifindex(-1);
+    assert(held == v10 || held == v20);
+    local_if_set_ifindex(held, 3000);
+    assert(local_if_find_by_ifindex(3000) == held);
+    assert(local_if_find_by_ifindex(-1) == (held == v10 ? v20 : v10));
+    local_if_set_ifindex(local_if_find_by_ifindex(-1), 3001);
+    assert(local_if_find_by_ifindex(-1) == NULL);
+    assert(local_if_find_by_name("Vlan10")->ifindex == (held == v10 ? 3000 : 3001));
+
+    /* ifindex change of a port is a destroy and a create */
+    local_if_destroy("Ethernet5");
+    assert(local_if_find_by_name("Ethernet5") == NULL);
+    assert(local_if_find_by_ifindex(105) == NULL);
+    e5 = port_create(5, 9005);
+    assert(local_if_find_by_name("Ethernet5") == e5);
+    assert(local_if_find_by_ifindex(9005) == e5);
+    assert(local_if_find_by_ifindex(105) == NULL);
+
+    /* A create for an ifindex in use returns its holder. A rename is a
+     * destroy of the old name and a create of the new one on the same ifindex
+     */
+    assert(port_create(NUM_PORTS, 106) == local_if_find_by_name("Ethernet6"));
+    local_if_destroy("Ethernet6");
+    assert(local_if_find_by_name("Ethernet6") == NULL);
+    assert(local_if_find_by_ifindex(106) == NULL);
+    renamed = port_create(NUM_PORTS, 106);
+    assert(local_if_find_by_ifindex(106) == renamed);
+    snprintf(name, sizeof(name), "Ethernet%d", NUM_PORTS);
+    assert(local_if_find_by_name(name) == renamed);
+    assert(local_if_find_by_name("Ethernet6") == NULL);
+
+    /* po_id follows the name, not the ifindex */
+    local_if_destroy("PortChannel0001");
+    assert(local_if_find_by_po_id(1) == NULL);
+    assert(local_if_find_by_ifindex(2000) == NULL);
+    po_new = local_if_create(2001, "PortChannel0001", IF_T_PORT_CHANNEL, PORT_STATE_UP);
+    assert(local_if_find_by_po_id(1) == po_new);
+    assert(local_if_find_by_ifindex(2001) == po_new);
+
+    local_if_destroy("Vlan10");
+    assert(local_if_find_by_name("Vlan10") == NULL);
+    assert(local_if_find_by_name("Vlan20") == v20);
+
+    for (i = 0; i <= NUM_PORTS; i++)
+    {
+        snprintf(name, sizeof(name), "Ethernet%d", i);
+        local_if_destroy(name);
+        assert(local_if_find_by_name(name) == NULL);
+    }
+    for (i = 0; i <= NUM_PORTS; i++)
+        assert(local_if_find_by_ifindex(100 + i) == NULL);
+    assert(local_if_find_by_ifindex(9005) == NULL);
+    assert(local_if_find_by_po_id(1) == po_new);
+
+    local_if_purge_clear();
+    system_finalize();
+    printf("PASS\n");
+    return 0;
+}
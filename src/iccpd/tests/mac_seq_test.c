@@ -0,0 +1,289 @@
+/*
+ * mac_seq_test.c
+ *
+ * After an ICCP session bounce only the MACs that changed are sent again,
+ * when the peer's (epoch, seq) watermark matches. Two peers, a and b, sync
+ * over socketpairs; a learns the MACs and b must end up with exactly what a
+ * advertises. The test counts the MACs a sends on every reconnect: all of
+ * them on the first sync, only the changes after a bounce, none after an
+ * idle bounce, and all of them again when the epoch does not match, the
+ * MARK was lost or the tombstones overflowed.
+ *
+ * It includes mlacp_fsm.c to reach the static sync send and receive handlers.
+ */
+
+#include "../src/mlacp_fsm.c"
+
+#include <assert.h>
+#include <fcntl.h>
+#include <pthread.h>
+
+#define NUM_MACS 20000
+
+struct sink
+{
+    int fd;
+    char *buf;
+    size_t len;
+    size_t size;
+};
+
+static struct CSM g_a, g_b;
+static size_t g_macs_sent;
+
+static void csm_setup(struct CSM *csm)
+{
+    memset(csm, 0, sizeof(*csm));
+    mlacp_init(csm, 1);
+    strcpy(csm->peer_itf_name, "PortChannel99");
+    MLACP(csm).current_state = MLACP_STATE_EXCHANGE;
+}
+
+static void mac_key(int i, struct MACMsg *mac_msg)
+{
+    memset(mac_msg, 0, sizeof(*mac_msg));
+    mac_msg->vid = 10 + i % 3;
+    mac_msg->mac_addr[0] = 0x02;
+    mac_msg->mac_addr[3] = i >> 16;
+    mac_msg->mac_addr[4] = i >> 8;
+    mac_msg->mac_addr[5] = i;
+}
+
+/* Local learn of a MAC on a, as the FDB handler adds it */
+static void learn(struct CSM *csm, int i, const char *ifname)
+{
+    struct MACMsg mac_msg, *new_mac_msg = NULL;
+
+    mac_key(i, &mac_msg);
+    mac_msg.fdb_type = MAC_TYPE_DYNAMIC;
+    strcpy(mac_msg.ifname, ifname);
+    strcpy(mac_msg.origin_ifname, ifname);
+    mac_msg.age_flag = MAC_AGE_PEER;
+    assert(iccp_csm_init_mac_msg(&new_mac_msg, (char *)&mac_msg, sizeof(mac_msg)) == 0);
+    RB_INSERT(mac_rb_tree, &MLACP(csm).mac_rb, new_mac_msg);
+    new_mac_msg->op_type = MAC_SYNC_ADD;
+    if (MLACP(csm).current_state == MLACP_STATE_EXCHANGE)
+        TAILQ_INSERT_TAIL(&MLACP(csm).mac_msg_list, new_mac_msg, tail);
+}
+
+static struct MACMsg *find(struct CSM *csm, int i)
+{
+    struct MACMsg mac_key_msg;
+
+    mac_key(i, &mac_key_msg);
+    return RB_FIND(mac_rb_tree, &MLACP(csm).mac_rb, &mac_key_msg);
+}
+
+/* Local delete of a MAC on a while the session is down */
+static void forget(struct CSM *csm, int i)
+{
+    struct MACMsg *mac_msg = find(csm, i);
+
+    assert(mac_msg);
+    MAC_RB_REMOVE(mac_rb_tree, &MLACP(csm).mac_rb, mac_msg);
+    mlacp_mac_msg_free(csm, mac_msg);
+}
+
+/* b must hold exactly the MACs a advertises, as peer-owned ones */
+static void check_views(struct CSM *a, struct CSM *b)
+{
+    struct MACMsg *mac_msg, *peer_mac_msg;
+    int advertised = 0, from_peer = 0;
+
+    RB_FOREACH(mac_msg, mac_rb_tree, &MLACP(a).mac_rb)
+    {
+        if (mac_msg->age_flag & MAC_AGE_LOCAL)
+            continue;
+        advertised++;
+        peer_mac_msg = RB_FIND(mac_rb_tree, &MLACP(b).mac_rb, mac_msg);
+        assert(peer_mac_msg && !(peer_mac_msg->age_flag & MAC_AGE_PEER));
+        assert(strcmp(peer_mac_msg->origin_ifname, mac_msg->origin_ifname) == 0);
+    }
+    RB_FOREACH(mac_msg, mac_rb_tree, &MLACP(b).mac_rb)
+    {
+        if (!(mac_msg->age_flag & MAC_AGE_PEER))
+            from_peer++;
+    }
+    assert(advertised == from_peer);
+}
+
+/* Collects what the peer writes, the sender blocks once the socket is full */
+static void *sink_read(void *arg)
+{
+    struct sink *sink = (struct sink *)arg;
+    ssize_t n;
+
+    while (1)
+    {
+        if (sink->size - sink->len < CSM_BUFFER_SIZE)
+        {
+            sink->size = sink->size * 2 + CSM_BUFFER_SIZE;
+            sink->buf = realloc(sink->buf, sink->size);
+            assert(sink->buf);
+        }
+        n = read(sink->fd, sink->buf + sink->len, sink->size - sink->len);
+        if (n <= 0)
+            break;
+        sink->len += n;
+    }
+    return NULL;
+}
+
+/* Run send on from and hand what it wrote to to, or drop it if to is NULL */
+static void exchange(struct CSM *from, struct CSM *to, void (*send)(struct CSM *))
+{
+    struct sink sink;
+    pthread_t reader;
+    int sv[2];
+    size_t pos = 0;
+
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+    memset(&sink, 0, sizeof(sink));
+    sink.fd = sv[1];
+    assert(pthread_create(&reader, NULL, sink_read, &sink) == 0);
+    from->sock_fd = sv[0];
+    send(from);
+    close(sv[0]);
+    from->sock_fd = -1;
+    pthread_join(reader, NULL);
+    close(sv[1]);
+
+    while (to && pos < sink.len)
+    {
+        ICCHdr *icc_hdr = (ICCHdr *)&sink.buf[pos];
+        ICCParameter *param = (ICCParameter *)&sink.buf[pos + sizeof(ICCHdr)];
+        struct Msg msg;
+
+        msg.buf = (char *)icc_hdr;
+        msg.len = ntohs(icc_hdr->ldp_hdr.msg_len) + MSG_L_INCLUD_U_BIT_MSG_T_L_FIELDS;
+        assert(pos + msg.len <= sink.len);
+        *(uint16_t *)param = ntohs(*(uint16_t *)param);
+        if (param->type == TLV_T_MLACP_MAC_INFO)
+        {
+            g_macs_sent += ntohs(((struct mLACPMACInfoTLV *)param)->num_of_entry);
+            mlacp_sync_recv_macInfo(to, &msg);
+        }
+        else
+        {
+            assert(param->type == TLV_T_MLACP_MAC_SEQ);
+            mlacp_sync_recv_macSeq(to, &msg);
+        }
+        pos += msg.len;
+    }
+    free(sink.buf);
+}
+
+/* b reports the watermark of a's history it holds, as in the sync stage */
+static void send_ack(struct CSM *csm)
+{
+    mlacp_sync_send_macSeq(csm, MAC_SEQ_ACK, MLACP(csm).peer_mac_epoch, MLACP(csm).peer_mac_seq);
+}
+
+static void send_sync(struct CSM *csm)
+{
+    mlacp_sync_mac(csm);
+    mlacp_sync_send_syncMacInfo(csm);
+}
+
+static void disconnect(struct CSM *a, struct CSM *b)
+{
+    MLACP(a).current_state = MLACP_STATE_INIT;
+    MLACP(b).current_state = MLACP_STATE_INIT;
+    mlacp_peer_disconn_fdb_handler(b);
+}
+
+/* Returns the number of MACs a sent for the sync */
+static size_t reconnect(struct CSM *a, struct CSM *b)
+{
+    mlacp_mac_msg_queue_reinit(a);
+    MLACP(a).peer_mac_seq_support = 0;
+    exchange(b, a, send_ack);
+    MLACP(a).current_state = MLACP_STATE_EXCHANGE;
+    MLACP(b).current_state = MLACP_STATE_EXCHANGE;
+    g_macs_sent = 0;
+    exchange(a, b, send_sync);
+    check_views(a, b);
+    return g_macs_sent;
+}
+
+int main(void)
+{
+    struct CSM *a = &g_a, *b = &g_b;
+    struct MACMsg *mac_msg;
+    int num = NUM_MACS;
+    int i;
+
+    logger_set_configuration(WARN_LOG_LEVEL);
+    system_get_instance()->sync_fd = open("/dev/null", O_WRONLY);
+    csm_setup(a);
+    csm_setup(b);
+
+    /* b has no history of a yet, so the first sync is full */
+    for (i = 0; i < num; i++)
+        learn(a, i, "Ethernet4");
+    while (!TAILQ_EMPTY(&MLACP(a).mac_msg_list))
+    {
+        mac_msg = TAILQ_FIRST(&MLACP(a).mac_msg_list);
+        MAC_TAILQ_REMOVE(&MLACP(a).mac_msg_list, mac_msg, tail);
+    }
+    assert(reconnect(a, b) == (size_t)num);
+    assert(MLACP(b).peer_mac_epoch == MLACP(a).mac_epoch);
+    assert(MLACP(b).peer_mac_seq == (uint32_t)num);
+
+    /* Live updates move b's watermark */
+    for (i = num; i < num + 50; i++)
+        learn(a, i, "Ethernet8");
+    num += 50;
+    exchange(a, b, mlacp_sync_send_syncMacInfo);
+    assert(MLACP(b).peer_mac_seq == (uint32_t)num);
+
+    /* a deletes, moves, turns local and learns MACs while the session is
+     * down; only those are sent again
+     */
+    disconnect(a, b);
+    assert(MLACP(b).peer_mac_replay_num == num);
+    for (i = 0; i < 10; i++)
+        forget(a, i * 7);
+    for (i = 0; i < 5; i++)
+        strcpy(find(a, 1000 + i)->origin_ifname, "Ethernet12");
+    for (i = 0; i < 3; i++)
+        find(a, 2000 + i)->age_flag |= MAC_AGE_LOCAL;
+    for (i = num; i < num + 7; i++)
+        learn(a, i, "Ethernet16");
+    assert(reconnect(a, b) == 10 + 5 + 3 + 7);
+    assert(MLACP(b).peer_mac_replay == NULL);
+    num += 7 - 10 - 3;
+
+    /* A bounce without changes sends no MACs */
+    disconnect(a, b);
+    assert(reconnect(a, b) == 0);
+
+    /* The session drops after INCR but before the MARK: b holds no
+     * watermark, so the next sync is full
+     */
+    disconnect(a, b);
+    exchange(b, a, send_ack);
+    exchange(a, NULL, mlacp_sync_mac);
+    mlacp_mac_msg_queue_reinit(a);
+    MLACP(b).peer_mac_epoch = 0;
+    mlacp_peer_disconn_fdb_handler(b);
+    assert(reconnect(a, b) == (size_t)num);
+
+    /* a restarted its history: the epoch does not match, full sync */
+    disconnect(a, b);
+    MLACP(a).mac_epoch++;
+    assert(reconnect(a, b) == (size_t)num);
+
+    /* Too many deletes while down overflow the tombstones, full sync. b
+     * deleted the peer MACs on disconnect and the full sync does not add
+     * them back
+     */
+    disconnect(a, b);
+    for (i = 3000; i < 3000 + MAC_TOMBSTONE_MAX + 1; i++)
+        forget(a, i);
+    num -= MAC_TOMBSTONE_MAX + 1;
+    assert(reconnect(a, b) == (size_t)num);
+
+    printf("PASS\n");
+    return 0;
+}
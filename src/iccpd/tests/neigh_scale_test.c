@@ -0,0 +1,237 @@
+/*
+ * neigh_scale_test.c
+ *
+ * mLACP keeps the ARP and ND lists and their msg queues indexed by IP. One
+ * peer learns 64k ARP and 64k ND entries and runs a full sync to the other;
+ * the test checks the lookups on both sides, that a second full sync updates
+ * the entries in place and purges what was queued for them, and that a
+ * duplicate entry is refused.
+ *
+ * It includes mlacp_fsm.c to reach the static sync send and receive handlers.
+ */
+
+#include "../src/mlacp_fsm.c"
+
+#include <assert.h>
+#include <pthread.h>
+
+#define NUM_NEIGH 65536
+
+struct sink
+{
+    int fd;
+    char *buf;
+    size_t len;
+    size_t size;
+};
+
+static struct CSM g_a, g_b;
+
+static void csm_setup(struct CSM *csm)
+{
+    memset(csm, 0, sizeof(*csm));
+    mlacp_init(csm, 1);
+    strcpy(csm->peer_itf_name, "PortChannel99");
+    MLACP(csm).current_state = MLACP_STATE_EXCHANGE;
+}
+
+static uint32_t ipv4_of(int i)
+{
+    return htonl(0x0a000000 | i);
+}
+
+static void ipv6_of(int i, uint32_t *ipv6_addr)
+{
+    ipv6_addr[0] = htonl(0xfd000000);
+    ipv6_addr[1] = 0;
+    ipv6_addr[2] = 0;
+    ipv6_addr[3] = htonl(i);
+}
+
+static void mac_of(int i, uint8_t *mac_addr)
+{
+    memset(mac_addr, 0, ETHER_ADDR_LEN);
+    mac_addr[0] = 0x02;
+    mac_addr[3] = i >> 16;
+    mac_addr[4] = i >> 8;
+    mac_addr[5] = i;
+}
+
+static void learn_arp(struct CSM *csm, int i, int mac_i)
+{
+    struct ARPMsg arp_msg;
+    struct Msg *msg = NULL;
+
+    memset(&arp_msg, 0, sizeof(arp_msg));
+    arp_msg.op_type = NEIGH_SYNC_LIF;
+    arp_msg.learn_flag = NEIGH_LOCAL;
+    strcpy(arp_msg.ifname, "Vlan10");
+    arp_msg.ipv4_addr = ipv4_of(i);
+    mac_of(mac_i, arp_msg.mac_addr);
+    assert(iccp_csm_init_msg(&msg, (char *)&arp_msg, sizeof(arp_msg)) == 0);
+    mlacp_enqueue_arp(csm, msg);
+}
+
+static void learn_ndisc(struct CSM *csm, int i, int mac_i)
+{
+    struct NDISCMsg ndisc_msg;
+    struct Msg *msg = NULL;
+
+    memset(&ndisc_msg, 0, sizeof(ndisc_msg));
+    ndisc_msg.op_type = NEIGH_SYNC_LIF;
+    ndisc_msg.learn_flag = NEIGH_LOCAL;
+    strcpy(ndisc_msg.ifname, "Vlan10");
+    ipv6_of(i, ndisc_msg.ipv6_addr);
+    mac_of(mac_i, ndisc_msg.mac_addr);
+    assert(iccp_csm_init_msg(&msg, (char *)&ndisc_msg, sizeof(ndisc_msg)) == 0);
+    mlacp_enqueue_ndisc(csm, msg);
+}
+
+static int queue_len(struct Msg *msg)
+{
+    int len = 0;
+
+    for (; msg; msg = TAILQ_NEXT(msg, tail))
+        len++;
+    return len;
+}
+
+/* Every entry of the list is found by its IP and has the right MAC */
+static void check_neigh(struct CSM *csm, int mac_offset)
+{
+    struct Msg *msg;
+    uint32_t ipv6_addr[4];
+    uint8_t mac_addr[ETHER_ADDR_LEN];
+    int i;
+
+    assert(queue_len(TAILQ_FIRST(&MLACP(csm).arp_list)) == NUM_NEIGH);
+    assert(queue_len(TAILQ_FIRST(&MLACP(csm).ndisc_list)) == NUM_NEIGH);
+    for (i = 0; i < NUM_NEIGH; i++)
+    {
+        mac_of(i + mac_offset, mac_addr);
+        msg = mlacp_find_arp(csm, ipv4_of(i));
+        assert(msg && ((struct ARPMsg *)msg->buf)->ipv4_addr == ipv4_of(i));
+        assert(memcmp(((struct ARPMsg *)msg->buf)->mac_addr, mac_addr, ETHER_ADDR_LEN) == 0);
+
+        ipv6_of(i, ipv6_addr);
+        msg = mlacp_find_ndisc(csm, (uint8_t *)ipv6_addr);
+        assert(msg && memcmp(((struct NDISCMsg *)msg->buf)->ipv6_addr, ipv6_addr, 16) == 0);
+        assert(memcmp(((struct NDISCMsg *)msg->buf)->mac_addr, mac_addr, ETHER_ADDR_LEN) == 0);
+    }
+    assert(mlacp_find_arp(csm, ipv4_of(NUM_NEIGH)) == NULL);
+    ipv6_of(NUM_NEIGH, ipv6_addr);
+    assert(mlacp_find_ndisc(csm, (uint8_t *)ipv6_addr) == NULL);
+}
+
+/* Collects what the peer writes, the sender blocks once the socket is full */
+static void *sink_read(void *arg)
+{
+    struct sink *sink = (struct sink *)arg;
+    ssize_t n;
+
+    while (1)
+    {
+        if (sink->size - sink->len < CSM_BUFFER_SIZE)
+        {
+            sink->size = sink->size * 2 + CSM_BUFFER_SIZE;
+            sink->buf = realloc(sink->buf, sink->size);
+            assert(sink->buf);
+        }
+        n = read(sink->fd, sink->buf + sink->len, sink->size - sink->len);
+        if (n <= 0)
+            break;
+        sink->len += n;
+    }
+    return NULL;
+}
+
+/* Full sync from a to b, as when the session enters the exchange state */
+static void full_sync(struct CSM *a, struct CSM *b)
+{
+    struct sink sink;
+    pthread_t reader;
+    int sv[2];
+    size_t pos = 0;
+
+    mlacp_resync_arp(a);
+    mlacp_resync_ndisc(a);
+    assert(queue_len(TAILQ_FIRST(&MLACP(a).arp_msg_list)) == NUM_NEIGH);
+    assert(queue_len(TAILQ_FIRST(&MLACP(a).ndisc_msg_list)) == NUM_NEIGH);
+
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+    memset(&sink, 0, sizeof(sink));
+    sink.fd = sv[1];
+    assert(pthread_create(&reader, NULL, sink_read, &sink) == 0);
+    a->sock_fd = sv[0];
+    mlacp_sync_send_syncArpInfo(a);
+    mlacp_sync_send_syncNdiscInfo(a);
+    close(sv[0]);
+    a->sock_fd = -1;
+    pthread_join(reader, NULL);
+    close(sv[1]);
+
+    assert(TAILQ_EMPTY(&MLACP(a).arp_msg_list) && RB_EMPTY(arp_msg_rb_tree, &MLACP(a).arp_msg_rb));
+    assert(TAILQ_EMPTY(&MLACP(a).ndisc_msg_list) && RB_EMPTY(ndisc_msg_rb_tree, &MLACP(a).ndisc_msg_rb));
+
+    while (pos < sink.len)
+    {
+        ICCHdr *icc_hdr = (ICCHdr *)&sink.buf[pos];
+        ICCParameter *param = (ICCParameter *)&sink.buf[pos + sizeof(ICCHdr)];
+        struct Msg msg;
+
+        msg.buf = (char *)icc_hdr;
+        msg.len = ntohs(icc_hdr->ldp_hdr.msg_len) + MSG_L_INCLUD_U_BIT_MSG_T_L_FIELDS;
+        assert(pos + msg.len <= sink.len);
+        *(uint16_t *)param = ntohs(*(uint16_t *)param);
+        mlacp_sync_receiver_handler(b, &msg);
+        pos += msg.len;
+    }
+    free(sink.buf);
+}
+
+int main(void)
+{
+    struct CSM *a = &g_a, *b = &g_b;
+    int i;
+
+    /* One line per synced entry would flood the log */
+    logger_set_configuration(WARN_LOG_LEVEL);
+    csm_setup(a);
+    csm_setup(b);
+
+    for (i = 0; i < NUM_NEIGH; i++)
+    {
+        learn_arp(a, i, i);
+        learn_ndisc(a, i, i);
+    }
+    check_neigh(a, 0);
+
+    /* A second entry for an IP is refused, the first one stays */
+    learn_arp(a, 7, NUM_NEIGH + 7);
+    learn_ndisc(a, 7, NUM_NEIGH + 7);
+    check_neigh(a, 0);
+
+    full_sync(a, b);
+    check_neigh(b, 0);
+
+    /* The peer's entries replace whatever b had queued for the same IPs */
+    for (i = 0; i < NUM_NEIGH; i++)
+    {
+        uint32_t ipv6_addr[4];
+
+        mac_of(i + 1, ((struct ARPMsg *)mlacp_find_arp(a, ipv4_of(i))->buf)->mac_addr);
+        ipv6_of(i, ipv6_addr);
+        mac_of(i + 1, ((struct NDISCMsg *)mlacp_find_ndisc(a, (uint8_t *)ipv6_addr)->buf)->mac_addr);
+    }
+    mlacp_resync_arp(b);
+    mlacp_resync_ndisc(b);
+    full_sync(a, b);
+    check_neigh(b, 1);
+    assert(TAILQ_EMPTY(&MLACP(b).arp_msg_list) && RB_EMPTY(arp_msg_rb_tree, &MLACP(b).arp_msg_rb));
+    assert(TAILQ_EMPTY(&MLACP(b).ndisc_msg_list) && RB_EMPTY(ndisc_msg_rb_tree, &MLACP(b).ndisc_msg_rb));
+
+    mlacp_finalize(a);
+    mlacp_finalize(b);
+    printf("PASS\n");
+    return 0;
+}
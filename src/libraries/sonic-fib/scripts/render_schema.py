@@ -276,7 +276,7 @@ def build_def_structs(defs):
 def main():
     if len(sys.argv) != 5:
         print("Usage: ./render_schema.py <schema.json> <template_dir> <output_file> <mode>")
-        print("  mode: 'header', 'source', 'json_bindings', or 'c_header'")
+        print("  mode: 'header', 'source', 'json_bindings', 'binary_bindings', or 'c_header'")
         sys.exit(1)
 
     schema_path = sys.argv[1]
@@ -284,8 +284,8 @@ def main():
     output_path = sys.argv[3]
     mode = sys.argv[4]
 
-    if mode not in ("header", "source", "json_bindings", "c_header"):
-        print("Error: mode must be 'header', 'source', 'json_bindings', or 'c_header'")
+    if mode not in ("header", "source", "json_bindings", "binary_bindings", "c_header"):
+        print("Error: mode must be 'header', 'source', 'json_bindings', 'binary_bindings', or 'c_header'")
         sys.exit(1)
 
     # Load and parse schema
@@ -347,6 +347,15 @@ def main():
             "special_structs": special_structs,
             "all_structs": all_structs
         }
+    elif mode == "binary_bindings":
+        template_name = "nexthopgroupfull_binary.h.j2"
+        context = {
+            "enums": enums,
+            "root_struct_name": root_struct_name,
+            "root_struct": root_struct,
+            "special_structs": special_structs,
+            "all_structs": all_structs
+        }
     elif mode == "c_header":
         template_name = "c_nexthopgroupfull.h.j2"
         context = {
@@ -2,9 +2,13 @@
 
 #include "src/nexthopgroupfull.h"
 #include "src/nexthopgroupfull_json.h"
+#include "src/nexthopgroup_batch.h"
 #include "src/c_nexthopgroupfull.h"
 #include "src/nexthopgroup_debug.h"
 #include "nexthopgroup_capi.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <cstdlib>
 #include <cstring>
 #include <string>
@@ -13,6 +17,148 @@
 
 using namespace std;
 
+/*
+ * The view borrows the C arrays and SRv6 data as their C++ counterparts, so the
+ * layouts must match: same size and alignment, and every member at the same offset.
+ */
+#define C_LAYOUT_MATCHES(c_type, cpp_type) \
+    (sizeof(c_type) == sizeof(cpp_type) && alignof(c_type) == alignof(cpp_type))
+#define C_MEMBER_MATCHES(c_type, cpp_type, member) \
+    (offsetof(c_type, member) == offsetof(cpp_type, member) && \
+     sizeof(((c_type*)nullptr)->member) == sizeof(((cpp_type*)nullptr)->member))
+
+static_assert(C_LAYOUT_MATCHES(C_nh_grp_full, fib::nh_grp_full) &&
+              C_MEMBER_MATCHES(C_nh_grp_full, fib::nh_grp_full, id) &&
+              C_MEMBER_MATCHES(C_nh_grp_full, fib::nh_grp_full, weight) &&
+              C_MEMBER_MATCHES(C_nh_grp_full, fib::nh_grp_full, num_direct),
+              "C_nh_grp_full layout mismatch");
+static_assert(C_LAYOUT_MATCHES(C_g_addr, fib::g_addr) &&
+              C_MEMBER_MATCHES(C_g_addr, fib::g_addr, ipv4) &&
+              C_MEMBER_MATCHES(C_g_addr, fib::g_addr, ipv6),
+              "C_g_addr layout mismatch");
+static_assert(C_LAYOUT_MATCHES(C_seg6local_flavors_info, fib::seg6local_flavors_info) &&
+              C_MEMBER_MATCHES(C_seg6local_flavors_info, fib::seg6local_flavors_info, flv_ops) &&
+              C_MEMBER_MATCHES(C_seg6local_flavors_info, fib::seg6local_flavors_info, lcblock_len) &&
+              C_MEMBER_MATCHES(C_seg6local_flavors_info, fib::seg6local_flavors_info, lcnode_func_len),
+              "C_seg6local_flavors_info layout mismatch");
+static_assert(C_LAYOUT_MATCHES(C_seg6local_context, fib::seg6local_context) &&
+              C_MEMBER_MATCHES(C_seg6local_context, fib::seg6local_context, nh4) &&
+              C_MEMBER_MATCHES(C_seg6local_context, fib::seg6local_context, nh6) &&
+              C_MEMBER_MATCHES(C_seg6local_context, fib::seg6local_context, table) &&
+              C_MEMBER_MATCHES(C_seg6local_context, fib::seg6local_context, flv) &&
+              C_MEMBER_MATCHES(C_seg6local_context, fib::seg6local_context, block_len) &&
+              C_MEMBER_MATCHES(C_seg6local_context, fib::seg6local_context, node_len) &&
+              C_MEMBER_MATCHES(C_seg6local_context, fib::seg6local_context, function_len) &&
+              C_MEMBER_MATCHES(C_seg6local_context, fib::seg6local_context, argument_len),
+              "C_seg6local_context layout mismatch");
+static_assert(C_LAYOUT_MATCHES(C_nexthop_srv6, fib::nexthop_srv6) &&
+              C_MEMBER_MATCHES(C_nexthop_srv6, fib::nexthop_srv6, seg6local_action) &&
+              C_MEMBER_MATCHES(C_nexthop_srv6, fib::nexthop_srv6, seg6local_ctx) &&
+              C_MEMBER_MATCHES(C_nexthop_srv6, fib::nexthop_srv6, seg6_src) &&
+              C_MEMBER_MATCHES(C_nexthop_srv6, fib::nexthop_srv6, seg6_segs),
+              "C_nexthop_srv6 layout mismatch");
+static_assert(C_LAYOUT_MATCHES(C_seg6_seg_stack, fib::seg6_seg_stack) &&
+              C_MEMBER_MATCHES(C_seg6_seg_stack, fib::seg6_seg_stack, encap_behavior) &&
+              C_MEMBER_MATCHES(C_seg6_seg_stack, fib::seg6_seg_stack, num_segs) &&
+              offsetof(C_seg6_seg_stack, seg) == offsetof(fib::seg6_seg_stack, seg),
+              "C_seg6_seg_stack layout mismatch");
+
+#undef C_MEMBER_MATCHES
+#undef C_LAYOUT_MATCHES
+
+/* Copy the per-thread scratch buffer into a malloc'd string the C caller owns */
+static char* nexthopgroup_dup_buffer(const std::string& buf)
+{
+    char* c_str = static_cast<char*>(std::malloc(buf.size() + 1));
+    if (c_str) {
+        std::memcpy(c_str, buf.c_str(), buf.size() + 1);
+    }
+    return c_str;
+}
+
+/* Serialize a view into a per-thread scratch buffer and hand back a malloc'd copy */
+static char* nexthopgroup_view_to_json(const fib::NextHopGroupFullView& view)
+{
+    thread_local std::string json_buf;
+    json_buf.clear();
+    fib::JsonStringSink sink(json_buf);
+    fib::json_write(sink, view);
+    return nexthopgroup_dup_buffer(json_buf);
+}
+
+/* Borrow a multi-nexthop C group, only the fields set by the multi-nexthop constructors are taken */
+static bool nexthopgroup_multi_view(const struct C_NextHopGroupFull* c_nhg, uint32_t nh_grp_full_count,
+                                    uint32_t depends_count, uint32_t dependents_count, bool is_recurisve,
+                                    fib::NextHopGroupFullView& view)
+{
+    FIB_LOG(fib::LogLevel::DEBUG, "nh_grp_full_count %d, depends_count %d, dependents_count %d, is_recurisve 0x%x",
+        nh_grp_full_count, depends_count, dependents_count, (uint8_t)is_recurisve);
+
+    /* Defensive bounds check on array count parameters */
+    if (nh_grp_full_count > (MULTIPATH_NUM * MAX_NHG_RECURSION) + 1 ||
+        depends_count > MULTIPATH_NUM + 1 ||
+        dependents_count > MULTIPATH_NUM + 1) {
+        FIB_LOG(fib::LogLevel::ERROR, "Count exceeds array bounds: nh_grp_full_count=%u, depends_count=%u, dependents_count=%u",
+            nh_grp_full_count, depends_count, dependents_count);
+        return false;
+    }
+
+    view = fib::NextHopGroupFullView();
+    view.id = c_nhg->id;
+    view.key = c_nhg->key;
+    view.nhg_flags = c_nhg->nhg_flags;
+    view.ifname = "";
+    view.nh_grp_full_list = reinterpret_cast<const fib::nh_grp_full*>(c_nhg->nh_grp_full_list);
+    view.nh_grp_full_list_count = nh_grp_full_count;
+    view.depends = c_nhg->depends;
+    view.depends_count = depends_count;
+    view.dependents = c_nhg->dependents;
+    view.dependents_count = dependents_count;
+    view.type = fib::NEXTHOP_TYPE_INVALID;
+    view.nh_label_type = fib::ZEBRA_LSP_NONE;
+
+    if (is_recurisve) {
+        // Recursive case: includes gate and type
+        view.gate = reinterpret_cast<const fib::g_addr&>(c_nhg->gate);
+        view.type = static_cast<fib::nexthop_types_t>(c_nhg->type);
+    }
+    return true;
+}
+
+/* Borrow a singleton C group and its SRv6 data, converting C types to C++ fib types by force */
+static bool nexthopgroup_singleton_view(const struct C_NextHopGroupFull* c_nhg, uint32_t depends_count,
+                                        uint32_t dependents_count, fib::NextHopGroupFullView& view)
+{
+    if (depends_count > MULTIPATH_NUM + 1 || dependents_count > MULTIPATH_NUM + 1) {
+        FIB_LOG(fib::LogLevel::ERROR, "Count exceeds array bounds: depends_count=%u, dependents_count=%u",
+            depends_count, dependents_count);
+        return false;
+    }
+
+    view = fib::NextHopGroupFullView();
+    view.id = c_nhg->id;
+    view.key = c_nhg->key;
+    view.weight = c_nhg->weight;
+    view.flags = c_nhg->flags;
+    view.nhg_flags = c_nhg->nhg_flags;
+    /* Almostly we do NOT have ifname in zebra, so set it as empty string */
+    view.ifname = "";
+    view.depends = c_nhg->depends;
+    view.depends_count = depends_count;
+    view.dependents = c_nhg->dependents;
+    view.dependents_count = dependents_count;
+    view.type = static_cast<fib::nexthop_types_t>(c_nhg->type);
+    view.vrf_id = static_cast<fib::vrf_id_t>(c_nhg->vrf_id);
+    view.ifindex = c_nhg->ifindex;
+    view.nh_label_type = static_cast<fib::lsp_types_t>(c_nhg->nh_label_type);
+    /* gate and bh_type share the union, copying gate carries bh_type along */
+    view.gate = reinterpret_cast<const fib::g_addr&>(c_nhg->gate);
+    view.src = reinterpret_cast<const fib::g_addr&>(c_nhg->src);
+    view.rmap_src = reinterpret_cast<const fib::g_addr&>(c_nhg->rmap_src);
+    view.nh_srv6 = reinterpret_cast<const fib::nexthop_srv6*>(c_nhg->nh_srv6);
+    return true;
+}
+
 extern "C" {
 
 const char* nexthopgroup_version(void) {
@@ -28,58 +174,17 @@ char* nexthopgroupfull_json_from_c_nhg_multi(const struct C_NextHopGroupFull* c_
     }
 
     try {
-        FIB_LOG(fib::LogLevel::DEBUG, "nh_grp_full_count %d, depends_count %d, dependents_count %d, is_recurisve 0x%x",
-            nh_grp_full_count, depends_count, dependents_count, (uint8_t)is_recurisve);
-
-        /* Defensive bounds check on array count parameters */
-        if (nh_grp_full_count > (MULTIPATH_NUM * MAX_NHG_RECURSION) + 1 ||
-            depends_count > MULTIPATH_NUM + 1 ||
-            dependents_count > MULTIPATH_NUM + 1) {
-            FIB_LOG(fib::LogLevel::ERROR, "Count exceeds array bounds: nh_grp_full_count=%u, depends_count=%u, dependents_count=%u",
-                nh_grp_full_count, depends_count, dependents_count);
+        fib::NextHopGroupFullView view;
+        if (!nexthopgroup_multi_view(c_nhg, nh_grp_full_count, depends_count, dependents_count,
+                                     is_recurisve, view)) {
             return nullptr;
         }
 
-        /* Convert C array to C++ vector */
-        vector<fib::nh_grp_full> cpp_nh_grp_full_list;
-        for (uint32_t i = 0; i < nh_grp_full_count; i++) {
-            /* convert C nh_grp_full to C++ fib::nh_grp_full explicitly */
-            fib::nh_grp_full cpp_nh = {
-                c_nhg->nh_grp_full_list[i].id,
-                c_nhg->nh_grp_full_list[i].weight,
-                c_nhg->nh_grp_full_list[i].num_direct
-            };
-            cpp_nh_grp_full_list.push_back(cpp_nh);
-        }
-        vector<uint32_t> cpp_depends;
-        for (uint32_t i = 0; i < depends_count; i++) {
-            cpp_depends.push_back(c_nhg->depends[i]);
-        }
-        vector<uint32_t> cpp_dependents;
-        for (uint32_t i = 0; i < dependents_count; i++) {
-            cpp_dependents.push_back(c_nhg->dependents[i]);
-        }
-
-        fib::NextHopGroupFull* cpp_nhg = nullptr;
-
-        if (is_recurisve) {
-            // Recursive case: includes cpp_gate and type
-            fib::g_addr cpp_gate = reinterpret_cast<const fib::g_addr&>(c_nhg->gate);
-            cpp_nhg = new fib::NextHopGroupFull(c_nhg->id, c_nhg->key, c_nhg->nhg_flags, cpp_gate,
-                                        static_cast<fib::nexthop_types_t>(c_nhg->type),
-                                        cpp_nh_grp_full_list, cpp_depends, cpp_dependents);
-        } else {
-            // Non-recursive, multipath case
-            cpp_nhg = new fib::NextHopGroupFull(c_nhg->id, c_nhg->key, c_nhg->nhg_flags,
-                                        cpp_nh_grp_full_list, cpp_depends, cpp_dependents);
-        }
-
-        /* Convert C++ Obj to JSON stirng */
-        char* json_str = nexthopgroup_to_json(cpp_nhg);
+        /* Convert the view to JSON string */
+        char* json_str = nexthopgroup_view_to_json(view);
         FIB_LOG(fib::LogLevel::DEBUG, "json_str length %zu, str: %s", 
             json_str ? strlen(json_str) : 0, json_str ? json_str : "null");
 
-        nexthopgroup_free(cpp_nhg);
         return json_str;
 
     } catch (const std::exception& e) {
@@ -99,56 +204,16 @@ char* nexthopgroupfull_json_from_c_nhg_singleton(const struct C_NextHopGroupFull
     }
 
     try {
-        /* Convert C array to C++ vector */
-        vector<uint32_t> cpp_depends;
-        for (uint32_t i = 0; i < depends_count; i++) {
-            cpp_depends.push_back(c_nhg->depends[i]);
-        }
-        vector<uint32_t> cpp_dependents;
-        for (uint32_t i = 0; i < dependents_count; i++) {
-            cpp_dependents.push_back(c_nhg->dependents[i]);
-        }
-
-        /* Almostly we do NOT have ifname in zebra, so set it as empty string */
-        std::string cpp_ifname = "";
-
-        /* Convert seg6_segs flexible array to C++ vector */
-        vector<struct in6_addr> cpp_nh_segs;
-        if (c_nhg->nh_srv6 && c_nhg->nh_srv6->seg6_segs) {
-            for (uint8_t i = 0; i < c_nhg->nh_srv6->seg6_segs->num_segs; i++) {
-                cpp_nh_segs.push_back(c_nhg->nh_srv6->seg6_segs->seg[i]);
-            }
+        fib::NextHopGroupFullView view;
+        if (!nexthopgroup_singleton_view(c_nhg, depends_count, dependents_count, view)) {
+            return nullptr;
         }
 
-        /* Convert g_addr from C type to C++ type */
-        fib::g_addr cpp_gate = reinterpret_cast<const fib::g_addr&>(c_nhg->gate);
-        fib::g_addr cpp_src = reinterpret_cast<const fib::g_addr&>(c_nhg->src);
-        fib::g_addr cpp_rmap_src = reinterpret_cast<const fib::g_addr&>(c_nhg->rmap_src);
-
-        /* Call NextHopGroupFull constructor(singleton) to create NextHopGroupFull object */
-        /* Convert C types to C++ fib types by force */
-        fib::NextHopGroupFull* cpp_nhg = new fib::NextHopGroupFull(c_nhg->id, c_nhg->key,
-                                                         static_cast<fib::nexthop_types_t>(c_nhg->type),
-                                                         static_cast<fib::vrf_id_t>(c_nhg->vrf_id),
-                                                         static_cast<fib::ifindex_t>(c_nhg->ifindex),
-                                                         cpp_ifname, cpp_depends, cpp_dependents,
-                                                         static_cast<fib::lsp_types_t>(c_nhg->nh_label_type),
-                                                         static_cast<fib::blackhole_type>(c_nhg->bh_type),
-                                                         cpp_gate, cpp_src, cpp_rmap_src,c_nhg->weight,
-                                                         c_nhg->flags, c_nhg->nhg_flags,
-                                                         c_nhg->nh_srv6 != nullptr,
-                                                         c_nhg->nh_srv6 && c_nhg->nh_srv6->seg6_segs != nullptr,
-                                                         reinterpret_cast<const fib::nexthop_srv6*>(c_nhg->nh_srv6),
-                                                         reinterpret_cast<const fib::seg6_seg_stack*>(c_nhg->nh_srv6 ? c_nhg->nh_srv6->seg6_segs : nullptr),
-                                                         cpp_nh_segs);
-
-        /* Convert C++ Obj to JSON string */
-        char* json_str = nexthopgroup_to_json(cpp_nhg);
+        /* Convert the view to JSON string */
+        char* json_str = nexthopgroup_view_to_json(view);
         FIB_LOG(fib::LogLevel::DEBUG, "json_str length %zu, str: %s",
             json_str ? strlen(json_str) : 0, json_str ? json_str : "null");
 
-        nexthopgroup_free(cpp_nhg);
-
         return json_str;
 
     } catch (const std::exception& e) {
@@ -160,6 +225,104 @@ char* nexthopgroupfull_json_from_c_nhg_singleton(const struct C_NextHopGroupFull
     }
 }
 
+char* nexthopgroupfull_batch_from_c_nhg(const struct C_NextHopGroupFullBatchItem* items, uint32_t item_count,
+                                        int format, size_t* out_len)
+{
+    if ((!items && item_count) ||
+        (format != NHG_BATCH_FORMAT_JSON && format != NHG_BATCH_FORMAT_BINARY)) {
+        FIB_LOG(fib::LogLevel::ERROR, "Invalid batch: items %p, item_count %u, format %d",
+            static_cast<const void*>(items), item_count, format);
+        return nullptr;
+    }
+
+    try {
+        /* Views and output live in per-thread scratch buffers reused across batches */
+        thread_local std::vector<fib::NextHopGroupFullView> views;
+        thread_local std::string batch_buf;
+        views.resize(item_count);
+        batch_buf.clear();
+
+        for (uint32_t i = 0; i < item_count; i++) {
+            const struct C_NextHopGroupFullBatchItem& item = items[i];
+            if (!item.c_nhg) {
+                FIB_LOG(fib::LogLevel::ERROR, "Batch item %u has an empty C_NextHopGroupFull *", i);
+                return nullptr;
+            }
+            bool ok = item.is_singleton
+                ? nexthopgroup_singleton_view(item.c_nhg, item.depends_count, item.dependents_count, views[i])
+                : nexthopgroup_multi_view(item.c_nhg, item.nh_grp_full_count, item.depends_count,
+                                          item.dependents_count, item.is_recursive, views[i]);
+            if (!ok) {
+                FIB_LOG(fib::LogLevel::ERROR, "Batch item %u rejected", i);
+                return nullptr;
+            }
+        }
+
+        fib::encodeBatch(views.data(), item_count, static_cast<fib::BatchFormat>(format), batch_buf);
+        FIB_LOG(fib::LogLevel::DEBUG, "Encoded %u groups into %zu bytes", item_count, batch_buf.size());
+
+        char* out = nexthopgroup_dup_buffer(batch_buf);
+        if (out && out_len) {
+            *out_len = batch_buf.size();
+        }
+        return out;
+
+    } catch (const std::exception& e) {
+        FIB_LOG(fib::LogLevel::ERROR, "nexthopgroupfull_batch_from_c_nhg::Converting failed: %s", e.what());
+        return nullptr;
+    } catch (...) {
+        FIB_LOG(fib::LogLevel::ERROR, "nexthopgroupfull_batch_from_c_nhg::Converting failed with unknown exception");
+        return nullptr;
+    }
+}
+
+fib::NextHopGroupFull** nexthopgroup_batch_decode(const char* buf, size_t len, int format, uint32_t* out_count)
+{
+    if (!out_count || (format != NHG_BATCH_FORMAT_JSON && format != NHG_BATCH_FORMAT_BINARY)) {
+        return nullptr;
+    }
+    *out_count = 0;
+
+    fib::NextHopGroupFull** objs = nullptr;
+    try {
+        /* Decoded straight into heap objects, ownership moves to objs below */
+        std::vector<std::unique_ptr<fib::NextHopGroupFull>> groups;
+        if (!fib::decodeBatch(buf, len, static_cast<fib::BatchFormat>(format), groups)) {
+            return nullptr;
+        }
+
+        objs = static_cast<fib::NextHopGroupFull**>(
+            std::calloc(groups.size() ? groups.size() : 1, sizeof(fib::NextHopGroupFull*)));
+        if (!objs) {
+            return nullptr;
+        }
+        for (size_t i = 0; i < groups.size(); i++) {
+            objs[i] = groups[i].release();
+            *out_count = static_cast<uint32_t>(i + 1);
+        }
+        return objs;
+
+    } catch (const std::exception& e) {
+        FIB_LOG(fib::LogLevel::ERROR, "nexthopgroup_batch_decode failed: %s", e.what());
+    } catch (...) {
+        FIB_LOG(fib::LogLevel::ERROR, "nexthopgroup_batch_decode failed with unknown exception");
+    }
+    nexthopgroup_batch_free(objs, *out_count);
+    *out_count = 0;
+    return nullptr;
+}
+
+void nexthopgroup_batch_free(fib::NextHopGroupFull** objs, uint32_t count)
+{
+    if (!objs) {
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        delete objs[i];
+    }
+    std::free(objs);
+}
+
 void nexthopgroup_free(fib::NextHopGroupFull* obj)
 {
     delete obj;
@@ -172,12 +335,7 @@ char* nexthopgroup_to_json(fib::NextHopGroupFull* obj)
     }
 
     try {
-        std::string json_str = fib::to_json_string(*obj);
-        char* c_str = static_cast<char*>(std::malloc(json_str.size() + 1));
-        if (c_str) {
-            std::memcpy(c_str, json_str.c_str(), json_str.size() + 1);
-        }
-        return c_str;
+        return nexthopgroup_view_to_json(fib::make_view(*obj));
     } catch (const std::exception& e) {
         FIB_LOG(fib::LogLevel::ERROR, "nexthopgroup_to_json failed: %s", e.what());
         return nullptr;
@@ -187,6 +345,21 @@ char* nexthopgroup_to_json(fib::NextHopGroupFull* obj)
     }
 }
 
+size_t nexthopgroup_to_json_buf(const fib::NextHopGroupFull* obj, char* buf, size_t buf_len)
+{
+    if (!obj) {
+        return 0;
+    }
+
+    /* Like snprintf: always report the full length, write only what fits and NUL terminate */
+    fib::JsonBufferSink sink(buf, buf_len);
+    fib::json_write(sink, *obj);
+    if (buf && buf_len) {
+        buf[std::min(sink.size(), buf_len - 1)] = '\0';
+    }
+    return sink.size();
+}
+
 // Global C callback pointer (set by FRR)
 /* C callback signature matching FRR's needs */
 typedef void (*fib_frr_log_fn)(int level,
@@ -196,7 +369,7 @@ typedef void (*fib_frr_log_fn)(int level,
                                 const char *fmt,
                                 va_list args);
 
-static fib_frr_log_fn g_frr_cb = nullptr;
+static std::atomic<fib_frr_log_fn> g_frr_cb{nullptr};
 
 // C++ wrapper that forwards to C callback
 static void frr_cpp_callback(fib::LogLevel level,
@@ -205,13 +378,14 @@ static void frr_cpp_callback(fib::LogLevel level,
                              const char* func,
                              const char* format,
                              va_list args) {
-    if (!g_frr_cb) return;
+    fib_frr_log_fn cb = g_frr_cb.load(std::memory_order_acquire);
+    if (!cb) return;
 
     // Forward directly to C callback (no copying needed – va_list is consumed once)
-    g_frr_cb(static_cast<int>(level), file, line, func, format, args);
+    cb(static_cast<int>(level), file, line, func, format, args);
 }
 void fib_frr_register_callback(fib_frr_log_fn cb) {
-    g_frr_cb = cb;
+    g_frr_cb.store(cb, std::memory_order_release);
     if (cb) {
         // Bridge C callback → C++ API
         fib::registerLogCallback(frr_cpp_callback);
@@ -13,6 +13,20 @@ const char* nexthopgroup_version(void);
 
 typedef struct NextHopGroupFull NextHopGroupFull;
 
+/* Batch encodings */
+#define NHG_BATCH_FORMAT_JSON   0   /* one JSON object per line, each terminated by '\n' */
+#define NHG_BATCH_FORMAT_BINARY 1   /* binary records (nexthopgroupfull_binary.h) back to back */
+
+/* One group of a batch, counts and flags as for the single item conversions */
+struct C_NextHopGroupFullBatchItem {
+    const struct C_NextHopGroupFull* c_nhg;
+    uint32_t nh_grp_full_count;     /* multi-nexthop groups only */
+    uint32_t depends_count;
+    uint32_t dependents_count;
+    bool is_singleton;
+    bool is_recursive;              /* multi-nexthop groups only */
+};
+
 #ifdef __cplusplus
 namespace fib { class NextHopGroupFull; }
 // C++ APIs
@@ -26,6 +40,11 @@ char* nexthopgroupfull_json_from_c_nhg_singleton(const struct C_NextHopGroupFull
                                                   uint32_t dependents_count);
 void nexthopgroup_free(fib::NextHopGroupFull* obj);
 char* nexthopgroup_to_json(fib::NextHopGroupFull* obj);
+size_t nexthopgroup_to_json_buf(const fib::NextHopGroupFull* obj, char* buf, size_t buf_len);
+char* nexthopgroupfull_batch_from_c_nhg(const struct C_NextHopGroupFullBatchItem* items,
+                                        uint32_t item_count, int format, size_t* out_len);
+fib::NextHopGroupFull** nexthopgroup_batch_decode(const char* buf, size_t len, int format, uint32_t* out_count);
+void nexthopgroup_batch_free(fib::NextHopGroupFull** objs, uint32_t count);
 #else
 /* C APIs */
 char* nexthopgroupfull_json_from_c_nhg_multi(const struct C_NextHopGroupFull* c_nhg, 
@@ -38,6 +57,16 @@ char* nexthopgroupfull_json_from_c_nhg_singleton(const struct C_NextHopGroupFull
                                                   uint32_t dependents_count);
 void nexthopgroup_free(NextHopGroupFull* obj);
 char* nexthopgroup_to_json(NextHopGroupFull* obj);
+/* Writes the JSON of obj into buf (NUL terminated, truncated if short) and
+ * returns its full length, excluding the terminator */
+size_t nexthopgroup_to_json_buf(const NextHopGroupFull* obj, char* buf, size_t buf_len);
+/* Convert item_count groups into one malloc'd buffer in the given NHG_BATCH_FORMAT_*.
+ * The buffer is NUL terminated, *out_len gets its length. Free it with free(). */
+char* nexthopgroupfull_batch_from_c_nhg(const struct C_NextHopGroupFullBatchItem* items,
+                                        uint32_t item_count, int format, size_t* out_len);
+/* Decode a batch buffer into an array of groups, release it with nexthopgroup_batch_free() */
+NextHopGroupFull** nexthopgroup_batch_decode(const char* buf, size_t len, int format, uint32_t* out_count);
+void nexthopgroup_batch_free(NextHopGroupFull** objs, uint32_t count);
 #endif
 
 /* C callback signature matching FRR's needs */
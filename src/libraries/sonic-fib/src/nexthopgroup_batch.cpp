@@ -0,0 +1,122 @@
+#include "nexthopgroup_batch.h"
+#include "nexthopgroupfull_json.h"
+#include "nexthopgroupfull_binary.h"
+#include "nexthopgroup_debug.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace fib {
+
+void encodeBatch(const NextHopGroupFullView* views, size_t count, BatchFormat format, std::string& out)
+{
+    if (format == BatchFormat::BINARY) {
+        for (size_t i = 0; i < count; i++) {
+            append_binary(out, views[i]);
+        }
+        return;
+    }
+
+    JsonStringSink sink(out);
+    for (size_t i = 0; i < count; i++) {
+        json_write(sink, views[i]);
+        sink.put('\n');
+    }
+}
+
+/*
+ * The decoders append through these adapters, so groups can be decoded in place
+ * into a vector of values or into individually allocated objects.
+ */
+static NextHopGroupFull& appendGroup(std::vector<NextHopGroupFull>& out)
+{
+    out.emplace_back();
+    return out.back();
+}
+
+static NextHopGroupFull& appendGroup(std::vector<std::unique_ptr<NextHopGroupFull>>& out)
+{
+    out.emplace_back(new NextHopGroupFull());
+    return *out.back();
+}
+
+template <typename Out>
+static bool decodeBinaryBatch(const char* data, size_t len, Out& out)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    size_t pos = 0;
+    while (pos < len) {
+        NhgBinaryReader hdr(bytes + pos, len - pos);
+        uint8_t version, reserved;
+        uint32_t payload_len;
+        if (!hdr.get_u8(version) || !hdr.get_u8(reserved) || !hdr.get_u32(payload_len) ||
+            payload_len > hdr.remaining()) {
+            FIB_LOG(LogLevel::ERROR, "decodeBatch: truncated binary record at offset %zu", pos);
+            return false;
+        }
+
+        size_t record_len = NHG_BINARY_HEADER_SIZE + payload_len;
+        if (!from_binary(bytes + pos, record_len, appendGroup(out))) {
+            FIB_LOG(LogLevel::ERROR, "decodeBatch: malformed binary record at offset %zu", pos);
+            out.pop_back();
+            return false;
+        }
+        pos += record_len;
+    }
+    return true;
+}
+
+template <typename Out>
+static bool decodeJsonBatch(const char* data, size_t len, Out& out)
+{
+    size_t pos = 0;
+    while (pos < len) {
+        const char* line_end = static_cast<const char*>(memchr(data + pos, '\n', len - pos));
+        size_t line_len = line_end ? static_cast<size_t>(line_end - (data + pos)) : len - pos;
+        if (line_len == 0) {
+            pos++;
+            continue;
+        }
+
+        NextHopGroupFull& nhg = appendGroup(out);
+        /* from_json only fills the IPv4 part of an address for IPv4 types */
+        memset(&nhg.gate, 0, sizeof(nhg.gate));
+        memset(&nhg.src, 0, sizeof(nhg.src));
+        memset(&nhg.rmap_src, 0, sizeof(nhg.rmap_src));
+        try {
+            nlohmann::ordered_json::parse(data + pos, data + pos + line_len).get_to(nhg);
+        } catch (const std::exception& e) {
+            FIB_LOG(LogLevel::ERROR, "decodeBatch: malformed JSON record at offset %zu: %s", pos, e.what());
+            out.pop_back();
+            return false;
+        }
+        pos += line_len + 1;
+    }
+    return true;
+}
+
+template <typename Out>
+static bool decodeBatchInto(const char* data, size_t len, BatchFormat format, Out& out)
+{
+    if (!data && len) {
+        return false;
+    }
+    if (format == BatchFormat::BINARY) {
+        return decodeBinaryBatch(data, len, out);
+    }
+    return decodeJsonBatch(data, len, out);
+}
+
+bool decodeBatch(const char* data, size_t len, BatchFormat format, std::vector<NextHopGroupFull>& out)
+{
+    return decodeBatchInto(data, len, format, out);
+}
+
+bool decodeBatch(const char* data, size_t len, BatchFormat format,
+                 std::vector<std::unique_ptr<NextHopGroupFull>>& out)
+{
+    return decodeBatchInto(data, len, format, out);
+}
+
+} // namespace fib
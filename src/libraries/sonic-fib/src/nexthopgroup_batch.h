@@ -0,0 +1,35 @@
+#pragma once
+
+#include "nexthopgroupfull.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace fib {
+
+// Batch encodings, the values match NHG_BATCH_FORMAT_* in the C API
+enum class BatchFormat : int {
+    JSON   = 0,  // one JSON object per line, each terminated by '\n'
+    BINARY = 1   // binary records from nexthopgroupfull_binary.h back to back
+};
+
+/*
+ * Append count groups to out in the given format. out is not cleared, so a
+ * caller can keep one buffer per thread and reuse its capacity across batches.
+ */
+void encodeBatch(const NextHopGroupFullView* views, size_t count, BatchFormat format, std::string& out);
+
+/*
+ * Decode a buffer produced by encodeBatch and append the groups to out.
+ * Returns false at the first malformed record; groups decoded before it are
+ * kept in out.
+ */
+bool decodeBatch(const char* data, size_t len, BatchFormat format, std::vector<NextHopGroupFull>& out);
+
+// Same, decoding each group straight into its own heap object
+bool decodeBatch(const char* data, size_t len, BatchFormat format,
+                 std::vector<std::unique_ptr<NextHopGroupFull>>& out);
+
+} // namespace fib
@@ -1,22 +1,47 @@
 #include "nexthopgroup_debug.h"
 #include <cstdio>
 #include <cstdarg>
-#include <memory>
 #include <array> // for std::array
-#include <vector> // for std::vector
+#include <thread>
 
 using namespace std;
 using namespace fib;
 
 namespace {  // Anonymous namespace
-struct LoggerState {
-    fib::LogCallback callback;
-    std::mutex mutex;
-    fib::LogLevel level = fib::LogLevel::DEBUG;
-};
-LoggerState& getState() {
-    static LoggerState state;
-    return state;
+/*
+ * The active callback is published through an atomic pointer so that logging
+ * threads never take a lock. Each logging thread announces itself in the reader
+ * count of the current epoch while it uses the callback. registerLogCallback
+ * swaps the pointer, moves to the next epoch and waits for the old epoch's
+ * readers to drain before it frees the replaced callback. Readers arriving
+ * after the flip count in the new epoch, so the wait always ends.
+ */
+std::atomic<const fib::LogCallback*> g_callback{nullptr};
+std::atomic<uint32_t> g_epoch{0};
+std::atomic<uint32_t> g_readers[2];
+std::mutex g_register_mutex;
+
+uint32_t readLock() {
+    for (;;) {
+        uint32_t epoch = g_epoch.load();
+        g_readers[epoch & 1].fetch_add(1);
+        // A flip between the load and the increment: the writer may already have seen zero
+        if (g_epoch.load() == epoch) {
+            return epoch;
+        }
+        g_readers[epoch & 1].fetch_sub(1);
+    }
+}
+
+void readUnlock(uint32_t epoch) {
+    g_readers[epoch & 1].fetch_sub(1, std::memory_order_release);
+}
+
+void waitForReaders() {
+    uint32_t epoch = g_epoch.fetch_add(1);
+    while (g_readers[epoch & 1].load() != 0) {
+        std::this_thread::yield();
+    }
 }
 
 // Default fallback: print to stderr
@@ -56,45 +81,41 @@ void defaultLog(LogLevel level, const char* file, int line,
 } // anonymous namespace
 
 // Public API implementations
-// Don't use FIB_LOG here to avoid recursion mutex
+// Don't use FIB_LOG here to avoid recursion
 void fib::registerLogCallback(LogCallback cb) {
-    auto& state = getState();
-    std::lock_guard<std::mutex> lock(state.mutex);
-    state.callback = std::move(cb);
+    const LogCallback* next = cb ? new LogCallback(std::move(cb)) : nullptr;
+    std::lock_guard<std::mutex> lock(g_register_mutex);
+    const LogCallback* prev = g_callback.exchange(next);
+    if (prev) {
+        waitForReaders();
+        delete prev;
+    }
 }
 
 void fib::setLogLevel(LogLevel level) {
-    auto& state = getState();
-    std::lock_guard<std::mutex> lock(state.mutex);
-    state.level = level;
+    detail::logLevel().store(static_cast<uint32_t>(level), std::memory_order_relaxed);
 }
 
 fib::LogLevel fib::getLogLevel() {
-    auto& state = getState();
-    std::lock_guard<std::mutex> lock(state.mutex);
-    return state.level;
+    return static_cast<LogLevel>(detail::logLevel().load(std::memory_order_relaxed));
 }
 
 // Internal logging implementation
 void fib::internalLog(LogLevel level, const char* file, int line,
                         const char* func, const char* format, ...) {
-    auto& state = getState();
-    fib::LogCallback cb;
+    if (!isLogLevelEnabled(level)) {
+        return;
+    }
+    uint32_t epoch = readLock();
+    const LogCallback* cb = g_callback.load();
     va_list args;
     va_start(args, format);
-    {
-        std::lock_guard<std::mutex> lock(state.mutex);
-        if (static_cast<int>(level) < static_cast<int>(state.level) ) {
-            va_end(args);
-            return;
-        }
-        if (!state.callback) {
-            // Use default logger
-            cb = defaultLog;
-        }  else {
-            cb = state.callback;
-        }
+    if (cb) {
+        (*cb)(level, file, line, func, format, args);  // Forward va_list directly
+    } else {
+        // Use default logger
+        defaultLog(level, file, line, func, format, args);
     }
-    if (cb) cb(level, file, line, func, format, args);  // Forward va_list directly
     va_end(args);
-}
\ No newline at end of file
+    readUnlock(epoch);
+}
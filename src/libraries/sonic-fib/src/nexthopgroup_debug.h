@@ -26,10 +26,23 @@ using LogCallback = std::function<void(
     va_list args         // Raw arguments
 )>;
 
+namespace detail {
+// Current log level, read without locking on every FIB_LOG. Use setLogLevel/getLogLevel.
+inline std::atomic<uint32_t>& logLevel() {
+    static std::atomic<uint32_t> level{static_cast<uint32_t>(LogLevel::DEBUG)};
+    return level;
+}
+} // namespace detail
+
+inline bool isLogLevelEnabled(LogLevel level) {
+    return static_cast<uint32_t>(level) >= detail::logLevel().load(std::memory_order_relaxed);
+}
+
 // Internal logging macro (used inside library implementation)
+// Arguments are only evaluated and formatted when the level is enabled
 #define FIB_LOG(level, fmt, ...) \
     do { \
-        if (static_cast<int>(level) >= static_cast<int>(fib::getLogLevel())) { \
+        if (fib::isLogLevelEnabled(level)) { \
             fib::internalLog(level, __FILE__, __LINE__, __func__, fmt, ##__VA_ARGS__); \
         } \
     } while (0)
@@ -42,7 +55,9 @@ void internalLog(LogLevel level, const char* file, int line,
 /*
  * Public APIs to register a log callback from C++ code
  */
-// Register callback function
+// Register callback function, safe to call while other threads are logging.
+// Waits until no thread is still running the replaced callback, so it must not
+// be called from inside a log callback.
 void registerLogCallback(LogCallback cb);
 
 // Set and get log level
@@ -0,0 +1,239 @@
+#include "nexthopgroup_intern.h"
+#include "nexthopgroup_debug.h"
+
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+namespace fib {
+
+/* 64-bit FNV-1a, fed field by field so struct padding never reaches the hash */
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+static void hashBytes(uint64_t& h, const void* data, size_t len)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < len; i++) {
+        h ^= bytes[i];
+        h *= FNV_PRIME;
+    }
+}
+
+template <typename T>
+static void hashValue(uint64_t& h, const T& value)
+{
+    hashBytes(h, &value, sizeof(value));
+}
+
+size_t hashNextHopGroupPayload(const NextHopGroupFull& nhg)
+{
+    uint64_t h = FNV_OFFSET_BASIS;
+
+    hashValue(h, nhg.weight);
+    hashValue(h, nhg.flags);
+    hashValue(h, nhg.nhg_flags);
+    hashValue(h, nhg.ifname.size());
+    hashBytes(h, nhg.ifname.data(), nhg.ifname.size());
+    hashValue(h, nhg.type);
+    hashValue(h, nhg.vrf_id);
+    hashValue(h, nhg.ifindex);
+    hashValue(h, nhg.nh_label_type);
+
+    hashValue(h, nhg.nh_grp_full_list.size());
+    for (const auto& nh : nhg.nh_grp_full_list) {
+        hashValue(h, nh.id);
+        hashValue(h, nh.weight);
+        hashValue(h, nh.num_direct);
+    }
+
+    /* gate and bh_type share storage, only the one the type uses is compared */
+    if (nhg.type == NEXTHOP_TYPE_BLACKHOLE) {
+        hashValue(h, nhg.bh_type);
+    } else {
+        hashValue(h, nhg.gate);
+    }
+    hashValue(h, nhg.src);
+    hashValue(h, nhg.rmap_src);
+
+    hashValue(h, nhg.nh_srv6 != nullptr);
+    if (nhg.nh_srv6 != nullptr) {
+        /* seg6local_ctx is compared with memcmp, so hash its bytes the same way */
+        hashValue(h, nhg.nh_srv6->seg6local_action);
+        hashValue(h, nhg.nh_srv6->seg6local_ctx);
+        hashValue(h, nhg.nh_srv6->seg6_src);
+
+        const seg6_seg_stack* segs = nhg.nh_srv6->seg6_segs;
+        hashValue(h, segs != nullptr);
+        if (segs != nullptr) {
+            hashValue(h, segs->encap_behavior);
+            hashValue(h, segs->num_segs);
+            hashBytes(h, segs->seg, segs->num_segs * sizeof(struct in6_addr));
+        }
+    }
+    return static_cast<size_t>(h);
+}
+
+bool equalNextHopGroupPayload(const NextHopGroupFull& a, const NextHopGroupFull& b)
+{
+    if (a.weight != b.weight || a.flags != b.flags || a.nhg_flags != b.nhg_flags ||
+        a.ifname != b.ifname || a.type != b.type || a.vrf_id != b.vrf_id ||
+        a.ifindex != b.ifindex || a.nh_label_type != b.nh_label_type) {
+        return false;
+    }
+
+    if (a.nh_grp_full_list.size() != b.nh_grp_full_list.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.nh_grp_full_list.size(); i++) {
+        const nh_grp_full& x = a.nh_grp_full_list[i];
+        const nh_grp_full& y = b.nh_grp_full_list[i];
+        if (x.id != y.id || x.weight != y.weight || x.num_direct != y.num_direct) {
+            return false;
+        }
+    }
+
+    if (a.type == NEXTHOP_TYPE_BLACKHOLE) {
+        if (a.bh_type != b.bh_type) {
+            return false;
+        }
+    } else if (memcmp(&a.gate, &b.gate, sizeof(a.gate)) != 0) {
+        return false;
+    }
+    if (memcmp(&a.src, &b.src, sizeof(a.src)) != 0 ||
+        memcmp(&a.rmap_src, &b.rmap_src, sizeof(a.rmap_src)) != 0) {
+        return false;
+    }
+
+    if ((a.nh_srv6 == nullptr) != (b.nh_srv6 == nullptr)) {
+        return false;
+    }
+    if (a.nh_srv6 == nullptr) {
+        return true;
+    }
+    if (a.nh_srv6->seg6local_action != b.nh_srv6->seg6local_action ||
+        memcmp(&a.nh_srv6->seg6local_ctx, &b.nh_srv6->seg6local_ctx, sizeof(a.nh_srv6->seg6local_ctx)) != 0 ||
+        memcmp(&a.nh_srv6->seg6_src, &b.nh_srv6->seg6_src, sizeof(a.nh_srv6->seg6_src)) != 0) {
+        return false;
+    }
+    const seg6_seg_stack* sa = a.nh_srv6->seg6_segs;
+    const seg6_seg_stack* sb = b.nh_srv6->seg6_segs;
+    if ((sa == nullptr) != (sb == nullptr)) {
+        return false;
+    }
+    return sa == nullptr ||
+           (sa->encap_behavior == sb->encap_behavior && sa->num_segs == sb->num_segs &&
+            memcmp(sa->seg, sb->seg, sa->num_segs * sizeof(struct in6_addr)) == 0);
+}
+
+/* The stored copy keeps only the payload, the identity of whoever interned it first is dropped */
+static NextHopGroupFull payloadOf(const NextHopGroupFull& nhg)
+{
+    NextHopGroupFull payload(nhg);
+    payload.id = 0;
+    payload.key = 0;
+    payload.depends.clear();
+    payload.dependents.clear();
+    return payload;
+}
+
+/*
+ * Entries are indexed by raw pointer next to a weak reference: the weak reference
+ * tells intern() whether the entry is still alive, the raw pointer lets the
+ * deleter find its own slot once the reference count has already dropped to zero.
+ */
+struct PoolSlot {
+    const InternedNextHopGroupFull* entry;
+    weak_ptr<const InternedNextHopGroupFull> ref;
+};
+
+struct NextHopGroupFullPool::State {
+    mutable mutex lock;
+    unordered_multimap<size_t, PoolSlot> by_hash;
+    unordered_map<uint32_t, PoolSlot> by_id;
+    uint32_t next_id = 1;
+
+    void release(const InternedNextHopGroupFull* entry)
+    {
+        lock_guard<mutex> guard(lock);
+        auto range = by_hash.equal_range(entry->hash());
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second.entry == entry) {
+                by_hash.erase(it);
+                break;
+            }
+        }
+        by_id.erase(entry->internId());
+    }
+
+    uint32_t allocateId()
+    {
+        /* 0 is never handed out so callers can use it as "not interned" */
+        while (next_id == 0 || by_id.count(next_id)) {
+            next_id++;
+        }
+        return next_id++;
+    }
+};
+
+NextHopGroupFullPool::NextHopGroupFullPool() : m_state(make_shared<State>())
+{
+}
+
+NextHopGroupFullPool::~NextHopGroupFullPool() = default;
+
+NextHopGroupFullRef NextHopGroupFullPool::intern(const NextHopGroupFull& nhg)
+{
+    size_t hash = hashNextHopGroupPayload(nhg);
+    lock_guard<mutex> guard(m_state->lock);
+
+    /*
+     * Compare through the raw pointer: the deleter has to take the lock before
+     * freeing an entry, so it stays valid here. Locking the weak reference only
+     * for the match also means no reference is dropped under the lock, which
+     * would run the deleter and deadlock.
+     */
+    auto range = m_state->by_hash.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (equalNextHopGroupPayload(it->second.entry->nhg(), nhg)) {
+            NextHopGroupFullRef existing = it->second.ref.lock();
+            if (existing) {
+                return existing;
+            }
+        }
+    }
+
+    /* The deleter keeps the state alive, so references may outlive the pool */
+    shared_ptr<State> state = m_state;
+    NextHopGroupFullRef ref(new InternedNextHopGroupFull(payloadOf(nhg), hash, m_state->allocateId()),
+                            [state](const InternedNextHopGroupFull* entry) {
+                                state->release(entry);
+                                delete entry;
+                            });
+    PoolSlot slot = {ref.get(), ref};
+    m_state->by_hash.emplace(hash, slot);
+    m_state->by_id.emplace(ref->internId(), slot);
+    FIB_LOG(LogLevel::DEBUG, "NextHopGroupFullPool: interned id %u as %u, %zu entries",
+            nhg.id, ref->internId(), m_state->by_id.size());
+    return ref;
+}
+
+NextHopGroupFullRef NextHopGroupFullPool::find(uint32_t intern_id) const
+{
+    lock_guard<mutex> guard(m_state->lock);
+    auto it = m_state->by_id.find(intern_id);
+    if (it == m_state->by_id.end()) {
+        return nullptr;
+    }
+    return it->second.ref.lock();
+}
+
+size_t NextHopGroupFullPool::size() const
+{
+    lock_guard<mutex> guard(m_state->lock);
+    return m_state->by_id.size();
+}
+
+} // namespace fib
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "nexthopgroupfull.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace fib {
+
+/*
+ * The payload of a group is what it forwards with: the _hash_begin.._hash_end
+ * fields (type, vrf, ifindex, label type, gateway, sources), weight, flags,
+ * ifname, the member list and the SRv6 data. The identity fields id and key and
+ * the depends/dependents bookkeeping are left out, so the same nexthop known
+ * under two NHG ids has one payload.
+ */
+bool equalNextHopGroupPayload(const NextHopGroupFull& a, const NextHopGroupFull& b);
+
+/*
+ * Hash over the payload, so groups with equal payloads always hash equal. The
+ * cost is linear in the group size; the interning pool below pays it once per
+ * stored value.
+ */
+size_t hashNextHopGroupPayload(const NextHopGroupFull& nhg);
+
+/*
+ * One stored payload shared by all of its holders. The stored group has id and
+ * key 0 and empty depends/dependents. Entries are immutable and carry their
+ * hash, computed once when they are interned.
+ */
+class InternedNextHopGroupFull {
+public:
+    InternedNextHopGroupFull(const NextHopGroupFull& nhg, size_t hash, uint32_t intern_id)
+        : m_nhg(nhg), m_hash(hash), m_intern_id(intern_id) {}
+
+    const NextHopGroupFull& nhg() const { return m_nhg; }
+    size_t hash() const { return m_hash; }
+    uint32_t internId() const { return m_intern_id; }
+
+private:
+    const NextHopGroupFull m_nhg;
+    const size_t m_hash;
+    const uint32_t m_intern_id;
+};
+
+/*
+ * A pool holds at most one entry per distinct payload, so two references from the
+ * same pool are equal exactly when they point to the same entry: comparing
+ * payloads is a pointer compare and hashing them is hash().
+ */
+using NextHopGroupFullRef = std::shared_ptr<const InternedNextHopGroupFull>;
+
+/*
+ * Deduplicating store for nexthops and nexthop groups. Identical payloads (gateway,
+ * ifindex, labels, SRv6 SIDs, members, ...) are stored once and shared through
+ * NextHopGroupFullRef, whatever NHG ids they are known under. An entry is released when its last reference is dropped,
+ * and references stay valid after the pool itself is destroyed.
+ *
+ * The pool is optional: nothing else in the library depends on it. All methods
+ * are thread safe.
+ */
+class NextHopGroupFullPool {
+public:
+    NextHopGroupFullPool();
+    ~NextHopGroupFullPool();
+
+    NextHopGroupFullPool(const NextHopGroupFullPool&) = delete;
+    NextHopGroupFullPool& operator=(const NextHopGroupFullPool&) = delete;
+
+    // Return the entry with nhg's payload, storing it if there is none yet
+    NextHopGroupFullRef intern(const NextHopGroupFull& nhg);
+
+    // Return the live entry with this intern id, or nullptr once it is released
+    NextHopGroupFullRef find(uint32_t intern_id) const;
+
+    // Number of live entries
+    size_t size() const;
+
+private:
+    struct State;
+    std::shared_ptr<State> m_state;
+};
+
+} // namespace fib
@@ -6,6 +6,7 @@
 #include <arpa/inet.h>
 
 #include <iostream>
+#include <memory>
 #include <thread>
 
 #include <unistd.h>
@@ -280,4 +281,189 @@ TEST(NextHopGroupFull_CAPI, singleton) {
     free(test_nh_srv6);
 
     cout << "TEST_NextHopGroupFull_CAPI::singleton finished." << endl;
-}
\ No newline at end of file
+}
+TEST(NextHopGroupFull_CAPI, to_json_buf) {
+    cout << "TEST_NextHopGroupFull_CAPI::to_json_buf started: "  << endl;
+    vector<fib::nh_grp_full> nh_list = {{200, 1, 0}, {300, 1, 2}};
+    fib::NextHopGroupFull nhg(100, 1234567, 1024, nh_list, {200, 300}, {500});
+
+    char* json_str = nexthopgroup_to_json(&nhg);
+    ASSERT_NE(json_str, nullptr);
+    size_t json_len = strlen(json_str);
+    EXPECT_EQ(string(json_str), fib::to_json_string(nhg));
+
+    /* Large enough buffer gets the whole string */
+    cout << "[DEBUG] Writing into a large enough buffer ..." << endl;
+    vector<char> buf(json_len + 1, 'x');
+    EXPECT_EQ(nexthopgroup_to_json_buf(&nhg, buf.data(), buf.size()), json_len);
+    EXPECT_STREQ(buf.data(), json_str);
+
+    /* Short buffer is truncated and terminated, the full length is still reported */
+    cout << "[DEBUG] Writing into a short buffer ..." << endl;
+    char small[16];
+    EXPECT_EQ(nexthopgroup_to_json_buf(&nhg, small, sizeof(small)), json_len);
+    EXPECT_EQ(string(small), string(json_str, sizeof(small) - 1));
+
+    /* Size query */
+    EXPECT_EQ(nexthopgroup_to_json_buf(&nhg, nullptr, 0), json_len);
+    EXPECT_EQ(nexthopgroup_to_json_buf(nullptr, small, sizeof(small)), 0);
+
+    free(json_str);
+    cout << "TEST_NextHopGroupFull_CAPI::to_json_buf finished." << endl;
+}
+
+/*
+ * Fill a multipath C_NextHopGroupFull with member_count members. Every third
+ * member is recursive with two resolved nexthops listed right after it.
+ */
+static uint32_t fill_large_multipath(C_NextHopGroupFull& c_nhg, uint32_t member_count,
+                                     uint32_t& depends_count, uint32_t& dependents_count)
+{
+    uint32_t nh_count = 0;
+    for (uint32_t i = 0; i < member_count && nh_count + 3 <= (MULTIPATH_NUM * MAX_NHG_RECURSION) + 1; i++) {
+        bool recursive = (i % 3 == 0);
+        c_nhg.nh_grp_full_list[nh_count].id = 1000 + i;
+        c_nhg.nh_grp_full_list[nh_count].weight = static_cast<uint16_t>(1 + i % 255);
+        c_nhg.nh_grp_full_list[nh_count].num_direct = recursive ? 2 : 0;
+        nh_count++;
+        if (recursive) {
+            for (uint32_t k = 0; k < 2; k++) {
+                c_nhg.nh_grp_full_list[nh_count].id = 100000 + i * 2 + k;
+                c_nhg.nh_grp_full_list[nh_count].weight = 1;
+                c_nhg.nh_grp_full_list[nh_count].num_direct = 0;
+                nh_count++;
+            }
+        }
+    }
+    depends_count = member_count < MULTIPATH_NUM ? member_count : MULTIPATH_NUM;
+    for (uint32_t i = 0; i < depends_count; i++) {
+        c_nhg.depends[i] = 1000 + i;
+    }
+    dependents_count = 4;
+    for (uint32_t i = 0; i < dependents_count; i++) {
+        c_nhg.dependents[i] = 900000 + i;
+    }
+    return nh_count;
+}
+
+/* Reference JSON built through an owning fib::NextHopGroupFull */
+static string owning_multipath_json(const C_NextHopGroupFull& c_nhg, uint32_t nh_count,
+                                    uint32_t depends_count, uint32_t dependents_count, bool is_recursive)
+{
+    vector<fib::nh_grp_full> nh_list;
+    for (uint32_t i = 0; i < nh_count; i++) {
+        nh_list.push_back({c_nhg.nh_grp_full_list[i].id, c_nhg.nh_grp_full_list[i].weight,
+                           c_nhg.nh_grp_full_list[i].num_direct});
+    }
+    vector<uint32_t> depends(c_nhg.depends, c_nhg.depends + depends_count);
+    vector<uint32_t> dependents(c_nhg.dependents, c_nhg.dependents + dependents_count);
+    if (is_recursive) {
+        fib::NextHopGroupFull nhg(c_nhg.id, c_nhg.key, c_nhg.nhg_flags,
+                                  reinterpret_cast<const fib::g_addr&>(c_nhg.gate),
+                                  static_cast<fib::nexthop_types_t>(c_nhg.type),
+                                  nh_list, depends, dependents);
+        return fib::to_json_string(nhg);
+    }
+    fib::NextHopGroupFull nhg(c_nhg.id, c_nhg.key, c_nhg.nhg_flags, nh_list, depends, dependents);
+    return fib::to_json_string(nhg);
+}
+
+TEST(NextHopGroupFull_CAPI, large_multipath) {
+    cout << "TEST_NextHopGroupFull_CAPI::large_multipath started:" << endl;
+    unique_ptr<C_NextHopGroupFull> c_nhg(new C_NextHopGroupFull());
+    c_nhg->id = 4242;
+    c_nhg->key = 0xdeadbeef;
+    c_nhg->nhg_flags = 0x11;
+    /* Fields the multipath constructors ignore must not leak into the JSON */
+    c_nhg->weight = 77;
+    c_nhg->vrf_id = 5;
+    c_nhg->nh_label_type = C_ZEBRA_LSP_BGP;
+
+    for (uint32_t members : {128u, 256u, static_cast<uint32_t>(MULTIPATH_NUM)}) {
+        uint32_t depends_count = 0;
+        uint32_t dependents_count = 0;
+        memset(c_nhg->nh_grp_full_list, 0, sizeof(c_nhg->nh_grp_full_list));
+        uint32_t nh_count = fill_large_multipath(*c_nhg, members, depends_count, dependents_count);
+        cout << "[DEBUG] " << members << " members, " << nh_count << " nh_grp_full entries" << endl;
+
+        char* json_str = nexthopgroupfull_json_from_c_nhg_multi(c_nhg.get(), nh_count,
+                                                               depends_count, dependents_count, false);
+        ASSERT_NE(json_str, nullptr);
+        EXPECT_EQ(string(json_str),
+                  owning_multipath_json(*c_nhg, nh_count, depends_count, dependents_count, false));
+
+        /* Parse back and check the members */
+        fib::NextHopGroupFull parsed;
+        string parsed_str(json_str);
+        ASSERT_TRUE(fib::from_json_string(parsed_str, parsed));
+        ASSERT_EQ(parsed.nh_grp_full_list.size(), nh_count);
+        EXPECT_EQ(parsed.nh_grp_full_list[nh_count - 1].id, c_nhg->nh_grp_full_list[nh_count - 1].id);
+        EXPECT_EQ(parsed.depends.size(), depends_count);
+        EXPECT_EQ(parsed.weight, 0);
+        free(json_str);
+    }
+
+    /* Recursive group with an IPv4 gateway */
+    cout << "[DEBUG] Recursive large multipath ..." << endl;
+    uint32_t depends_count = 0;
+    uint32_t dependents_count = 0;
+    uint32_t nh_count = fill_large_multipath(*c_nhg, 128, depends_count, dependents_count);
+    c_nhg->type = C_NEXTHOP_TYPE_IPV4;
+    inet_pton(AF_INET, "10.10.10.1", &c_nhg->gate.ipv4);
+    char* json_str = nexthopgroupfull_json_from_c_nhg_multi(c_nhg.get(), nh_count,
+                                                           depends_count, dependents_count, true);
+    ASSERT_NE(json_str, nullptr);
+    EXPECT_EQ(string(json_str),
+              owning_multipath_json(*c_nhg, nh_count, depends_count, dependents_count, true));
+    free(json_str);
+
+    /* Counts beyond the C arrays are rejected */
+    EXPECT_EQ(nexthopgroupfull_json_from_c_nhg_multi(c_nhg.get(), (MULTIPATH_NUM * MAX_NHG_RECURSION) + 2,
+                                                     0, 0, false), nullptr);
+    EXPECT_EQ(nexthopgroupfull_json_from_c_nhg_multi(c_nhg.get(), 0, MULTIPATH_NUM + 2, 0, false), nullptr);
+
+    cout << "TEST_NextHopGroupFull_CAPI::large_multipath finished." << endl;
+}
+
+TEST(NextHopGroupFull_CAPI, singleton_matches_owning_path) {
+    cout << "TEST_NextHopGroupFull_CAPI::singleton_matches_owning_path started:" << endl;
+    unique_ptr<C_NextHopGroupFull> c_nhg(new C_NextHopGroupFull());
+    c_nhg->id = 7;
+    c_nhg->key = 8;
+    c_nhg->type = C_NEXTHOP_TYPE_IPV4_IFINDEX;
+    c_nhg->vrf_id = 3;
+    c_nhg->ifindex = 12;
+    c_nhg->weight = 2;
+    c_nhg->flags = 1;
+    inet_pton(AF_INET, "10.0.0.1", &c_nhg->gate.ipv4);
+    inet_pton(AF_INET, "10.0.0.2", &c_nhg->src.ipv4);
+    for (uint32_t i = 0; i < MULTIPATH_NUM; i++) {
+        c_nhg->depends[i] = i + 1;
+    }
+    c_nhg->dependents[0] = 99;
+
+    struct C_nexthop_srv6 srv6 = {};
+    srv6.seg6local_action = C_SEG6_LOCAL_ACTION_END_DT4;
+    srv6.seg6local_ctx.table = 10;
+
+    for (bool with_srv6 : {false, true}) {
+        c_nhg->nh_srv6 = with_srv6 ? &srv6 : nullptr;
+        char* json_str = nexthopgroupfull_json_from_c_nhg_singleton(c_nhg.get(), MULTIPATH_NUM, 1);
+        ASSERT_NE(json_str, nullptr);
+
+        vector<uint32_t> depends(c_nhg->depends, c_nhg->depends + MULTIPATH_NUM);
+        fib::NextHopGroupFull nhg(c_nhg->id, c_nhg->key, fib::NEXTHOP_TYPE_IPV4_IFINDEX,
+                                  c_nhg->vrf_id, static_cast<fib::ifindex_t>(c_nhg->ifindex), "",
+                                  depends, {99}, fib::ZEBRA_LSP_NONE, fib::BLACKHOLE_UNSPEC,
+                                  reinterpret_cast<const fib::g_addr&>(c_nhg->gate),
+                                  reinterpret_cast<const fib::g_addr&>(c_nhg->src),
+                                  reinterpret_cast<const fib::g_addr&>(c_nhg->rmap_src),
+                                  c_nhg->weight, c_nhg->flags, c_nhg->nhg_flags, with_srv6, false,
+                                  reinterpret_cast<const fib::nexthop_srv6*>(c_nhg->nh_srv6),
+                                  nullptr, {});
+        EXPECT_EQ(string(json_str), fib::to_json_string(nhg));
+        free(json_str);
+    }
+
+    cout << "TEST_NextHopGroupFull_CAPI::singleton_matches_owning_path finished." << endl;
+}
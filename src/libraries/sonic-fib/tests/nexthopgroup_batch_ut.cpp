@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "src/c-api/nexthopgroup_capi.h"
+#include "src/nexthopgroupfull.h"
+#include "src/nexthopgroupfull_json.h"
+#include "src/nexthopgroupfull_binary.h"
+#include "src/nexthopgroup_batch.h"
+#include "src/c_nexthopgroupfull.h"
+
+using namespace std;
+
+/* A mixed batch: multipath, recursive multipath and SRv6 singleton groups */
+class NextHopGroupBatch : public ::testing::Test {
+protected:
+    void SetUp() override {
+        multi.reset(new C_NextHopGroupFull());
+        multi->id = 100;
+        multi->key = 1;
+        multi->nhg_flags = 2;
+        for (uint32_t i = 0; i < 64; i++) {
+            multi->nh_grp_full_list[i].id = 1000 + i;
+            multi->nh_grp_full_list[i].weight = static_cast<uint16_t>(i + 1);
+            multi->depends[i] = 1000 + i;
+        }
+        multi->dependents[0] = 7;
+
+        recursive.reset(new C_NextHopGroupFull());
+        recursive->id = 101;
+        recursive->type = C_NEXTHOP_TYPE_IPV4;
+        inet_pton(AF_INET, "10.1.1.1", &recursive->gate.ipv4);
+        recursive->nh_grp_full_list[0].id = 1000;
+        recursive->nh_grp_full_list[0].num_direct = 1;
+        recursive->nh_grp_full_list[1].id = 1001;
+
+        singleton.reset(new C_NextHopGroupFull());
+        singleton->id = 1000;
+        singleton->key = 1000;
+        singleton->type = C_NEXTHOP_TYPE_IPV6_IFINDEX;
+        singleton->ifindex = 12;
+        singleton->weight = 3;
+        inet_pton(AF_INET6, "2001:db8::1", &singleton->gate.ipv6);
+        singleton->depends[0] = 100;
+        srv6.seg6local_action = C_SEG6_LOCAL_ACTION_END_DT6;
+        srv6.seg6local_ctx.table = 100;
+        inet_pton(AF_INET6, "fc00::1", &srv6.seg6_src);
+        segs.reset(static_cast<C_seg6_seg_stack*>(
+            malloc(sizeof(C_seg6_seg_stack) + 2 * sizeof(struct in6_addr))));
+        segs->encap_behavior = C_SRV6_HEADEND_BEHAVIOR_H_ENCAPS;
+        segs->num_segs = 2;
+        inet_pton(AF_INET6, "2001:db8:1::1", &segs->seg[0]);
+        inet_pton(AF_INET6, "2001:db8:1::2", &segs->seg[1]);
+        srv6.seg6_segs = segs.get();
+        singleton->nh_srv6 = &srv6;
+
+        items = {
+            {multi.get(), 64, 64, 1, false, false},
+            {recursive.get(), 2, 0, 0, false, true},
+            {singleton.get(), 0, 1, 0, true, false},
+        };
+    }
+
+    /* Single item conversions of items[i], the reference for the batch output */
+    string single_json(size_t i) {
+        const C_NextHopGroupFullBatchItem& item = items[i];
+        char* json_str = item.is_singleton
+            ? nexthopgroupfull_json_from_c_nhg_singleton(item.c_nhg, item.depends_count, item.dependents_count)
+            : nexthopgroupfull_json_from_c_nhg_multi(item.c_nhg, item.nh_grp_full_count, item.depends_count,
+                                                     item.dependents_count, item.is_recursive);
+        EXPECT_NE(json_str, nullptr);
+        string ret(json_str ? json_str : "");
+        free(json_str);
+        return ret;
+    }
+
+    struct FreeDeleter { void operator()(void* p) const { free(p); } };
+    unique_ptr<C_NextHopGroupFull> multi;
+    unique_ptr<C_NextHopGroupFull> recursive;
+    unique_ptr<C_NextHopGroupFull> singleton;
+    C_nexthop_srv6 srv6 = {};
+    unique_ptr<C_seg6_seg_stack, FreeDeleter> segs;
+    vector<C_NextHopGroupFullBatchItem> items;
+};
+
+TEST_F(NextHopGroupBatch, json_matches_single_items)
+{
+    cout << "TEST_NextHopGroupBatch::json_matches_single_items started:" << endl;
+    size_t len = 0;
+    char* batch = nexthopgroupfull_batch_from_c_nhg(items.data(), static_cast<uint32_t>(items.size()),
+                                                    NHG_BATCH_FORMAT_JSON, &len);
+    ASSERT_NE(batch, nullptr);
+    EXPECT_EQ(strlen(batch), len);
+
+    string expected;
+    for (size_t i = 0; i < items.size(); i++) {
+        expected += single_json(i) + "\n";
+    }
+    EXPECT_EQ(string(batch, len), expected);
+
+    /* Decode back */
+    cout << "[DEBUG] Decoding the JSON batch ..." << endl;
+    uint32_t count = 0;
+    fib::NextHopGroupFull** objs = nexthopgroup_batch_decode(batch, len, NHG_BATCH_FORMAT_JSON, &count);
+    ASSERT_NE(objs, nullptr);
+    ASSERT_EQ(count, items.size());
+    for (uint32_t i = 0; i < count; i++) {
+        char* json_str = nexthopgroup_to_json(objs[i]);
+        ASSERT_NE(json_str, nullptr);
+        EXPECT_EQ(string(json_str), single_json(i));
+        free(json_str);
+    }
+    EXPECT_EQ(objs[2]->nh_srv6->seg6_segs->num_segs, 2);
+    nexthopgroup_batch_free(objs, count);
+    free(batch);
+
+    cout << "TEST_NextHopGroupBatch::json_matches_single_items finished." << endl;
+}
+
+TEST_F(NextHopGroupBatch, binary_round_trip)
+{
+    cout << "TEST_NextHopGroupBatch::binary_round_trip started:" << endl;
+    size_t json_len = 0;
+    size_t bin_len = 0;
+    char* json_batch = nexthopgroupfull_batch_from_c_nhg(items.data(), static_cast<uint32_t>(items.size()),
+                                                         NHG_BATCH_FORMAT_JSON, &json_len);
+    char* bin_batch = nexthopgroupfull_batch_from_c_nhg(items.data(), static_cast<uint32_t>(items.size()),
+                                                        NHG_BATCH_FORMAT_BINARY, &bin_len);
+    ASSERT_NE(json_batch, nullptr);
+    ASSERT_NE(bin_batch, nullptr);
+    cout << "    [DEBUG] json batch " << json_len << " bytes, binary batch " << bin_len << " bytes" << endl;
+    EXPECT_LT(bin_len, json_len);
+
+    vector<fib::NextHopGroupFull> from_json;
+    vector<fib::NextHopGroupFull> from_bin;
+    ASSERT_TRUE(fib::decodeBatch(json_batch, json_len, fib::BatchFormat::JSON, from_json));
+    ASSERT_TRUE(fib::decodeBatch(bin_batch, bin_len, fib::BatchFormat::BINARY, from_bin));
+    ASSERT_EQ(from_bin.size(), items.size());
+    ASSERT_EQ(from_json.size(), items.size());
+    for (size_t i = 0; i < items.size(); i++) {
+        EXPECT_TRUE(from_bin[i] == from_json[i]) << "group " << i;
+    }
+
+    /* Decoding into heap objects gives the same groups */
+    vector<unique_ptr<fib::NextHopGroupFull>> bin_objs;
+    ASSERT_TRUE(fib::decodeBatch(bin_batch, bin_len, fib::BatchFormat::BINARY, bin_objs));
+    ASSERT_EQ(bin_objs.size(), items.size());
+    for (size_t i = 0; i < items.size(); i++) {
+        EXPECT_TRUE(*bin_objs[i] == from_json[i]) << "group " << i;
+    }
+
+    /* Truncated binary batch keeps the complete records and reports the failure */
+    cout << "[DEBUG] Decoding a truncated binary batch ..." << endl;
+    vector<fib::NextHopGroupFull> partial;
+    EXPECT_FALSE(fib::decodeBatch(bin_batch, bin_len - 1, fib::BatchFormat::BINARY, partial));
+    EXPECT_EQ(partial.size(), items.size() - 1);
+    uint32_t count = 0;
+    EXPECT_EQ(nexthopgroup_batch_decode(bin_batch, bin_len - 1, NHG_BATCH_FORMAT_BINARY, &count), nullptr);
+    EXPECT_EQ(count, 0);
+
+    free(json_batch);
+    free(bin_batch);
+    cout << "TEST_NextHopGroupBatch::binary_round_trip finished." << endl;
+}
+
+TEST_F(NextHopGroupBatch, encode_appends)
+{
+    cout << "TEST_NextHopGroupBatch::encode_appends started:" << endl;
+    vector<fib::nh_grp_full> nh_list = {{200, 1, 0}, {300, 1, 2}};
+    fib::NextHopGroupFull nhg(100, 1234567, 1024, nh_list, {200, 300}, {500});
+    vector<fib::NextHopGroupFullView> views(2, fib::make_view(nhg));
+
+    string out = "prefix\n";
+    fib::encodeBatch(views.data(), views.size(), fib::BatchFormat::JSON, out);
+    string line = fib::to_json_string(nhg);
+    EXPECT_EQ(out, "prefix\n" + line + "\n" + line + "\n");
+
+    /* Empty lines are skipped, garbage is rejected */
+    vector<fib::NextHopGroupFull> decoded;
+    string with_blank = "\n" + line + "\n\n";
+    EXPECT_TRUE(fib::decodeBatch(with_blank.data(), with_blank.size(), fib::BatchFormat::JSON, decoded));
+    EXPECT_EQ(decoded.size(), 1);
+    string garbage = line + "\n{not json\n";
+    decoded.clear();
+    EXPECT_FALSE(fib::decodeBatch(garbage.data(), garbage.size(), fib::BatchFormat::JSON, decoded));
+    EXPECT_EQ(decoded.size(), 1);
+
+    cout << "TEST_NextHopGroupBatch::encode_appends finished." << endl;
+}
+
+TEST_F(NextHopGroupBatch, reject_invalid)
+{
+    cout << "TEST_NextHopGroupBatch::reject_invalid started:" << endl;
+    size_t len = 0;
+    EXPECT_EQ(nexthopgroupfull_batch_from_c_nhg(items.data(), 1, 5, &len), nullptr);
+    EXPECT_EQ(nexthopgroupfull_batch_from_c_nhg(nullptr, 1, NHG_BATCH_FORMAT_JSON, &len), nullptr);
+
+    /* One bad item fails the whole batch */
+    items[1].nh_grp_full_count = (MULTIPATH_NUM * MAX_NHG_RECURSION) + 2;
+    EXPECT_EQ(nexthopgroupfull_batch_from_c_nhg(items.data(), static_cast<uint32_t>(items.size()),
+                                                NHG_BATCH_FORMAT_JSON, &len), nullptr);
+    items[1].c_nhg = nullptr;
+    EXPECT_EQ(nexthopgroupfull_batch_from_c_nhg(items.data(), static_cast<uint32_t>(items.size()),
+                                                NHG_BATCH_FORMAT_BINARY, &len), nullptr);
+
+    /* An empty batch is an empty string */
+    char* empty = nexthopgroupfull_batch_from_c_nhg(nullptr, 0, NHG_BATCH_FORMAT_JSON, &len);
+    ASSERT_NE(empty, nullptr);
+    EXPECT_EQ(len, 0);
+    EXPECT_STREQ(empty, "");
+    free(empty);
+
+    cout << "TEST_NextHopGroupBatch::reject_invalid finished." << endl;
+}
@@ -0,0 +1,496 @@
+/*
+ * Microbenchmarks for the sonic-fib serialization paths.
+ *
+ * Every case serializes, parses or compares one route's worth of nexthop
+ * groups: N singleton members plus the multipath group that references them. Results are
+ * reported per operation as wall-clock ns and heap allocations. Allocations are
+ * counted by interposing malloc, so the C API buffers are included as well as
+ * operator new.
+ *
+ * Usage: nexthopgroup_bench [--min-time-ms N] [filter]
+ *   --min-time-ms N   minimum measuring time per case (default 50)
+ *   filter            only run cases whose name contains this substring
+ */
+#include <arpa/inet.h>
+#include <inttypes.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/c-api/nexthopgroup_capi.h"
+#include "src/nexthopgroupfull.h"
+#include "src/nexthopgroupfull_json.h"
+#include "src/nexthopgroupfull_binary.h"
+#include "src/nexthopgroup_debug.h"
+#include "src/nexthopgroup_intern.h"
+#include "src/c_nexthopgroupfull.h"
+
+using namespace std;
+
+/* ======== Allocation counting ========
+ * glibc exports its allocator as __libc_*, so the definitions below interpose
+ * malloc for the whole process, including libnexthopgroup and libstdc++.
+ */
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t nmemb, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+}
+
+static uint64_t g_alloc_count = 0;
+
+extern "C" void* malloc(size_t size) noexcept
+{
+    g_alloc_count++;
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t nmemb, size_t size) noexcept
+{
+    g_alloc_count++;
+    return __libc_calloc(nmemb, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) noexcept
+{
+    g_alloc_count++;
+    return __libc_realloc(ptr, size);
+}
+
+extern "C" void free(void* ptr) noexcept
+{
+    __libc_free(ptr);
+}
+
+/* Keeps the optimizer from discarding results that are otherwise unused */
+static volatile size_t g_sink = 0;
+
+/* ======== Runner ======== */
+struct BenchResult {
+    uint64_t iters;
+    double ns_per_op;
+    double allocs_per_op;
+};
+
+template <typename Fn>
+static BenchResult run_case(Fn& fn, uint64_t min_ns)
+{
+    using clock = chrono::steady_clock;
+
+    fn(); /* warm up caches and thread local buffers */
+    uint64_t iters = 1;
+    for (;;) {
+        uint64_t allocs_before = g_alloc_count;
+        auto start = clock::now();
+        for (uint64_t i = 0; i < iters; i++) {
+            fn();
+        }
+        auto elapsed = static_cast<uint64_t>(
+            chrono::duration_cast<chrono::nanoseconds>(clock::now() - start).count());
+        uint64_t allocs = g_alloc_count - allocs_before;
+
+        if (elapsed >= min_ns || iters >= (1ULL << 32)) {
+            BenchResult res;
+            res.iters = iters;
+            res.ns_per_op = static_cast<double>(elapsed) / static_cast<double>(iters);
+            res.allocs_per_op = static_cast<double>(allocs) / static_cast<double>(iters);
+            return res;
+        }
+        /* Aim 20% past the target so the next round usually finishes it */
+        uint64_t next = elapsed ? (min_ns + min_ns / 5) * iters / elapsed : iters * 100;
+        iters = next > iters * 100 ? iters * 100 : (next > iters * 2 ? next : iters * 2);
+    }
+}
+
+/* ======== Scenarios ======== */
+enum class Family { IPV4, IPV6, SRV6 };
+
+static const char* family_name(Family family)
+{
+    switch (family) {
+    case Family::IPV4:
+        return "ipv4";
+    case Family::IPV6:
+        return "ipv6";
+    case Family::SRV6:
+        return "srv6";
+    default:
+        return "unknown";
+    }
+}
+
+static const uint8_t BENCH_NUM_SEGS = 3;
+
+/* One route: size singleton members and the multipath group over them */
+struct Scenario {
+    Family family;
+    uint32_t size;
+
+    vector<fib::NextHopGroupFull> members;
+    fib::NextHopGroupFull group;
+    vector<string> member_json;
+    string group_json;
+    vector<string> member_binary;
+    string group_binary;
+
+    vector<unique_ptr<C_NextHopGroupFull>> c_members;
+    unique_ptr<C_NextHopGroupFull> c_group;
+    C_nexthop_srv6 c_srv6;
+    C_seg6_seg_stack* c_segs = nullptr;
+    vector<C_NextHopGroupFullBatchItem> batch_items;
+
+    Scenario() : c_srv6() {}
+    ~Scenario() { free(c_segs); }
+    Scenario(const Scenario&) = delete;
+    Scenario& operator=(const Scenario&) = delete;
+};
+
+static void member_addresses(Family family, uint32_t index, union fib::g_addr& gate, union fib::g_addr& src)
+{
+    memset(&gate, 0, sizeof(gate));
+    memset(&src, 0, sizeof(src));
+    if (family == Family::IPV4) {
+        gate.ipv4.s_addr = htonl(0x0a000000 + index + 1);
+        src.ipv4.s_addr = htonl(0x0a010000 + index + 1);
+        return;
+    }
+    inet_pton(AF_INET6, "2001:db8::", &gate.ipv6);
+    inet_pton(AF_INET6, "2001:db8:ffff::1", &src.ipv6);
+    gate.ipv6.s6_addr[14] = static_cast<uint8_t>((index + 1) >> 8);
+    gate.ipv6.s6_addr[15] = static_cast<uint8_t>(index + 1);
+}
+
+static void build_scenario(Scenario& sc, Family family, uint32_t size)
+{
+    sc.family = family;
+    sc.size = size;
+
+    /* SRv6 context shared by every member of an SRv6 route */
+    vector<struct in6_addr> segs(BENCH_NUM_SEGS);
+    for (uint8_t i = 0; i < BENCH_NUM_SEGS; i++) {
+        inet_pton(AF_INET6, "fcbb:bbbb::", &segs[i]);
+        segs[i].s6_addr[5] = static_cast<uint8_t>(i + 1);
+    }
+    size_t segs_size = sizeof(fib::seg6_seg_stack) + segs.size() * sizeof(struct in6_addr);
+    unique_ptr<fib::seg6_seg_stack, void (*)(void*)> nh_segs(
+        static_cast<fib::seg6_seg_stack*>(malloc(segs_size)), free);
+    nh_segs->encap_behavior = fib::SRV6_HEADEND_BEHAVIOR_H_ENCAPS_RED;
+    nh_segs->num_segs = BENCH_NUM_SEGS;
+    memcpy(nh_segs->seg, segs.data(), segs.size() * sizeof(struct in6_addr));
+
+    fib::nexthop_srv6 nh_srv6 = {};
+    nh_srv6.seg6local_action = fib::SEG6_LOCAL_ACTION_UNSPEC;
+    inet_pton(AF_INET6, "fc00::1", &nh_srv6.seg6_src);
+
+    sc.c_segs = static_cast<C_seg6_seg_stack*>(malloc(segs_size));
+    sc.c_segs->encap_behavior = C_SRV6_HEADEND_BEHAVIOR_H_ENCAPS_RED;
+    sc.c_segs->num_segs = BENCH_NUM_SEGS;
+    memcpy(sc.c_segs->seg, segs.data(), segs.size() * sizeof(struct in6_addr));
+    sc.c_srv6.seg6local_action = C_SEG6_LOCAL_ACTION_UNSPEC;
+    sc.c_srv6.seg6_src = nh_srv6.seg6_src;
+    sc.c_srv6.seg6_segs = sc.c_segs;
+
+    bool srv6 = (family == Family::SRV6);
+    fib::nexthop_types_t type = (family == Family::IPV4) ? fib::NEXTHOP_TYPE_IPV4_IFINDEX
+                                                         : fib::NEXTHOP_TYPE_IPV6_IFINDEX;
+    uint32_t group_id = 100000;
+    vector<fib::nh_grp_full> nh_list;
+    vector<uint32_t> depends;
+
+    for (uint32_t i = 0; i < size; i++) {
+        uint32_t id = 1000 + i;
+        union fib::g_addr gate, src, rmap_src;
+        member_addresses(family, i, gate, src);
+        memset(&rmap_src, 0, sizeof(rmap_src));
+        uint32_t ifindex = 10 + i;
+        string ifname = "Ethernet" + to_string(i * 4);
+
+        sc.members.emplace_back(id, id, type, 0, ifindex, ifname,
+                                vector<uint32_t>{}, vector<uint32_t>{group_id},
+                                fib::ZEBRA_LSP_NONE, fib::BLACKHOLE_UNSPEC,
+                                gate, src, rmap_src, 1, 0, 0,
+                                srv6, srv6, srv6 ? &nh_srv6 : nullptr,
+                                srv6 ? nh_segs.get() : nullptr, srv6 ? segs : vector<struct in6_addr>{});
+        nh_list.push_back({id, 1, 0});
+        depends.push_back(id);
+
+        unique_ptr<C_NextHopGroupFull> c_nhg(new C_NextHopGroupFull());
+        c_nhg->id = id;
+        c_nhg->key = id;
+        c_nhg->type = static_cast<C_nexthop_types_t>(type);
+        c_nhg->ifindex = ifindex;
+        c_nhg->weight = 1;
+        memcpy(&c_nhg->gate, &gate, sizeof(c_nhg->gate));
+        memcpy(&c_nhg->src, &src, sizeof(c_nhg->src));
+        c_nhg->dependents[0] = group_id;
+        c_nhg->nh_srv6 = srv6 ? &sc.c_srv6 : nullptr;
+        sc.c_members.push_back(move(c_nhg));
+    }
+
+    sc.group = fib::NextHopGroupFull(group_id, group_id, 0, nh_list, depends, {});
+    sc.c_group.reset(new C_NextHopGroupFull());
+    sc.c_group->id = group_id;
+    sc.c_group->key = group_id;
+    for (uint32_t i = 0; i < size; i++) {
+        sc.c_group->nh_grp_full_list[i].id = nh_list[i].id;
+        sc.c_group->nh_grp_full_list[i].weight = nh_list[i].weight;
+        sc.c_group->depends[i] = depends[i];
+    }
+
+    for (auto& c_nhg : sc.c_members) {
+        C_NextHopGroupFullBatchItem item = {};
+        item.c_nhg = c_nhg.get();
+        item.dependents_count = 1;
+        item.is_singleton = true;
+        sc.batch_items.push_back(item);
+    }
+    C_NextHopGroupFullBatchItem group_item = {};
+    group_item.c_nhg = sc.c_group.get();
+    group_item.nh_grp_full_count = size;
+    group_item.depends_count = size;
+    sc.batch_items.push_back(group_item);
+
+    for (auto& member : sc.members) {
+        sc.member_json.push_back(fib::to_json_string(member));
+        sc.member_binary.push_back(fib::to_binary_string(member));
+    }
+    sc.group_json = fib::to_json_string(sc.group);
+    sc.group_binary = fib::to_binary_string(sc.group);
+}
+
+/* Parses a JSON string into a fresh object with zeroed addresses */
+static bool parse_json(const char* json_str, fib::NextHopGroupFull& parsed)
+{
+    memset(&parsed.gate, 0, sizeof(parsed.gate));
+    memset(&parsed.src, 0, sizeof(parsed.src));
+    memset(&parsed.rmap_src, 0, sizeof(parsed.rmap_src));
+    string str(json_str);
+    return fib::from_json_string(str, parsed);
+}
+
+/*
+ * Checks the fixtures once so a broken conversion fails instead of timing
+ * garbage. The C struct carries no ifname, so C API output is only checked to
+ * parse back with the same members.
+ */
+static bool verify_scenario(Scenario& sc)
+{
+    for (uint32_t i = 0; i < sc.size; i++) {
+        fib::NextHopGroupFull parsed;
+        if (!parse_json(sc.member_json[i].c_str(), parsed) || parsed != sc.members[i]) {
+            return false;
+        }
+        char* json_str = nexthopgroupfull_json_from_c_nhg_singleton(sc.c_members[i].get(), 0, 1);
+        fib::NextHopGroupFull from_c;
+        bool ok = json_str && parse_json(json_str, from_c) &&
+                  !memcmp(&from_c.gate, &sc.members[i].gate, sizeof(from_c.gate));
+        free(json_str);
+        if (!ok) {
+            return false;
+        }
+    }
+    char* json_str = nexthopgroupfull_json_from_c_nhg_multi(sc.c_group.get(), sc.size, sc.size, 0, false);
+    bool same = json_str && sc.group_json == json_str;
+    free(json_str);
+    return same;
+}
+
+/* ======== Cases ======== */
+struct BenchContext {
+    uint64_t min_ns;
+    const char* filter;
+    int failures;
+};
+
+template <typename Fn>
+static void bench(BenchContext& ctx, const Scenario& sc, const char* op, Fn fn)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "%s/%s/%" PRIu32, op, family_name(sc.family), sc.size);
+    if (ctx.filter && !strstr(name, ctx.filter)) {
+        return;
+    }
+    BenchResult res = run_case(fn, ctx.min_ns);
+    printf("%-28s %12" PRIu64 " %14.1f %12.2f\n", name, res.iters, res.ns_per_op, res.allocs_per_op);
+    fflush(stdout);
+}
+
+static void run_scenario(BenchContext& ctx, Scenario& sc)
+{
+    bench(ctx, sc, "to_json", [&sc]() {
+        for (auto& member : sc.members) {
+            g_sink += fib::to_json_string(member).size();
+        }
+        g_sink += fib::to_json_string(sc.group).size();
+    });
+
+    string out;
+    bench(ctx, sc, "to_json_buffer", [&sc, &out]() {
+        for (auto& member : sc.members) {
+            fib::to_json_buffer(member, out);
+            g_sink += out.size();
+        }
+        fib::to_json_buffer(sc.group, out);
+        g_sink += out.size();
+    });
+
+    bench(ctx, sc, "from_json", [&sc]() {
+        for (auto& json_str : sc.member_json) {
+            fib::NextHopGroupFull parsed;
+            g_sink += fib::from_json_string(json_str, parsed);
+        }
+        fib::NextHopGroupFull parsed;
+        g_sink += fib::from_json_string(sc.group_json, parsed);
+    });
+
+    bench(ctx, sc, "to_binary", [&sc, &out]() {
+        for (auto& member : sc.members) {
+            out.clear();
+            fib::append_binary(out, fib::make_view(member));
+            g_sink += out.size();
+        }
+        out.clear();
+        fib::append_binary(out, fib::make_view(sc.group));
+        g_sink += out.size();
+    });
+
+    bench(ctx, sc, "from_binary", [&sc]() {
+        for (auto& bin : sc.member_binary) {
+            fib::NextHopGroupFull parsed;
+            g_sink += fib::from_binary_string(bin, parsed);
+        }
+        fib::NextHopGroupFull parsed;
+        g_sink += fib::from_binary_string(sc.group_binary, parsed);
+    });
+
+    /* Change detection: walking every field vs. comparing interned references */
+    vector<fib::NextHopGroupFull> copies(sc.members);
+    fib::NextHopGroupFull group_copy(sc.group);
+    bench(ctx, sc, "compare", [&sc, &copies, &group_copy]() {
+        for (size_t i = 0; i < copies.size(); i++) {
+            g_sink += (sc.members[i] == copies[i]);
+        }
+        g_sink += (sc.group == group_copy);
+    });
+
+    fib::NextHopGroupFullPool pool;
+    vector<fib::NextHopGroupFullRef> refs;
+    for (auto& member : sc.members) {
+        refs.push_back(pool.intern(member));
+    }
+    refs.push_back(pool.intern(sc.group));
+    bench(ctx, sc, "intern", [&sc, &pool]() {
+        for (auto& member : sc.members) {
+            g_sink += pool.intern(member)->internId();
+        }
+        g_sink += pool.intern(sc.group)->internId();
+    });
+
+    vector<fib::NextHopGroupFullRef> copy_refs;
+    for (auto& member : copies) {
+        copy_refs.push_back(pool.intern(member));
+    }
+    copy_refs.push_back(pool.intern(group_copy));
+    bench(ctx, sc, "compare_interned", [&refs, &copy_refs]() {
+        for (size_t i = 0; i < refs.size(); i++) {
+            g_sink += (refs[i] == copy_refs[i]);
+        }
+    });
+
+    bench(ctx, sc, "capi_from_c_nhg", [&sc]() {
+        for (auto& c_nhg : sc.c_members) {
+            char* json_str = nexthopgroupfull_json_from_c_nhg_singleton(c_nhg.get(), 0, 1);
+            g_sink += strlen(json_str);
+            free(json_str);
+        }
+        char* json_str = nexthopgroupfull_json_from_c_nhg_multi(sc.c_group.get(), sc.size, sc.size, 0, false);
+        g_sink += strlen(json_str);
+        free(json_str);
+    });
+
+    bench(ctx, sc, "capi_batch", [&sc]() {
+        size_t len = 0;
+        char* buf = nexthopgroupfull_batch_from_c_nhg(sc.batch_items.data(),
+                                                      static_cast<uint32_t>(sc.batch_items.size()),
+                                                      NHG_BATCH_FORMAT_JSON, &len);
+        g_sink += len;
+        free(buf);
+    });
+
+    bench(ctx, sc, "capi_to_json", [&sc]() {
+        for (auto& member : sc.members) {
+            char* json_str = nexthopgroup_to_json(&member);
+            g_sink += strlen(json_str);
+            free(json_str);
+        }
+        char* json_str = nexthopgroup_to_json(&sc.group);
+        g_sink += strlen(json_str);
+        free(json_str);
+    });
+
+    vector<char> buf(sc.group_json.size() + 1024);
+    bench(ctx, sc, "capi_to_json_buf", [&sc, &buf]() {
+        for (auto& member : sc.members) {
+            g_sink += nexthopgroup_to_json_buf(&member, buf.data(), buf.size());
+        }
+        g_sink += nexthopgroup_to_json_buf(&sc.group, buf.data(), buf.size());
+    });
+
+    bench(ctx, sc, "debug_strings", [&sc]() {
+        for (auto& member : sc.members) {
+            g_sink += fib::gaddr_to_string(member.gate, member.type).size();
+            g_sink += fib::gaddr_to_string(member.src, member.type).size();
+            if (member.nh_srv6 && member.nh_srv6->seg6_segs) {
+                for (uint8_t i = 0; i < member.nh_srv6->seg6_segs->num_segs; i++) {
+                    g_sink += fib::ipv6_to_string(member.nh_srv6->seg6_segs->seg[i]).size();
+                }
+            }
+        }
+    });
+}
+
+int main(int argc, char** argv)
+{
+    BenchContext ctx;
+    ctx.min_ns = 50ULL * 1000 * 1000;
+    ctx.filter = nullptr;
+    ctx.failures = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--min-time-ms") && i + 1 < argc) {
+            ctx.min_ns = strtoull(argv[++i], nullptr, 10) * 1000 * 1000;
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "usage: %s [--min-time-ms N] [filter]\n", argv[0]);
+            return 2;
+        } else {
+            ctx.filter = argv[i];
+        }
+    }
+
+    /* Keep library logging out of the measurements */
+    fib::setLogLevel(fib::LogLevel::ERROR);
+
+    printf("# one op = N singleton members + their multipath group, allocs counted at malloc\n");
+    printf("%-28s %12s %14s %12s\n", "case", "iters", "ns/op", "allocs/op");
+
+    const Family families[] = {Family::IPV4, Family::IPV6, Family::SRV6};
+    const uint32_t sizes[] = {1, 8, 64, 512};
+    for (Family family : families) {
+        for (uint32_t size : sizes) {
+            Scenario sc;
+            build_scenario(sc, family, size);
+            if (!verify_scenario(sc)) {
+                fprintf(stderr, "fixture check failed for %s/%" PRIu32 "\n", family_name(family), size);
+                ctx.failures++;
+                continue;
+            }
+            run_scenario(ctx, sc);
+        }
+    }
+    return ctx.failures ? 1 : 0;
+}
@@ -7,6 +7,7 @@
 #include <arpa/inet.h>
 
 #include <iostream>
+#include <memory>
 #include <thread>
 
 #include <unistd.h>
@@ -114,4 +115,86 @@ TEST(NextHopGroupDEBUG_CAPI, register_c) {
     fib_frr_register_callback(frr_log_forwarder); // Register callback to test default logging
     FIB_LOG(fib::LogLevel::DEBUG, "Test log with C callback logger - DEBUG level");
     FIB_LOG(fib::LogLevel::INFO, "Test log with C callback logger - INFO level");
-}
\ No newline at end of file
+}
+// Hammer FIB_LOG from many threads while the callback and the level are swapped
+TEST(NextHopGroupDEBUG_API, concurrent_callback_swap) {
+    const int num_threads = 8;
+    const int num_iterations = 20000;
+    std::atomic<uint64_t> count_a{0};
+    std::atomic<uint64_t> count_b{0};
+    std::atomic<uint64_t> filtered_args{0};
+    std::atomic<bool> start{false};
+    std::atomic<int> finished{0};
+
+    auto make_counter = [](std::atomic<uint64_t>& counter) {
+        return [&counter](fib::LogLevel, const char*, int, const char*, const char* format, va_list args) {
+            // Format like a real sink would, so va_list handling is exercised too
+            std::array<char, 128> buf;
+            vsnprintf(buf.data(), buf.size(), format, args);
+            counter.fetch_add(1, std::memory_order_relaxed);
+        };
+    };
+    // Only evaluated when FIB_LOG decides the message is enabled
+    auto count_eval = [&filtered_args](int v) {
+        filtered_args.fetch_add(1, std::memory_order_relaxed);
+        return v;
+    };
+
+    setLogLevel(fib::LogLevel::WARN);
+    registerLogCallback(make_counter(count_a));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t]() {
+            while (!start.load()) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < num_iterations; i++) {
+                FIB_LOG(fib::LogLevel::ERROR, "thread %d iteration %d", t, i);
+                FIB_LOG(fib::LogLevel::DEBUG, "filtered %d", count_eval(i));
+            }
+            finished.fetch_add(1);
+        });
+    }
+
+    start.store(true);
+    int swaps = 0;
+    while (finished.load() < num_threads) {
+        registerLogCallback(make_counter((swaps % 2) ? count_a : count_b));
+        swaps++;
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    cout << "[DEBUG] " << swaps << " swaps, callback A got " << count_a.load()
+         << ", callback B got " << count_b.load() << endl;
+    // Every enabled message reached exactly one of the callbacks, filtered ones never formatted
+    EXPECT_EQ(count_a.load() + count_b.load(), static_cast<uint64_t>(num_threads) * num_iterations);
+    EXPECT_EQ(filtered_args.load(), 0u);
+
+    // Level changes are seen by FIB_LOG without re-registering
+    setLogLevel(fib::LogLevel::DEBUG);
+    uint64_t before = count_a.load() + count_b.load();
+    FIB_LOG(fib::LogLevel::DEBUG, "enabled %d", count_eval(1));
+    EXPECT_EQ(count_a.load() + count_b.load(), before + 1);
+    EXPECT_EQ(filtered_args.load(), 1u);
+
+    registerLogCallback(nullptr);
+}
+
+// Replaced callbacks are freed, not kept until exit
+TEST(NextHopGroupDEBUG_API, replaced_callback_released) {
+    auto state = std::make_shared<int>(0);
+    std::weak_ptr<int> watch = state;
+    registerLogCallback([state](fib::LogLevel, const char*, int, const char*, const char*, va_list) {
+        (*state)++;
+    });
+    state.reset();
+    setLogLevel(fib::LogLevel::DEBUG);
+    FIB_LOG(fib::LogLevel::ERROR, "goes to the first callback");
+    EXPECT_FALSE(watch.expired());
+
+    registerLogCallback(nullptr);
+    EXPECT_TRUE(watch.expired());
+}
@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "src/nexthopgroupfull.h"
+#include "src/nexthopgroupfull_json.h"
+#include "src/nexthopgroup_intern.h"
+#include "src/nexthopgroup_debug.h"
+
+using namespace std;
+using namespace fib;
+
+/* Singleton nexthops sharing one SRv6 segment list, and groups over them */
+class NextHopGroupIntern : public ::testing::Test {
+protected:
+    void SetUp() override {
+        /* The pool compares on every lookup, keep its debug logs quiet */
+        setLogLevel(LogLevel::ERROR);
+
+        segs = {{}, {}};
+        inet_pton(AF_INET6, "fcbb:bbbb:1::", &segs[0]);
+        inet_pton(AF_INET6, "fcbb:bbbb:2::", &segs[1]);
+        seg_stack.reset(static_cast<seg6_seg_stack*>(
+            malloc(sizeof(seg6_seg_stack) + segs.size() * sizeof(struct in6_addr))));
+        seg_stack->encap_behavior = SRV6_HEADEND_BEHAVIOR_H_ENCAPS_RED;
+        seg_stack->num_segs = static_cast<uint8_t>(segs.size());
+        memcpy(seg_stack->seg, segs.data(), segs.size() * sizeof(struct in6_addr));
+        srv6.seg6local_action = SEG6_LOCAL_ACTION_UNSPEC;
+        inet_pton(AF_INET6, "fc00::1", &srv6.seg6_src);
+    }
+
+    void TearDown() override {
+        setLogLevel(LogLevel::DEBUG);
+    }
+
+    NextHopGroupFull member(uint32_t id, const char* gateway, uint32_t ifindex, bool with_srv6) {
+        union g_addr gate, src, rmap_src;
+        memset(&gate, 0, sizeof(gate));
+        memset(&src, 0, sizeof(src));
+        memset(&rmap_src, 0, sizeof(rmap_src));
+        inet_pton(AF_INET6, gateway, &gate.ipv6);
+        return NextHopGroupFull(id, id, NEXTHOP_TYPE_IPV6_IFINDEX, 0, ifindex, "Ethernet0",
+                                {}, {100}, ZEBRA_LSP_NONE, BLACKHOLE_UNSPEC,
+                                gate, src, rmap_src, 1, 0, 0,
+                                with_srv6, with_srv6, with_srv6 ? &srv6 : nullptr,
+                                with_srv6 ? seg_stack.get() : nullptr,
+                                with_srv6 ? segs : vector<struct in6_addr>{});
+    }
+
+    vector<struct in6_addr> segs;
+    unique_ptr<seg6_seg_stack, void (*)(void*)> seg_stack{nullptr, free};
+    nexthop_srv6 srv6;
+};
+
+TEST_F(NextHopGroupIntern, dedup_members) {
+    cout << "TEST_NextHopGroupIntern::dedup_members started:" << endl;
+    NextHopGroupFullPool pool;
+
+    NextHopGroupFull a = member(1, "2001:db8::1", 10, true);
+    NextHopGroupFull a_copy(a);
+    NextHopGroupFull other_if = member(1, "2001:db8::1", 11, true);
+
+    cout << "[DEBUG] Equal values hash equal and share one entry ..." << endl;
+    EXPECT_EQ(hashNextHopGroupPayload(a), hashNextHopGroupPayload(a_copy));
+    NextHopGroupFullRef ref_a = pool.intern(a);
+    NextHopGroupFullRef ref_a_copy = pool.intern(a_copy);
+    EXPECT_EQ(ref_a, ref_a_copy);
+    EXPECT_NE(ref_a->nhg().nh_srv6, a.nh_srv6);
+    EXPECT_TRUE(equalNextHopGroupPayload(ref_a->nhg(), a));
+    EXPECT_EQ(ref_a->hash(), hashNextHopGroupPayload(a));
+    EXPECT_NE(ref_a->internId(), 0u);
+    EXPECT_EQ(pool.size(), 1u);
+
+    cout << "[DEBUG] Any differing field gives a separate entry ..." << endl;
+    NextHopGroupFullRef ref_other_if = pool.intern(other_if);
+    EXPECT_NE(ref_a, ref_other_if);
+    EXPECT_NE(ref_a->internId(), ref_other_if->internId());
+
+    NextHopGroupFull other_sid(a);
+    inet_pton(AF_INET6, "fcbb:bbbb:3::", &other_sid.nh_srv6->seg6_segs->seg[1]);
+    EXPECT_NE(pool.intern(other_sid), ref_a);
+
+    NextHopGroupFull no_srv6 = member(1, "2001:db8::1", 10, false);
+    EXPECT_NE(pool.intern(no_srv6), ref_a);
+    EXPECT_EQ(pool.size(), 2u);
+
+    cout << "[DEBUG] A copy parsed back from JSON interns to the same entry ..." << endl;
+    string json_str = to_json_string(a);
+    NextHopGroupFull parsed;
+    memset(&parsed.gate, 0, sizeof(parsed.gate));
+    memset(&parsed.src, 0, sizeof(parsed.src));
+    memset(&parsed.rmap_src, 0, sizeof(parsed.rmap_src));
+    ASSERT_TRUE(from_json_string(json_str, parsed));
+    EXPECT_EQ(pool.intern(parsed), ref_a);
+
+    cout << "TEST_NextHopGroupIntern::dedup_members finished." << endl;
+}
+
+TEST_F(NextHopGroupIntern, dedup_across_ids) {
+    cout << "TEST_NextHopGroupIntern::dedup_across_ids started:" << endl;
+    NextHopGroupFullPool pool;
+
+    NextHopGroupFull a = member(1, "2001:db8::1", 10, true);
+    NextHopGroupFull b = member(2, "2001:db8::1", 10, true);
+    b.depends = {7};
+    b.dependents = {200, 201};
+
+    cout << "[DEBUG] The same payload under two NHG ids shares one entry ..." << endl;
+    EXPECT_FALSE(a == b);
+    EXPECT_TRUE(equalNextHopGroupPayload(a, b));
+    EXPECT_EQ(hashNextHopGroupPayload(a), hashNextHopGroupPayload(b));
+    NextHopGroupFullRef ref_a = pool.intern(a);
+    NextHopGroupFullRef ref_b = pool.intern(b);
+    EXPECT_EQ(ref_a, ref_b);
+    EXPECT_EQ(pool.size(), 1u);
+
+    cout << "[DEBUG] The entry does not keep either holder's identity ..." << endl;
+    EXPECT_EQ(ref_a->nhg().id, 0u);
+    EXPECT_EQ(ref_a->nhg().key, 0u);
+    EXPECT_TRUE(ref_a->nhg().depends.empty());
+    EXPECT_TRUE(ref_a->nhg().dependents.empty());
+
+    cout << "TEST_NextHopGroupIntern::dedup_across_ids finished." << endl;
+}
+
+TEST_F(NextHopGroupIntern, group_equality) {
+    cout << "TEST_NextHopGroupIntern::group_equality started:" << endl;
+    NextHopGroupFullPool pool;
+
+    vector<nh_grp_full> nh_list;
+    vector<uint32_t> depends;
+    for (uint32_t i = 0; i < 64; i++) {
+        nh_list.push_back({1000 + i, static_cast<uint16_t>(1 + i % 4), 0});
+        depends.push_back(1000 + i);
+    }
+    NextHopGroupFull group(100, 100, 0, nh_list, depends, {7});
+    NextHopGroupFull same_group(100, 100, 0, nh_list, depends, {7});
+    nh_list[63].weight = 9;
+    NextHopGroupFull reweighted(100, 100, 0, nh_list, depends, {7});
+
+    cout << "[DEBUG] Interned groups compare by reference ..." << endl;
+    NextHopGroupFullRef ref = pool.intern(group);
+    EXPECT_EQ(ref, pool.intern(same_group));
+    NextHopGroupFullRef ref_reweighted = pool.intern(reweighted);
+    EXPECT_NE(ref, ref_reweighted);
+    EXPECT_NE(ref->hash(), ref_reweighted->hash());
+
+    cout << "[DEBUG] Blackhole groups hash bh_type, not the gate bytes ..." << endl;
+    NextHopGroupFull bh1 = member(5, "::", 0, false);
+    bh1.type = NEXTHOP_TYPE_BLACKHOLE;
+    bh1.bh_type = BLACKHOLE_NULL;
+    NextHopGroupFull bh2(bh1);
+    EXPECT_TRUE(bh1 == bh2);
+    EXPECT_EQ(hashNextHopGroupPayload(bh1), hashNextHopGroupPayload(bh2));
+    EXPECT_EQ(pool.intern(bh1), pool.intern(bh2));
+
+    cout << "TEST_NextHopGroupIntern::group_equality finished." << endl;
+}
+
+TEST_F(NextHopGroupIntern, release) {
+    cout << "TEST_NextHopGroupIntern::release started:" << endl;
+    NextHopGroupFullRef survivor;
+    uint32_t intern_id = 0;
+    {
+        NextHopGroupFullPool pool;
+        NextHopGroupFullRef ref = pool.intern(member(1, "2001:db8::1", 10, true));
+        intern_id = ref->internId();
+        EXPECT_EQ(pool.find(intern_id), ref);
+
+        cout << "[DEBUG] Dropping the last reference releases the entry ..." << endl;
+        ref.reset();
+        EXPECT_EQ(pool.size(), 0u);
+        EXPECT_EQ(pool.find(intern_id), nullptr);
+
+        ref = pool.intern(member(1, "2001:db8::1", 10, true));
+        EXPECT_NE(ref->internId(), intern_id);
+        survivor = pool.intern(member(2, "2001:db8::2", 10, true));
+        EXPECT_EQ(pool.size(), 2u);
+    }
+
+    cout << "[DEBUG] References outlive the pool ..." << endl;
+    ASSERT_NE(survivor, nullptr);
+    EXPECT_EQ(survivor->nhg().id, 0u);
+    EXPECT_EQ(survivor->nhg().ifindex, 10u);
+    EXPECT_EQ(survivor->nhg().nh_srv6->seg6_segs->num_segs, 2);
+    survivor.reset();
+
+    cout << "TEST_NextHopGroupIntern::release finished." << endl;
+}
+
+TEST_F(NextHopGroupIntern, concurrent_intern) {
+    cout << "TEST_NextHopGroupIntern::concurrent_intern started:" << endl;
+    NextHopGroupFullPool pool;
+    const int num_threads = 8;
+    const int iterations = 2000;
+    const uint32_t num_members = 16;
+
+    vector<NextHopGroupFull> members;
+    for (uint32_t i = 0; i < num_members; i++) {
+        char gateway[INET6_ADDRSTRLEN];
+        snprintf(gateway, sizeof(gateway), "2001:db8::%x", i + 1);
+        members.push_back(member(i + 1, gateway, 10, i % 2 == 0));
+    }
+
+    /* Threads intern and drop the same values, entries come and go under them */
+    NextHopGroupFullRef pinned = pool.intern(members[0]);
+    atomic<int> mismatches{0};
+    vector<thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < iterations; i++) {
+                const NextHopGroupFull& nhg = members[static_cast<uint32_t>(i + t) % num_members];
+                NextHopGroupFullRef ref = pool.intern(nhg);
+                if (!equalNextHopGroupPayload(ref->nhg(), nhg)) {
+                    mismatches++;
+                }
+                if (nhg.id == 1 && ref != pinned) {
+                    mismatches++;
+                }
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    EXPECT_EQ(mismatches.load(), 0);
+    EXPECT_EQ(pool.size(), 1u);
+    EXPECT_EQ(pool.find(pinned->internId()), pinned);
+
+    cout << "TEST_NextHopGroupIntern::concurrent_intern finished." << endl;
+}
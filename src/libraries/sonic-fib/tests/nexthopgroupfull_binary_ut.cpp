@@ -0,0 +1,269 @@
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+
+#include <iostream>
+
+#include "src/nexthopgroupfull.h"
+#include "src/nexthopgroupfull_json.h"
+#include "src/nexthopgroupfull_binary.h"
+
+using namespace std;
+using namespace fib;
+
+static nh_grp_full make_nh_grp_full(uint32_t id, uint16_t weight, uint32_t num_direct) {
+    return {id, weight, num_direct};
+}
+
+/*
+ * Encode val to binary and JSON, decode both back and check that each
+ * round-trip gives the original object.
+ */
+static void check_binary_round_trip(NextHopGroupFull& val)
+{
+    cout << "[DEBUG] Calling to_binary_string ..." << endl;
+    string bin = fib::to_binary_string(val);
+    string json = fib::to_json_string(val);
+    cout << "    [DEBUG] binary size: " << bin.size() << ", json size: " << json.size() << endl;
+    EXPECT_LT(bin.size(), json.size());
+
+    /* Check the header */
+    ASSERT_GE(bin.size(), static_cast<size_t>(NHG_BINARY_HEADER_SIZE));
+    EXPECT_EQ(static_cast<uint8_t>(bin[0]), NHG_BINARY_VERSION);
+
+    cout << "[DEBUG] Calling from_binary_string ..." << endl;
+    NextHopGroupFull from_bin;
+    ASSERT_TRUE(fib::from_binary_string(bin, from_bin));
+    EXPECT_TRUE(from_bin == val);
+
+    cout << "[DEBUG] Checking against the JSON round-trip ..." << endl;
+    NextHopGroupFull from_json;
+    // from_json only fills the IPv4 part of an address for IPv4 types, clear the rest first
+    memset(&from_json.gate, 0, sizeof(from_json.gate));
+    memset(&from_json.src, 0, sizeof(from_json.src));
+    memset(&from_json.rmap_src, 0, sizeof(from_json.rmap_src));
+    ASSERT_TRUE(fib::from_json_string(json, from_json));
+    EXPECT_TRUE(from_bin == from_json);
+
+    /* Re-encoding the decoded object must give the same bytes */
+    EXPECT_EQ(fib::to_binary_string(from_bin), bin);
+}
+
+TEST(StructToFromBinary, NextHopGroupFull_multi_nexthop)
+{
+    cout << "TEST_StructToFromBinary::NextHopGroupFull_multi_nexthop started:" << endl;
+    /* Prepare the value */
+    cout << "[DEBUG] Preparing values ..." << endl;
+    vector<nh_grp_full> test_nh_grp_full_list = {
+        make_nh_grp_full(200, 1, 0),
+        make_nh_grp_full(300, 1, 2),
+        make_nh_grp_full(310, 2, 0),
+        make_nh_grp_full(320, 2, 0),
+        make_nh_grp_full(400, 1, 0)
+    };
+    vector<uint32_t> test_depends = {200, 300, 400};
+    vector<uint32_t> test_dependents = {500, 600};
+
+    NextHopGroupFull test_val(100, 1234567, 1024,
+                              test_nh_grp_full_list, test_depends, test_dependents);
+
+    check_binary_round_trip(test_val);
+
+    cout << "TEST_StructToFromBinary::NextHopGroupFull_multi_nexthop finished." << endl;
+}
+
+TEST(StructToFromBinary, NextHopGroupFull_singleton_srv6)
+{
+    cout << "TEST_StructToFromBinary::NextHopGroupFull_singleton_srv6 started:" << endl;
+    /* Prepare the values */
+    cout << "[DEBUG] Preparing values ..." << endl;
+    union g_addr test_gateway = {};
+    union g_addr test_src = {};
+    union g_addr test_rmap_src = {};
+    inet_pton(AF_INET6, "2001:db8::1", &test_gateway.ipv6.s6_addr);
+    inet_pton(AF_INET6, "2001:db8::2", &test_src.ipv6.s6_addr);
+    inet_pton(AF_INET6, "2001:db8::3", &test_rmap_src.ipv6.s6_addr);
+
+    // Prepare the segment list
+    vector<struct in6_addr> test_nh_segs {
+        {}, {}, {}
+    };
+    inet_pton(AF_INET6, "2001:db8:1::1", test_nh_segs[0].s6_addr);
+    inet_pton(AF_INET6, "2001:db8:1::2", test_nh_segs[1].s6_addr);
+    inet_pton(AF_INET6, "2001:db8:1::3", test_nh_segs[2].s6_addr);
+
+    // Prepare seg6_segs
+    size_t seg6_segs_size = sizeof(struct seg6_seg_stack) +
+                                test_nh_segs.size() * sizeof(struct in6_addr);
+    struct seg6_seg_stack* test_nh_seg6_segs =
+        (struct seg6_seg_stack*)malloc(seg6_segs_size);
+    test_nh_seg6_segs->encap_behavior = SRV6_HEADEND_BEHAVIOR_H_ENCAPS_RED;
+    test_nh_seg6_segs->num_segs = 3;
+    memcpy(test_nh_seg6_segs->seg, test_nh_segs.data(), test_nh_segs.size() * sizeof(in6_addr));
+
+    // Prepare nh_srv6
+    struct nexthop_srv6 test_nh_srv6 = {};
+    test_nh_srv6.seg6local_action = SEG6_LOCAL_ACTION_END_DT46;
+    inet_pton(AF_INET, "192.168.10.1", &test_nh_srv6.seg6local_ctx.nh4);
+    inet_pton(AF_INET6, "2001:db8::a", &test_nh_srv6.seg6local_ctx.nh6);
+    test_nh_srv6.seg6local_ctx.table = 100;
+    test_nh_srv6.seg6local_ctx.flv.flv_ops = 0x12345678;
+    test_nh_srv6.seg6local_ctx.flv.lcblock_len = 20;
+    test_nh_srv6.seg6local_ctx.flv.lcnode_func_len = 16;
+    test_nh_srv6.seg6local_ctx.block_len = 36;
+    test_nh_srv6.seg6local_ctx.node_len = 12;
+    test_nh_srv6.seg6local_ctx.function_len = 20;
+    test_nh_srv6.seg6local_ctx.argument_len = 16;
+    inet_pton(AF_INET6, "fc00::1", &test_nh_srv6.seg6_src);
+
+    /* Call constructor function */
+    cout << "[DEBUG] Calling NextHopGroupFull Constructor ..." << endl;
+    NextHopGroupFull test_val(100, 1234567, NEXTHOP_TYPE_IPV6_IFINDEX, 101, 101,
+                "Ethernet101", {200, 300, 400}, {500, 600}, ZEBRA_LSP_SRTE,
+                BLACKHOLE_UNSPEC, test_gateway, test_src, test_rmap_src,
+                0xabcd, 8, 0x80000001, true, true,
+                &test_nh_srv6, test_nh_seg6_segs, test_nh_segs);
+
+    // Free the memory allocated dynamically
+    free(test_nh_seg6_segs);
+    test_nh_seg6_segs = nullptr;
+
+    ASSERT_NE(test_val.nh_srv6, nullptr);
+    ASSERT_NE(test_val.nh_srv6->seg6_segs, nullptr);
+    check_binary_round_trip(test_val);
+
+    /* Decoding into an object that already owns SRv6 data replaces it */
+    cout << "[DEBUG] Decoding twice into the same object ..." << endl;
+    string bin = fib::to_binary_string(test_val);
+    NextHopGroupFull reused;
+    ASSERT_TRUE(fib::from_binary_string(bin, reused));
+    ASSERT_TRUE(fib::from_binary_string(bin, reused));
+    EXPECT_TRUE(reused == test_val);
+    EXPECT_EQ(reused.nh_srv6->seg6_segs->num_segs, 3);
+    EXPECT_EQ(reused.nh_srv6->seg6_segs->encap_behavior, SRV6_HEADEND_BEHAVIOR_H_ENCAPS_RED);
+
+    cout << "TEST_StructToFromBinary::NextHopGroupFull_singleton_srv6 finished." << endl;
+}
+
+TEST(StructToFromBinary, NextHopGroupFull_ipv4_srv6_no_segs)
+{
+    cout << "TEST_StructToFromBinary::NextHopGroupFull_ipv4_srv6_no_segs started:" << endl;
+    /* Prepare the values */
+    cout << "[DEBUG] Preparing values ..." << endl;
+    union g_addr test_gateway = {};
+    union g_addr test_src = {};
+    union g_addr test_rmap_src = {};
+    inet_pton(AF_INET, "10.0.0.1", &test_gateway.ipv4);
+    inet_pton(AF_INET, "10.0.0.2", &test_src.ipv4);
+    inet_pton(AF_INET, "10.0.0.3", &test_rmap_src.ipv4);
+
+    struct nexthop_srv6 test_nh_srv6 = {};
+    test_nh_srv6.seg6local_action = SEG6_LOCAL_ACTION_END_DT4;
+    test_nh_srv6.seg6local_ctx.table = 10;
+
+    NextHopGroupFull test_val(7, 8, NEXTHOP_TYPE_IPV4_IFINDEX, 0, 12,
+                "Ethernet0", {}, {}, ZEBRA_LSP_NONE,
+                BLACKHOLE_UNSPEC, test_gateway, test_src, test_rmap_src,
+                1, 0, 0, true, false,
+                &test_nh_srv6, nullptr, {});
+
+    ASSERT_NE(test_val.nh_srv6, nullptr);
+    EXPECT_EQ(test_val.nh_srv6->seg6_segs, nullptr);
+    check_binary_round_trip(test_val);
+
+    cout << "TEST_StructToFromBinary::NextHopGroupFull_ipv4_srv6_no_segs finished." << endl;
+}
+
+TEST(StructToFromBinary, NextHopGroupFull_blackhole)
+{
+    cout << "TEST_StructToFromBinary::NextHopGroupFull_blackhole started:" << endl;
+    /* Prepare the values */
+    cout << "[DEBUG] Preparing values ..." << endl;
+    union g_addr test_addr = {};
+
+    NextHopGroupFull test_val(9, 10, NEXTHOP_TYPE_BLACKHOLE, 0, 0,
+                "", {}, {}, ZEBRA_LSP_NONE,
+                BLACKHOLE_REJECT, test_addr, test_addr, test_addr,
+                1, 0, 0, false, false,
+                nullptr, nullptr, {});
+    test_val.bh_type = BLACKHOLE_REJECT;
+
+    check_binary_round_trip(test_val);
+
+    NextHopGroupFull parsed_val;
+    ASSERT_TRUE(fib::from_binary_string(fib::to_binary_string(test_val), parsed_val));
+    EXPECT_EQ(parsed_val.bh_type, BLACKHOLE_REJECT);
+
+    cout << "TEST_StructToFromBinary::NextHopGroupFull_blackhole finished." << endl;
+}
+
+TEST(StructToFromBinary, reject_malformed)
+{
+    cout << "TEST_StructToFromBinary::reject_malformed started:" << endl;
+    vector<nh_grp_full> test_nh_grp_full_list = {
+        make_nh_grp_full(200, 1, 0),
+        make_nh_grp_full(300, 1, 2)
+    };
+    NextHopGroupFull test_val(100, 1234567, 1024, test_nh_grp_full_list, {200, 300}, {500});
+    string bin = fib::to_binary_string(test_val);
+    NextHopGroupFull parsed_val;
+
+    /* Every truncation of the buffer must be rejected */
+    cout << "[DEBUG] Checking truncated buffers ..." << endl;
+    for (size_t len = 0; len < bin.size(); ++len) {
+        EXPECT_FALSE(fib::from_binary(bin.data(), len, parsed_val)) << "len " << len;
+    }
+
+    /* Unknown version */
+    cout << "[DEBUG] Checking unknown version ..." << endl;
+    string bad_version = bin;
+    bad_version[0] = static_cast<char>(NHG_BINARY_VERSION + 1);
+    EXPECT_FALSE(fib::from_binary_string(bad_version, parsed_val));
+
+    /* Trailing bytes after the payload */
+    cout << "[DEBUG] Checking trailing bytes ..." << endl;
+    string trailing = bin + '\0';
+    EXPECT_FALSE(fib::from_binary_string(trailing, parsed_val));
+
+    /* Payload length covers bytes that the fields don't consume */
+    string padded = trailing;
+    uint32_t padded_len = static_cast<uint32_t>(padded.size() - NHG_BINARY_HEADER_SIZE);
+    memcpy(&padded[2], &padded_len, sizeof(padded_len));
+    EXPECT_FALSE(fib::from_binary_string(padded, parsed_val));
+
+    /* Element count larger than the remaining buffer */
+    cout << "[DEBUG] Checking oversized element count ..." << endl;
+    string bad_count = bin;
+    // header + id/key/weight/flags/nhg_flags + empty ifname, then the list count
+    size_t count_offset = NHG_BINARY_HEADER_SIZE + 4 + 4 + 2 + 1 + 4 + 4;
+    bad_count[count_offset + 3] = static_cast<char>(0x7f);
+    EXPECT_FALSE(fib::from_binary_string(bad_count, parsed_val));
+
+    /* Out of range enum value */
+    cout << "[DEBUG] Checking out of range enum ..." << endl;
+    NextHopGroupFull blackhole;
+    blackhole.type = NEXTHOP_TYPE_BLACKHOLE;
+    blackhole.bh_type = BLACKHOLE_NULL;
+    string bad_enum = fib::to_binary_string(blackhole);
+    size_t type_offset = NHG_BINARY_HEADER_SIZE + 4 + 4 + 2 + 1 + 4 + 4 + 4 + 4 + 4;
+    ASSERT_EQ(static_cast<uint8_t>(bad_enum[type_offset]), NEXTHOP_TYPE_BLACKHOLE);
+    bad_enum[type_offset] = static_cast<char>(0xff);
+    EXPECT_FALSE(fib::from_binary_string(bad_enum, parsed_val));
+
+    cout << "TEST_StructToFromBinary::reject_malformed finished." << endl;
+}
+
+TEST(StructToFromBinary, NextHopGroupFull_long_string)
+{
+    cout << "TEST_StructToFromBinary::NextHopGroupFull_long_string started:" << endl;
+    /* Longer than a u16 length could carry */
+    NextHopGroupFull test_val(100, 1234567, 1024, {make_nh_grp_full(200, 1, 0)}, {200}, {500});
+    test_val.ifname = string(70000, 'e');
+
+    string bin = fib::to_binary_string(test_val);
+    NextHopGroupFull parsed_val;
+    ASSERT_TRUE(fib::from_binary_string(bin, parsed_val));
+    EXPECT_EQ(parsed_val.ifname.size(), 70000u);
+    EXPECT_TRUE(parsed_val == test_val);
+
+    cout << "TEST_StructToFromBinary::NextHopGroupFull_long_string finished." << endl;
+}
@@ -687,4 +687,96 @@ TEST(StructToFromJson, NextHopGroupFull_singleton)
     EXPECT_TRUE(parsed_val == test_val);
 
     cout << "TEST_StructToFromJson::NextHopGroupFull_singleton finished." << endl;
-}
\ No newline at end of file
+}
+/*
+ * The streaming writer must produce exactly the bytes of to_json_string().
+ */
+static void check_streaming_writer(NextHopGroupFull& val)
+{
+    string expected = fib::to_json_string(val);
+    string streamed = "stale contents";
+    fib::to_json_buffer(val, streamed);
+    cout << "    [DEBUG] " << streamed << endl;
+    EXPECT_EQ(streamed, expected);
+}
+
+TEST(StreamingJsonWriter, NextHopGroupFull_multi_nexthop)
+{
+    cout << "TEST_StreamingJsonWriter::NextHopGroupFull_multi_nexthop started:" << endl;
+    vector<nh_grp_full> test_nh_grp_full_list = {
+        make_nh_grp_full(200, 1, 0),
+        make_nh_grp_full(300, 1, 2),
+        make_nh_grp_full(4294967295u, 65535, 0)
+    };
+    NextHopGroupFull test_val(100, 1234567, 1024, test_nh_grp_full_list, {200, 300, 400}, {});
+    check_streaming_writer(test_val);
+
+    /* Recursive constructor with a gateway */
+    union g_addr test_gateway = {};
+    inet_pton(AF_INET, "10.1.1.1", &test_gateway.ipv4);
+    NextHopGroupFull recursive_val(101, 7, 0, test_gateway, NEXTHOP_TYPE_IPV4,
+                                   test_nh_grp_full_list, {}, {500});
+    check_streaming_writer(recursive_val);
+
+    cout << "TEST_StreamingJsonWriter::NextHopGroupFull_multi_nexthop finished." << endl;
+}
+
+TEST(StreamingJsonWriter, NextHopGroupFull_singleton)
+{
+    cout << "TEST_StreamingJsonWriter::NextHopGroupFull_singleton started:" << endl;
+    union g_addr test_gateway = {};
+    union g_addr test_src = {};
+    union g_addr test_rmap_src = {};
+    inet_pton(AF_INET6, "2001:db8::1", &test_gateway.ipv6.s6_addr);
+    inet_pton(AF_INET6, "2001:db8::2", &test_src.ipv6.s6_addr);
+
+    vector<struct in6_addr> test_nh_segs {
+        {}, {}
+    };
+    set_ipv6(test_nh_segs[0], "2001:db8:1::1");
+    set_ipv6(test_nh_segs[1], "2001:db8:1::2");
+    size_t seg6_segs_size = sizeof(struct seg6_seg_stack) +
+                                test_nh_segs.size() * sizeof(struct in6_addr);
+    struct seg6_seg_stack* test_nh_seg6_segs =
+        (struct seg6_seg_stack*)malloc(seg6_segs_size);
+    test_nh_seg6_segs->encap_behavior = SRV6_HEADEND_BEHAVIOR_H_ENCAPS_L2_RED;
+    test_nh_seg6_segs->num_segs = 2;
+    memcpy(test_nh_seg6_segs->seg, test_nh_segs.data(), test_nh_segs.size() * sizeof(in6_addr));
+
+    struct nexthop_srv6 test_nh_srv6 = {};
+    test_nh_srv6.seg6local_action = SEG6_LOCAL_ACTION_END_DT46;
+    set_ipv4(test_nh_srv6.seg6local_ctx.nh4, "192.168.10.1");
+    set_ipv6(test_nh_srv6.seg6local_ctx.nh6, "2001:db8::a");
+    test_nh_srv6.seg6local_ctx.table = 100;
+    test_nh_srv6.seg6local_ctx.flv.flv_ops = 3;
+    test_nh_srv6.seg6local_ctx.block_len = 36;
+
+    /* ifname exercising the JSON escaping rules */
+    NextHopGroupFull test_val(100, 1234567, NEXTHOP_TYPE_IPV6_IFINDEX, 101, 101,
+                "eth\"1\\\n\t\x01\x1f", {200}, {500, 600}, ZEBRA_LSP_EVPN,
+                BLACKHOLE_UNSPEC, test_gateway, test_src, test_rmap_src,
+                8, 8, 1024, true, true,
+                &test_nh_srv6, test_nh_seg6_segs, test_nh_segs);
+    free(test_nh_seg6_segs);
+    check_streaming_writer(test_val);
+
+    /* SRv6 without a segment stack */
+    free(test_val.nh_srv6->seg6_segs);
+    test_val.nh_srv6->seg6_segs = nullptr;
+    check_streaming_writer(test_val);
+
+    /* Blackhole adds bh_type after the schema ordered fields */
+    NextHopGroupFull blackhole_val;
+    blackhole_val.type = NEXTHOP_TYPE_BLACKHOLE;
+    memset(&blackhole_val.gate, 0, sizeof(blackhole_val.gate));
+    blackhole_val.bh_type = BLACKHOLE_ADMINPROHIB;
+    memset(&blackhole_val.src, 0, sizeof(blackhole_val.src));
+    memset(&blackhole_val.rmap_src, 0, sizeof(blackhole_val.rmap_src));
+    check_streaming_writer(blackhole_val);
+
+    /* Out of range enums are written as UNKNOWN */
+    blackhole_val.nh_label_type = static_cast<lsp_types_t>(12);
+    check_streaming_writer(blackhole_val);
+
+    cout << "TEST_StreamingJsonWriter::NextHopGroupFull_singleton finished." << endl;
+}
@@ -52,6 +52,8 @@ int main(int argc, char** argv) {
 	return returnCode;
     }
 
+    // let cin buffer stdin itself so run() can read all lines already written
+    ios::sync_with_stdio(false);
     plugin->run();
     return SUCCESS_CODE;
 }
@@ -5,6 +5,9 @@
 #include <ctime>
 #include <unordered_map>
 #include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstring>
 #include "rsyslog_plugin.h"
 #include <nlohmann/json.hpp>
 
@@ -85,6 +88,7 @@ bool RsyslogPlugin::createRegexList() {
             rs.params = eventParams;
             rs.tag = tag;
             rs.regexExpression = expression;
+            rs.literal = SyslogParser::requiredLiteral(eventRegex);
             regexList.push_back(rs);
         } catch (nlohmann::detail::type_error& deException) {
             SWSS_LOG_ERROR("Missing required key, throws exception: %s\n", deException.what());
@@ -100,28 +104,187 @@ bool RsyslogPlugin::createRegexList() {
         return false;
     }
 
-    m_parser->m_regexList = regexList;
+    m_parser->setRegexList(regexList, m_luaState);
 
     regexFile.close();
     return true;
 }
 
-void RsyslogPlugin::run() {
-    signal(SIGTERM, RsyslogPlugin::signalHandler);
-    lua_State* luaState = luaL_newstate();
-    luaL_openlibs(luaState);
-    string line;
-    while(RsyslogPlugin::g_running && getline(cin, line)) {
-        if(line.empty()) {
+LineChunk RsyslogPlugin::takeFreeChunk() {
+    LineChunk chunk;
+    {
+        lock_guard<mutex> lock(m_chunkMutex);
+        if(!m_freeChunks.empty()) {
+            chunk = move(m_freeChunks.front());
+            m_freeChunks.pop_front();
+        }
+    }
+    if(chunk.data.empty()) {
+        chunk.data.resize(RSYSLOG_READ_CHUNK_SIZE);
+    }
+    chunk.len = 0;
+    return chunk;
+}
+
+/**
+ * Queues a chunk for the publisher, waiting while the queue is full so a slow
+ * publisher pushes back on stdin instead of growing memory.
+ *
+ * @return false if plugin is shutting down and chunk was not queued
+ *
+*/
+
+bool RsyslogPlugin::pushChunk(LineChunk& chunk) {
+    unique_lock<mutex> lock(m_chunkMutex);
+    while(m_chunks.size() >= RSYSLOG_MAX_QUEUED_CHUNKS) {
+        if(!RsyslogPlugin::g_running) {
+            return false;
+        }
+        m_chunkSpace.wait_for(lock, chrono::milliseconds(RSYSLOG_QUEUE_WAIT_MS));
+    }
+    m_chunks.push_back(move(chunk));
+    m_chunkReady.notify_one();
+    return true;
+}
+
+/**
+ * @return false once reader is done and queue is drained, or on shutdown
+ *
+*/
+
+bool RsyslogPlugin::popChunk(LineChunk& chunk) {
+    unique_lock<mutex> lock(m_chunkMutex);
+    while(m_chunks.empty()) {
+        if(m_readDone || !RsyslogPlugin::g_running) {
+            return false;
+        }
+        m_chunkReady.wait_for(lock, chrono::milliseconds(RSYSLOG_QUEUE_WAIT_MS));
+    }
+    chunk = move(m_chunks.front());
+    m_chunks.pop_front();
+    m_chunkSpace.notify_one();
+    return true;
+}
+
+/**
+ * Reads stdin in chunks, taking whatever rsyslog has already written instead of
+ * a line at a time. Whole lines are queued, a trailing partial line is carried
+ * over to the next chunk.
+ *
+ * @param in is stream buffer of stdin
+ *
+*/
+
+void RsyslogPlugin::readChunks(streambuf& in) {
+    LineChunk chunk = takeFreeChunk();
+    while(RsyslogPlugin::g_running) {
+        if(chunk.len == chunk.data.size()) { // line longer than chunk
+            chunk.data.resize(chunk.data.size() * 2);
+        }
+        // block for first byte only, then take what is available without blocking
+        if(in.sgetc() == char_traits<char>::eof()) {
+            break;
+        }
+        streamsize avail = max<streamsize>(in.in_avail(), 1);
+        streamsize room = (streamsize)(chunk.data.size() - chunk.len);
+        chunk.len += (size_t)in.sgetn(chunk.data.data() + chunk.len, min(avail, room));
+
+        size_t end = chunk.len;
+        while(end > 0 && chunk.data[end - 1] != '\n') {
+            end--;
+        }
+        if(end == 0) {
             continue;
         }
-        onMessage(line, luaState);
+        LineChunk next = takeFreeChunk();
+        size_t rest = chunk.len - end;
+        if(rest > next.data.size()) {
+            next.data.resize(rest * 2);
+        }
+        memcpy(next.data.data(), chunk.data.data() + end, rest);
+        next.len = rest;
+        chunk.len = end;
+        if(!pushChunk(chunk)) {
+            break;
+        }
+        chunk = move(next);
+    }
+    // last line without newline
+    if(chunk.len > 0 && RsyslogPlugin::g_running) {
+        pushChunk(chunk);
+    }
+    lock_guard<mutex> lock(m_chunkMutex);
+    m_readDone = true;
+    m_chunkReady.notify_one();
+}
+
+void RsyslogPlugin::publishBatch(vector<pair<string, event_params_t>>& batch) {
+    for(auto& event : batch) {
+        int returnCode = event_publish(m_eventHandle, event.first, &event.second);
+        if(returnCode != 0) {
+            SWSS_LOG_ERROR("rsyslog_plugin was not able to publish event for %s.\n", event.first.c_str());
+            continue;
+        }
+        m_publishCount++;
     }
-    lua_close(luaState);
+    batch.clear();
+}
+
+/**
+ * Splits each chunk into lines in place, parses them and publishes the events
+ * of a chunk together. The line buffer is reused, so lines are not allocated.
+ *
+ * @param luaState is the lua state the regex list lua code is compiled into, only this stage uses it
+ *
+*/
+
+void RsyslogPlugin::publishChunks(lua_State* luaState) {
+    LineChunk chunk;
+    string line;
+    vector<pair<string, event_params_t>> batch;
+    while(popChunk(chunk)) {
+        const char* pos = chunk.data.data();
+        const char* end = pos + chunk.len;
+        while(pos < end && RsyslogPlugin::g_running) {
+            const char* eol = (const char*)memchr(pos, '\n', (size_t)(end - pos));
+            if(eol == NULL) {
+                eol = end;
+            }
+            if(eol > pos) {
+                line.assign(pos, eol);
+                string tag;
+                event_params_t paramDict;
+                if(m_parser->parseMessage(line, tag, paramDict, luaState)) {
+                    batch.emplace_back(move(tag), move(paramDict));
+                } else {
+                    SWSS_LOG_DEBUG("%s was not able to be parsed into a structured event\n", line.c_str());
+                }
+            }
+            pos = eol + 1;
+        }
+        publishBatch(batch);
+
+        lock_guard<mutex> lock(m_chunkMutex);
+        if(m_freeChunks.size() < RSYSLOG_MAX_QUEUED_CHUNKS) {
+            m_freeChunks.push_back(move(chunk));
+        }
+    }
+}
+
+void RsyslogPlugin::run() {
+    signal(SIGTERM, RsyslogPlugin::signalHandler);
+    m_readDone = false;
+    thread publisher(&RsyslogPlugin::publishChunks, this, m_luaState);
+    readChunks(*cin.rdbuf());
+    publisher.join();
 }
 
 int RsyslogPlugin::onInit() {
     m_eventHandle = events_init_publisher(m_moduleName);
+    if(m_luaState == NULL) {
+        m_luaState = luaL_newstate();
+        luaL_openlibs(m_luaState);
+    }
     bool success = createRegexList();
     if(!success) {
         return 1; // invalid regex error code
@@ -137,3 +300,10 @@ RsyslogPlugin::RsyslogPlugin(string moduleName, string regexPath) {
     m_regexPath = regexPath;
     RsyslogPlugin::g_running = true;
 }
+
+RsyslogPlugin::~RsyslogPlugin() {
+    // the parser goes with the plugin, its refs into the state need no release
+    if(m_luaState != NULL) {
+        lua_close(m_luaState);
+    }
+}
@@ -11,6 +11,11 @@ extern "C"
 #include <memory>
 #include <csignal>
 #include <atomic>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <streambuf>
 #include <swss/logger.h>
 #include <swss/events.h>
 #include "syslog_parser.h"
@@ -18,6 +23,16 @@ extern "C"
 using namespace std;
 using namespace swss;
 
+#define RSYSLOG_READ_CHUNK_SIZE (64 * 1024)
+#define RSYSLOG_MAX_QUEUED_CHUNKS 64
+#define RSYSLOG_QUEUE_WAIT_MS 100
+
+/* Block of stdin holding whole lines, passed from the reader to the publisher */
+struct LineChunk {
+    vector<char> data;
+    size_t len = 0;
+};
+
 /**
  * Rsyslog Plugin will utilize an instance of a syslog parser to read syslog messages from rsyslog.d and will continuously read from stdin
  * A plugin instance is created for each container/host.
@@ -30,7 +45,9 @@ public:
     int onInit();
     bool onMessage(string msg, lua_State* luaState);
     void run();
+    uint64_t getPublishCount() { return m_publishCount; }
     RsyslogPlugin(string moduleName, string regexPath);
+    ~RsyslogPlugin();
     static void signalHandler(int signum) {
         if (signum == SIGTERM) {
             SWSS_LOG_INFO("Rsyslog plugin received SIGTERM, shutting down");
@@ -42,7 +59,24 @@ private:
     event_handle_t m_eventHandle;
     string m_regexPath;
     string m_moduleName;
+    lua_State* m_luaState = NULL; // regex list lua code is compiled into it
     bool createRegexList();
+
+    // reader stage fills chunks from stdin, publisher stage parses and publishes
+    deque<LineChunk> m_chunks;
+    deque<LineChunk> m_freeChunks;
+    mutex m_chunkMutex;
+    condition_variable m_chunkReady;
+    condition_variable m_chunkSpace;
+    bool m_readDone = false;
+    uint64_t m_publishCount = 0;
+
+    void readChunks(streambuf& in);
+    void publishChunks(lua_State* luaState);
+    void publishBatch(vector<pair<string, event_params_t>>& batch);
+    LineChunk takeFreeChunk();
+    bool pushChunk(LineChunk& chunk);
+    bool popChunk(LineChunk& chunk);
 };
 
 #endif
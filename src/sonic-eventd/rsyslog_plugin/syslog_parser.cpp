@@ -1,8 +1,290 @@
 #include <iostream>
 #include <ctime>
+#include <cctype>
+#include <queue>
 #include <swss/logger.h>
 #include "syslog_parser.h"
 
+void LiteralMatcher::build(const vector<string>& literals) {
+    m_next.assign(1, array<int, 256>());
+    m_next[0].fill(-1);
+    m_output.assign(1, vector<int>());
+    m_literals = literals;
+
+    // trie of all literals
+    for(long unsigned int i = 0; i < literals.size(); i++) {
+        if(literals[i].empty()) {
+            continue;
+        }
+        int state = 0;
+        for(unsigned char c : literals[i]) {
+            if(m_next[state][c] < 0) {
+                m_next[state][c] = (int)m_next.size();
+                m_next.push_back(array<int, 256>());
+                m_next.back().fill(-1);
+                m_output.push_back(vector<int>());
+            }
+            state = m_next[state][c];
+        }
+        m_output[state].push_back((int)i);
+    }
+
+    // breadth first, turn failure links into a full transition table
+    m_fail.assign(m_next.size(), 0);
+    queue<int> pending;
+    for(int c = 0; c < 256; c++) {
+        if(m_next[0][c] < 0) {
+            m_next[0][c] = 0;
+        } else {
+            pending.push(m_next[0][c]);
+        }
+    }
+    while(!pending.empty()) {
+        int state = pending.front();
+        pending.pop();
+        const vector<int>& failOutput = m_output[m_fail[state]];
+        m_output[state].insert(m_output[state].end(), failOutput.begin(), failOutput.end());
+        for(int c = 0; c < 256; c++) {
+            int next = m_next[state][c];
+            if(next < 0) {
+                m_next[state][c] = m_next[m_fail[state]][c];
+            } else {
+                m_fail[next] = m_next[m_fail[state]][c];
+                pending.push(next);
+            }
+        }
+    }
+}
+
+void LiteralMatcher::match(const string& text, vector<char>& found) const {
+    int state = 0;
+    for(unsigned char c : text) {
+        state = m_next[state][c];
+        for(int i : m_output[state]) {
+            found[i] = 1;
+        }
+    }
+}
+
+/**
+ * Returns how many chars after an alphanumeric escape belong to it: the digits of
+ * \xHH and \uHHHH, the letter of \cX and the rest of a back reference.
+ *
+ * @param regexString is the regex being scanned
+ * @param i is the index of the char after the backslash
+ *
+*/
+
+static long unsigned int escapeOperandLength(const string& regexString, long unsigned int i) {
+    long unsigned int max = 0;
+    switch(regexString[i]) {
+        case 'x':
+            max = 2;
+            break;
+        case 'u':
+            max = 4;
+            break;
+        case 'c':
+            return (i + 1 < regexString.size()) ? 1 : 0;
+        default:
+            if(!isdigit((unsigned char)regexString[i])) {
+                return 0;
+            }
+            max = string::npos;
+            break;
+    }
+    long unsigned int n = 0;
+    while(n < max && i + 1 + n < regexString.size()) {
+        unsigned char next = regexString[i + 1 + n];
+        if(max == string::npos ? !isdigit(next) : !isxdigit(next)) {
+            break;
+        }
+        n++;
+    }
+    return n;
+}
+
+/**
+ * Finds the longest run of literal text a regex requires in every match, so that
+ * messages lacking it can be skipped without running the regex.
+ * Conservative: returns empty when unsure, e.g. with top level alternation.
+ *
+ * @param regexString is ECMAScript regex as given in regex file
+ * @return required literal or empty string
+ *
+*/
+
+string SyslogParser::requiredLiteral(const string& regexString) {
+    string best, current;
+    int depth = 0;
+    bool inClass = false;
+    auto endRun = [&]() {
+        if(current.size() > best.size()) {
+            best = current;
+        }
+        current.clear();
+    };
+
+    for(long unsigned int i = 0; i < regexString.size(); i++) {
+        char c = regexString[i];
+        if(inClass) {
+            if(c == '\\') {
+                i++;
+            } else if(c == ']') {
+                inClass = false;
+            }
+            continue;
+        }
+        if(c == '\\') {
+            if(++i >= regexString.size()) {
+                break;
+            }
+            if(isalnum((unsigned char)regexString[i])) { // \d, \s, \b, \xHH, \uHHHH, \cX, \0, back reference etc.
+                if(depth == 0) {
+                    endRun();
+                }
+                i += escapeOperandLength(regexString, i);
+            } else if(depth == 0) { // escaped metacharacter stands for itself
+                current += regexString[i];
+            }
+            continue;
+        }
+        if(c == '(') {
+            endRun();
+            depth++;
+            continue;
+        }
+        if(c == ')') {
+            depth--;
+            continue;
+        }
+        if(depth > 0) {
+            continue;
+        }
+        switch(c) {
+            case '|':
+                return "";
+            case '[':
+                endRun();
+                inClass = true;
+                break;
+            case '*':
+            case '?':
+            case '{':
+                // previous char may be absent
+                if(!current.empty()) {
+                    current.pop_back();
+                }
+                endRun();
+                if(c == '{') {
+                    i = regexString.find('}', i);
+                    if(i == string::npos) {
+                        return best;
+                    }
+                }
+                break;
+            case '+':
+            case '.':
+            case '^':
+            case '$':
+                endRun();
+                break;
+            default:
+                current += c;
+                break;
+        }
+    }
+    endRun();
+    return best;
+}
+
+void SyslogParser::buildPrefilter() {
+    vector<string> literals;
+    for(const auto& rs : m_regexList) {
+        literals.push_back(rs.literal);
+    }
+    m_prefilter.build(literals);
+    m_candidates.assign(literals.size(), 0);
+}
+
+/**
+ * Replaces the regex list. The prefilter is built and the lua code compiled here
+ * once, so parseMessage does neither per message.
+ *
+ * @param regexList is the list of regexes to match messages against
+ * @param luaState is the lua state later given to parseMessage, the state of an
+ *        earlier list must still be open
+ *
+*/
+
+void SyslogParser::setRegexList(const vector<RegexStruct>& regexList, lua_State* luaState) {
+    unloadLuaCode(m_luaState);
+    m_regexList = regexList;
+    buildPrefilter();
+    loadLuaCode(luaState);
+}
+
+/**
+ * Compiles lua code of every param with luaL_loadstring and keeps the chunk as a
+ * registry reference, so parseMessage only has to call it per message.
+ * A param whose code fails to compile is left with LUA_NOREF and passed through.
+ * References from an earlier load are released first.
+ *
+ * @param luaState is the lua state later given to parseMessage
+ *
+*/
+
+void SyslogParser::loadLuaCode(lua_State* luaState) {
+    unloadLuaCode(m_luaState);
+    if(luaState == NULL) {
+        return;
+    }
+    for(auto& rs : m_regexList) {
+        for(auto& param : rs.params) {
+            param.luaRef = LUA_NOREF;
+            if(param.luaCode.empty()) {
+                continue;
+            }
+            if(luaL_loadstring(luaState, param.luaCode.c_str()) != 0) {
+                SWSS_LOG_ERROR("Invalid lua code for param %s: %s\n", param.paramName.c_str(), lua_tostring(luaState, -1));
+                lua_pop(luaState, 1);
+                continue;
+            }
+            param.luaRef = luaL_ref(luaState, LUA_REGISTRYINDEX);
+        }
+    }
+    // each call gets its own environment, globals it reads come from _G
+    lua_createtable(luaState, 0, 1);
+    lua_pushvalue(luaState, LUA_GLOBALSINDEX);
+    lua_setfield(luaState, -2, "__index");
+    m_envMetaRef = luaL_ref(luaState, LUA_REGISTRYINDEX);
+    m_luaState = luaState;
+}
+
+/**
+ * Releases the references loadLuaCode made in luaState.
+ * Must be called before luaState is closed or replaced while it stays open,
+ * parseMessage cannot tell whether a state it no longer gets is still alive.
+ *
+ * @param luaState is the lua state given to loadLuaCode
+ *
+*/
+
+void SyslogParser::unloadLuaCode(lua_State* luaState) {
+    if(luaState == NULL || luaState != m_luaState) {
+        return;
+    }
+    for(auto& rs : m_regexList) {
+        for(auto& param : rs.params) {
+            luaL_unref(luaState, LUA_REGISTRYINDEX, param.luaRef);
+            param.luaRef = LUA_NOREF;
+        }
+    }
+    luaL_unref(luaState, LUA_REGISTRYINDEX, m_envMetaRef);
+    m_envMetaRef = LUA_NOREF;
+    m_luaState = NULL;
+}
+
 /**
  * Parses syslog message and returns structured event
  *
@@ -11,15 +293,21 @@
  *
 */
 
-bool SyslogParser::parseMessage(string message, string& eventTag, event_params_t& paramMap, lua_State* luaState) {
+bool SyslogParser::parseMessage(const string& message, string& eventTag, event_params_t& paramMap, lua_State* luaState) {
+    // one pass over message for all required literals
+    fill(m_candidates.begin(), m_candidates.end(), 0);
+    m_prefilter.match(message, m_candidates);
     for(long unsigned int i = 0; i < m_regexList.size(); i++) {
+        if(!m_candidates[i] && !m_regexList[i].literal.empty()) {
+            continue;
+        }
         smatch matchResults;
         if(!regex_search(message, matchResults, m_regexList[i].regexExpression) || m_regexList[i].params.size() != matchResults.size() - 1 || matchResults.size() < 4) {
             continue;
         }
         string formattedTimestamp;
         if(!matchResults[1].str().empty() && !matchResults[2].str().empty() && !matchResults[3].str().empty()) { // found timestamp components
-            formattedTimestamp = m_timestampFormatter->changeTimestampFormat({ matchResults[1].str(), matchResults[2].str(), matchResults[3].str() });
+            formattedTimestamp = m_timestampFormatter->changeTimestampFormat(matchResults[1].str(), matchResults[2].str(), matchResults[3].str());
 	}
         if(!formattedTimestamp.empty()) {
             paramMap["timestamp"] = formattedTimestamp;
@@ -29,6 +317,9 @@ bool SyslogParser::parseMessage(string message, string& eventTag, event_params_t
 
         // found matching regex
         eventTag = m_regexList[i].tag;
+        if(luaState != m_luaState) {
+            loadLuaCode(luaState);
+        }
 	// check params for lua code
         for(long unsigned int j = 3; j < m_regexList[i].params.size(); j++) {
 	    string resultValue = matchResults[j + 1].str();
@@ -41,19 +332,32 @@ bool SyslogParser::parseMessage(string message, string& eventTag, event_params_t
 		continue;
 	    }
 
-	    // execute lua code
+	    // run precompiled lua code in a fresh environment, arg is input and ret is output
+            if(m_regexList[i].params[j].luaRef == LUA_NOREF) {
+                SWSS_LOG_ERROR("Invalid lua code, unable to do operation.\n");
+                paramMap[paramName] = resultValue;
+                continue;
+            }
+            lua_createtable(luaState, 0, 2);
             lua_pushstring(luaState, resultValue.c_str());
-            lua_setglobal(luaState, "arg");
-            if(luaL_dostring(luaState, luaCode) == 0) {
+            lua_setfield(luaState, -2, "arg");
+            lua_rawgeti(luaState, LUA_REGISTRYINDEX, m_envMetaRef);
+            lua_setmetatable(luaState, -2);
+            lua_rawgeti(luaState, LUA_REGISTRYINDEX, m_regexList[i].params[j].luaRef);
+            lua_pushvalue(luaState, -2);
+            lua_setfenv(luaState, -2);
+            if(lua_pcall(luaState, 0, 0, 0) != 0) { // error in lua code
+                SWSS_LOG_ERROR("Invalid lua code, unable to do operation: %s\n", lua_tostring(luaState, -1));
                 lua_pop(luaState, lua_gettop(luaState));
-	    } else { // error in lua code
-		SWSS_LOG_ERROR("Invalid lua code, unable to do operation.\n");
-		paramMap[paramName] = resultValue;
-		continue;
+                paramMap[paramName] = resultValue;
+                continue;
             }
-            lua_getglobal(luaState, "ret");
-            paramMap[paramName] = lua_tostring(luaState, -1);
-            lua_pop(luaState, 1);
+            // only what the code set, not a global of the same name
+            lua_pushstring(luaState, "ret");
+            lua_rawget(luaState, -2);
+            const char* ret = lua_tostring(luaState, -1);
+            paramMap[paramName] = (ret != NULL) ? ret : resultValue;
+            lua_pop(luaState, lua_gettop(luaState));
 	}
         return true;
     }
@@ -62,4 +366,5 @@ bool SyslogParser::parseMessage(string message, string& eventTag, event_params_t
 
 SyslogParser::SyslogParser() {
     m_timestampFormatter = unique_ptr<TimestampFormatter>(new TimestampFormatter());
+    buildPrefilter();
 }
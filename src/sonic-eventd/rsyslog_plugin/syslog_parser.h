@@ -9,7 +9,9 @@ extern "C"
 }
 
 #include <vector>
+#include <utility>
 #include <string>
+#include <array>
 #include <regex>
 #include <nlohmann/json.hpp>
 #include <swss/events.h>
@@ -21,12 +23,33 @@ using json = nlohmann::json;
 struct EventParam {
     string paramName;
     string luaCode;
+    int luaRef = LUA_NOREF; // compiled luaCode in registry of the parser's lua state
 };
 
 struct RegexStruct {
     regex regexExpression;
     vector<EventParam> params;
     string tag;
+    string literal; // text any match must contain; empty if none known
+};
+
+/**
+ * LiteralMatcher is an Aho-Corasick automaton over a set of literals. A single
+ * pass over a message finds every literal it contains.
+ *
+ */
+
+class LiteralMatcher {
+public:
+    void build(const vector<string>& literals);
+    // sets found[i] for every literal i found in text; found must be sized to count()
+    void match(const string& text, vector<char>& found) const;
+    size_t count() const { return m_literals.size(); }
+private:
+    vector<array<int, 256>> m_next;
+    vector<int> m_fail;
+    vector<vector<int>> m_output;
+    vector<string> m_literals;
 };
 
 /**
@@ -38,9 +61,23 @@ struct RegexStruct {
 class SyslogParser {
 public:
     unique_ptr<TimestampFormatter> m_timestampFormatter;
-    vector<RegexStruct> m_regexList;
-    bool parseMessage(string message, string& tag, event_params_t& paramDict, lua_State* luaState);
+    bool parseMessage(const string& message, string& tag, event_params_t& paramDict, lua_State* luaState);
+    // replaces the regex list, builds its prefilter and compiles its lua code into luaState
+    void setRegexList(const vector<RegexStruct>& regexList, lua_State* luaState);
+    const vector<RegexStruct>& getRegexList() const { return m_regexList; }
+    static string requiredLiteral(const string& regexString);
+    // compiles lua code of all params into luaState, parseMessage does it when given another state
+    void loadLuaCode(lua_State* luaState);
+    // releases what loadLuaCode put in luaState, call before closing it
+    void unloadLuaCode(lua_State* luaState);
     SyslogParser();
+private:
+    vector<RegexStruct> m_regexList;
+    lua_State* m_luaState = NULL;
+    int m_envMetaRef = LUA_NOREF; // metatable of the per call environment, __index is _G
+    void buildPrefilter();
+    LiteralMatcher m_prefilter;
+    vector<char> m_candidates;
 };
 
 #endif
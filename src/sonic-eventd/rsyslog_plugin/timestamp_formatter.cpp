@@ -1,74 +1,136 @@
 #include <iostream>
+#include <cstring>
 #include <swss/logger.h>
 #include <swss/events.h>
 #include "timestamp_formatter.h"
 
 using namespace std;
 
-/***
- *
- * Formats given string into string needed by YANG model
- *
- * @param timestamp parsed from syslog message
- * @return formatted timestamp that conforms to YANG model
- *
- */
-
-static const unordered_map<string, string> g_monthDict {
-    { "Jan", "01" },
-    { "Feb", "02" },
-    { "Mar", "03" },
-    { "Apr", "04" },
-    { "May", "05" },
-    { "Jun", "06" },
-    { "Jul", "07" },
-    { "Aug", "08" },
-    { "Sep", "09" },
-    { "Oct", "10" },
-    { "Nov", "11" },
-    { "Dec", "12" }
-};
+static const char* monthNumber(const string& month) {
+    if(month.size() != 3) {
+        return NULL;
+    }
+    switch(month[0]) {
+        case 'J':
+            if(month == "Jan") return "01";
+            if(month == "Jun") return "06";
+            if(month == "Jul") return "07";
+            break;
+        case 'F':
+            if(month == "Feb") return "02";
+            break;
+        case 'M':
+            if(month == "Mar") return "03";
+            if(month == "May") return "05";
+            break;
+        case 'A':
+            if(month == "Apr") return "04";
+            if(month == "Aug") return "08";
+            break;
+        case 'S':
+            if(month == "Sep") return "09";
+            break;
+        case 'O':
+            if(month == "Oct") return "10";
+            break;
+        case 'N':
+            if(month == "Nov") return "11";
+            break;
+        case 'D':
+            if(month == "Dec") return "12";
+            break;
+    }
+    return NULL;
+}
 
-string TimestampFormatter::getYear(string timestamp) {
+const string& TimestampFormatter::getYear(const char* timestamp, size_t len) {
     if(!m_storedTimestamp.empty()) {
-        if(m_storedTimestamp.compare(timestamp) <= 0) {
-            m_storedTimestamp = timestamp;
+        if(m_storedTimestamp.compare(0, string::npos, timestamp, len) <= 0) {
+            m_storedTimestamp.assign(timestamp, len);
             return m_storedYear;
         }
     }
     // no last timestamp or year change
     time_t currentTime = time(nullptr);
-    tm* const localTime = localtime(&currentTime);
-    stringstream ss;
-    auto currentYear = 1900 + localTime->tm_year;
-    ss << currentYear; // get current year
-    string year = ss.str();
-    m_storedTimestamp = timestamp;
-    m_storedYear = year;
-    return year;
+    tm localTime;
+    localtime_r(&currentTime, &localTime);
+    m_storedTimestamp.assign(timestamp, len);
+    m_storedYear = to_string(1900 + localTime.tm_year);
+    return m_storedYear;
 }
 
+/***
+ *
+ * Formats given string into string needed by YANG model
+ *
+ * @param timestamp parsed from syslog message
+ * @return formatted timestamp that conforms to YANG model
+ *
+ */
+
 string TimestampFormatter::changeTimestampFormat(vector<string> dateComponents) {
     if(dateComponents.size() < 3) {
         SWSS_LOG_ERROR("Timestamp formatter unable to format due to invalid input");
         return "";
     }
-    string formattedTimestamp; // need to change format of Mmm dd hh:mm:ss.SSSSSS to YYYY-mm-ddThh:mm:ss.SSSSSSZ
-    string month;
-    auto it = g_monthDict.find(dateComponents[0]);
-    if(it != g_monthDict.end()) {
-        month = it->second;
-    } else {
+    return changeTimestampFormat(dateComponents[0], dateComponents[1], dateComponents[2]);
+}
+
+/***
+ *
+ * Changes Mmm dd hh:mm:ss.SSSSSS to YYYY-mm-ddThh:mm:ss.SSSSSSZ. Output is written
+ * into a fixed buffer and the part up to the second is reused while messages
+ * keep arriving within the same second.
+ *
+ */
+
+string TimestampFormatter::changeTimestampFormat(const string& month, const string& day, const string& time) {
+    const char* monthNum = monthNumber(month);
+    if(monthNum == NULL) {
         SWSS_LOG_ERROR("Timestamp month was given in wrong format.\n");
         return "";
     }
-    string day = dateComponents[1];
-    if(day.size() == 1) { // convert 1 -> 01
-       day.insert(day.begin(), '0');
+    // key is mmddhh:mm:ss.SSSSSS, compared against last one to detect year change
+    char key[TIMESTAMP_BUF_SIZE];
+    size_t dayLen = (day.size() == 1) ? 2 : day.size(); // convert 1 -> 01
+    size_t keyLen = 2 + dayLen + time.size();
+    if(keyLen > sizeof(key)) {
+        SWSS_LOG_ERROR("Timestamp formatter unable to format due to invalid input");
+        return "";
+    }
+    memcpy(key, monthNum, 2);
+    if(day.size() == 1) {
+        key[2] = '0';
+        key[3] = day[0];
+    } else {
+        memcpy(key + 2, day.data(), dayLen);
+    }
+    memcpy(key + 2 + dayLen, time.data(), time.size());
+
+    const string& year = getYear(key, keyLen);
+
+    size_t secondLen = min(time.size(), (size_t)8); // hh:mm:ss
+    size_t secondKeyLen = 2 + dayLen + secondLen;
+    if(m_prefixYear != year || m_prefixKey.compare(0, string::npos, key, secondKeyLen) != 0) {
+        m_prefix.assign(year);
+        m_prefix += '-';
+        m_prefix.append(key, 2);
+        m_prefix += '-';
+        m_prefix.append(key + 2, dayLen);
+        m_prefix += 'T';
+        m_prefix.append(time, 0, secondLen);
+        m_prefixYear.assign(year);
+        m_prefixKey.assign(key, secondKeyLen);
+    }
+
+    char buf[TIMESTAMP_BUF_SIZE * 2];
+    size_t len = m_prefix.size() + (time.size() - secondLen) + 1;
+    if(len > sizeof(buf)) {
+        SWSS_LOG_ERROR("Timestamp formatter unable to format due to invalid input");
+        return "";
     }
-    string time = dateComponents[2];
-    string currentTimestamp = month + day + time;
-    string year = getYear(currentTimestamp);
-    formattedTimestamp = year + "-" + month + "-" + day + "T" + time + "Z";
-    return formattedTimestamp;
+    memcpy(buf, m_prefix.data(), m_prefix.size());
+    memcpy(buf + m_prefix.size(), time.data() + secondLen, time.size() - secondLen);
+    buf[len - 1] = 'Z';
+    return string(buf, len);
 }
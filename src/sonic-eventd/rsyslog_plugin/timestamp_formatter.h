@@ -9,6 +9,8 @@
 
 using namespace std;
 
+#define TIMESTAMP_BUF_SIZE 64
+
 /***
  *
  * TimestampFormatter is responsible for formatting the timestamps received in syslog messages and to format them into the type needed by YANG model
@@ -18,10 +20,15 @@ using namespace std;
 class TimestampFormatter {
 public:
     string changeTimestampFormat(vector<string> dateComponents);
+    string changeTimestampFormat(const string& month, const string& day, const string& time);
     string m_storedTimestamp;
     string m_storedYear;
 private:
-    string getYear(string timestamp);
+    const string& getYear(const char* timestamp, size_t len);
+    // formatted YYYY-mm-ddThh:mm:ss of last second seen, with the year and key it was built from
+    string m_prefix;
+    string m_prefixYear;
+    string m_prefixKey;
 };
 
 #endif
@@ -9,6 +9,8 @@ extern "C"
 #include <memory>
 #include <regex>
 #include <thread>
+#include <chrono>
+#include <algorithm>
 #include <swss/events.h>
 #include "gtest/gtest.h"
 #include <nlohmann/json.hpp>
@@ -56,9 +58,9 @@ TEST(syslog_parser, matching_regex) {
     expectedDict["even_more_data"] = "test_data";
 
     unique_ptr<SyslogParser> parser(new SyslogParser());
-    parser->m_regexList = regexList;
     lua_State* luaState = luaL_newstate();
     luaL_openlibs(luaState);
+    parser->setRegexList(regexList, luaState);
 
     bool success = parser->parseMessage("message test_message other_data test_data even_more_data test_data", tag, paramDict, luaState);
     EXPECT_EQ(true, success);
@@ -92,9 +94,9 @@ TEST(syslog_parser, matching_regex_timestamp) {
     expectedDict["timestamp"] = g_stored_year + "-07-21T02:10:00.000000Z";
 
     unique_ptr<SyslogParser> parser(new SyslogParser());
-    parser->m_regexList = regexList;
     lua_State* luaState = luaL_newstate();
     luaL_openlibs(luaState);
+    parser->setRegexList(regexList, luaState);
 
     parser->m_timestampFormatter->m_storedTimestamp = "010100:00:00.000000";
     parser->m_timestampFormatter->m_storedYear = g_stored_year;
@@ -124,9 +126,9 @@ TEST(syslog_parser, no_matching_regex) {
     event_params_t paramDict;
 
     unique_ptr<SyslogParser> parser(new SyslogParser());
-    parser->m_regexList = regexList;
     lua_State* luaState = luaL_newstate();
     luaL_openlibs(luaState);
+    parser->setRegexList(regexList, luaState);
 
     bool success = parser->parseMessage("Test Message", tag, paramDict, luaState);
     EXPECT_EQ(false, success);
@@ -158,9 +160,9 @@ TEST(syslog_parser, lua_code_valid_1) {
     expectedDict["minor-code"] = "2";
 
     unique_ptr<SyslogParser> parser(new SyslogParser());
-    parser->m_regexList = regexList;
     lua_State* luaState = luaL_newstate();
     luaL_openlibs(luaState);
+    parser->setRegexList(regexList, luaState);
 
     bool success = parser->parseMessage("NOTIFICATION: sent to neighbor 100.95.147.229 active 2/2 (peer in wrong AS) 2 bytes", tag, paramDict, luaState);
     EXPECT_EQ(true, success);
@@ -195,9 +197,9 @@ TEST(syslog_parser, lua_code_valid_2) {
     expectedDict["timestamp"] = g_stored_year + "-12-03T12:36:24.503424Z";
 
     unique_ptr<SyslogParser> parser(new SyslogParser());
-    parser->m_regexList = regexList;
     lua_State* luaState = luaL_newstate();
     luaL_openlibs(luaState);
+    parser->setRegexList(regexList, luaState);
 
     parser->m_timestampFormatter->m_storedTimestamp = "010100:00:00.000000";
     parser->m_timestampFormatter->m_storedYear = g_stored_year;
@@ -209,6 +211,253 @@ TEST(syslog_parser, lua_code_valid_2) {
     lua_close(luaState);
 }
 
+TEST(syslog_parser, lua_code_cached) {
+    vector<RegexStruct> regexList;
+    string regexString = "^([a-zA-Z]{3})?\\s*([0-9]{1,2})?\\s*([0-9]{2}:[0-9]{2}:[0-9]{2}.[0-9]{0,6})?\\s*.* (sent|received) (?:to|from) neighbor ([0-9.]*) (up|down)";
+    vector<string> params = { "month", "day", "time", "is-sent", "ip", "status" };
+    string isSentCode = "ret=tostring(arg==\"sent\")";
+    vector<string> luaCodes = { "", "", "", isSentCode, "", "ret=(arg==\"up\")and\"1\"or\"0\"" };
+
+    RegexStruct rs = RegexStruct();
+    rs.tag = "test_tag";
+    rs.regexExpression = regex(regexString);
+    rs.params = createEventParams(params, luaCodes);
+    regexList.push_back(rs);
+
+    unique_ptr<SyslogParser> parser(new SyslogParser());
+    lua_State* luaState = luaL_newstate();
+    luaL_openlibs(luaState);
+    parser->setRegexList(regexList, luaState);
+    EXPECT_NE(LUA_NOREF, parser->getRegexList()[0].params[3].luaRef);
+    EXPECT_EQ(LUA_NOREF, parser->getRegexList()[0].params[4].luaRef);
+
+    string message = "NOTIFICATION: sent to neighbor 10.0.0.1 up";
+    event_params_t expectedDict;
+    expectedDict["is-sent"] = "true";
+    expectedDict["ip"] = "10.0.0.1";
+    expectedDict["status"] = "1";
+    for(int i = 0; i < 3; i++) {
+        string tag;
+        event_params_t paramDict;
+        EXPECT_TRUE(parser->parseMessage(message, tag, paramDict, luaState));
+        EXPECT_EQ(expectedDict, paramDict);
+    }
+    EXPECT_EQ(0, lua_gettop(luaState));
+
+    // calling the precompiled chunk against compiling it per call, same code and input
+    const int iterations = 20000;
+    ASSERT_EQ(0, luaL_loadstring(luaState, isSentCode.c_str()));
+    int chunkRef = luaL_ref(luaState, LUA_REGISTRYINDEX);
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++) {
+        lua_pushstring(luaState, "sent");
+        lua_setglobal(luaState, "arg");
+        lua_rawgeti(luaState, LUA_REGISTRYINDEX, chunkRef);
+        EXPECT_EQ(0, lua_pcall(luaState, 0, 0, 0));
+    }
+    double cachedSecs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++) {
+        lua_pushstring(luaState, "sent");
+        lua_setglobal(luaState, "arg");
+        EXPECT_EQ(0, luaL_dostring(luaState, isSentCode.c_str()));
+    }
+    double dostringSecs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    luaL_unref(luaState, LUA_REGISTRYINDEX, chunkRef);
+    EXPECT_EQ(0, lua_gettop(luaState));
+    cout << "lua_pcall of precompiled chunk: " << cachedSecs * 1e6 / iterations << " us/call" << endl;
+    cout << "luaL_dostring of same code: " << dostringSecs * 1e6 / iterations << " us/call" << endl;
+
+    // a replaced list is compiled again, the refs of the old one are released for reuse
+    vector<int> oldRefs = { parser->getRegexList()[0].params[3].luaRef, parser->getRegexList()[0].params[5].luaRef };
+    luaCodes[5] = "ret=(arg==\"up\")and\"yes\"or\"no\"";
+    rs.params = createEventParams(params, luaCodes);
+    parser->setRegexList({ rs }, luaState);
+    vector<int> newRefs = { parser->getRegexList()[0].params[3].luaRef, parser->getRegexList()[0].params[5].luaRef };
+    sort(oldRefs.begin(), oldRefs.end());
+    sort(newRefs.begin(), newRefs.end());
+    EXPECT_EQ(oldRefs, newRefs);
+    expectedDict["status"] = "yes";
+    {
+        string tag;
+        event_params_t paramDict;
+        EXPECT_TRUE(parser->parseMessage(message, tag, paramDict, luaState));
+        EXPECT_EQ(expectedDict, paramDict);
+    }
+
+    // another state needs the code compiled again
+    parser->unloadLuaCode(luaState);
+    EXPECT_EQ(LUA_NOREF, parser->getRegexList()[0].params[3].luaRef);
+    lua_close(luaState);
+    luaState = luaL_newstate();
+    luaL_openlibs(luaState);
+    string tag;
+    event_params_t paramDict;
+    EXPECT_TRUE(parser->parseMessage(message, tag, paramDict, luaState));
+    EXPECT_EQ(expectedDict, paramDict);
+
+    lua_close(luaState);
+}
+
+TEST(syslog_parser, lua_code_own_environment) {
+    string regexString = "^([a-zA-Z]{3})?\\s*([0-9]{1,2})?\\s*([0-9]{2}:[0-9]{2}:[0-9]{2}.[0-9]{0,6})?\\s*count (.*) other (.*)";
+    vector<string> params = { "month", "day", "time", "count", "other" };
+    // the first param keeps a global, the second one reads it
+    vector<string> luaCodes = { "", "", "", "seen=(seen or 0)+1 ret=tostring(seen)", "ret=tostring(seen)..arg" };
+
+    RegexStruct rs = RegexStruct();
+    rs.tag = "test_tag";
+    rs.regexExpression = regex(regexString);
+    rs.params = createEventParams(params, luaCodes);
+
+    unique_ptr<SyslogParser> parser(new SyslogParser());
+    lua_State* luaState = luaL_newstate();
+    luaL_openlibs(luaState);
+    parser->setRegexList({ rs }, luaState);
+
+    lua_pushstring(luaState, "global");
+    lua_setglobal(luaState, "ret");
+    for(int i = 0; i < 3; i++) {
+        string tag;
+        event_params_t paramDict;
+        EXPECT_TRUE(parser->parseMessage("count a other b", tag, paramDict, luaState));
+        // globals written by code do not outlive its call, _G is still read
+        EXPECT_EQ("1", paramDict["count"]);
+        EXPECT_EQ("nilb", paramDict["other"]);
+    }
+    lua_getglobal(luaState, "seen");
+    EXPECT_TRUE(lua_isnil(luaState, -1));
+    lua_getglobal(luaState, "ret");
+    EXPECT_STREQ("global", lua_tostring(luaState, -1));
+    lua_pop(luaState, 2);
+
+    lua_close(luaState);
+}
+
+TEST(syslog_parser, requiredLiteral) {
+    EXPECT_EQ(" admin state is set to ", SyslogParser::requiredLiteral("Peer .default\\|([0-9a-f:.]*[0-9a-f]*). admin state is set to .(up|down)."));
+    EXPECT_EQ("NOTIFICATION: ", SyslogParser::requiredLiteral(".*NOTIFICATION: (received|sent) (?:to|from) neighbor (.*)"));
+    EXPECT_EQ("de", SyslogParser::requiredLiteral("ab?c{2}de+f"));
+    EXPECT_EQ("", SyslogParser::requiredLiteral("up|down"));
+    EXPECT_EQ("", SyslogParser::requiredLiteral("(.*)"));
+    // coded chars end the run and take their operand with them
+    EXPECT_EQ("cdef", SyslogParser::requiredLiteral("ab\\x41cdef"));
+    EXPECT_EQ("cdef", SyslogParser::requiredLiteral("ab\\u0041cdef"));
+    EXPECT_EQ("bcd", SyslogParser::requiredLiteral("xy\\cAbcd"));
+    EXPECT_EQ("cde", SyslogParser::requiredLiteral("ab\\0cde"));
+    EXPECT_EQ("a.b", SyslogParser::requiredLiteral("a\\.b"));
+}
+
+TEST(syslog_parser, prefilter_coded_escapes) {
+    string timestampRegex = "^([a-zA-Z]{3})?\\s*([0-9]{1,2})?\\s*([0-9]{2}:[0-9]{2}:[0-9]{2}.[0-9]{0,6})?\\s*";
+    string eventRegex = "Port \\x45thernet([0-9]+) is \\u0064own";
+    vector<string> params = { "month", "day", "time", "port" };
+
+    RegexStruct rs = RegexStruct();
+    rs.tag = "port-down";
+    rs.regexExpression = regex(timestampRegex + eventRegex);
+    rs.params = createEventParams(params, vector<string>(params.size(), ""));
+    rs.literal = SyslogParser::requiredLiteral(eventRegex);
+    EXPECT_EQ("thernet", rs.literal);
+
+    unique_ptr<SyslogParser> parser(new SyslogParser());
+    lua_State* luaState = luaL_newstate();
+    luaL_openlibs(luaState);
+    parser->setRegexList({ rs }, luaState);
+
+    string tag;
+    event_params_t paramDict;
+    EXPECT_TRUE(parser->parseMessage("Port Ethernet4 is down", tag, paramDict, luaState));
+    EXPECT_EQ("port-down", tag);
+    EXPECT_EQ("4", paramDict["port"]);
+
+    // same number of regexes but other literals, a new list rebuilds the prefilter
+    rs.tag = "link-up";
+    rs.regexExpression = regex(timestampRegex + "Link ([a-z]+) is up");
+    rs.literal = SyslogParser::requiredLiteral("Link ([a-z]+) is up");
+    parser->setRegexList({ rs }, luaState);
+    tag.clear();
+    paramDict.clear();
+    EXPECT_TRUE(parser->parseMessage("Link lo is up", tag, paramDict, luaState));
+    EXPECT_EQ("link-up", tag);
+    EXPECT_EQ("lo", paramDict["port"]);
+
+    lua_close(luaState);
+}
+
+TEST(syslog_parser, prefilter_corpus) {
+    string timestampRegex = "^([a-zA-Z]{3})?\\s*([0-9]{1,2})?\\s*([0-9]{2}:[0-9]{2}:[0-9]{2}.[0-9]{0,6})?\\s*";
+    ifstream regexFile("./rsyslog_plugin_tests/test_regex_6.rc.json");
+    json jList = json::parse(regexFile);
+    vector<RegexStruct> regexList;
+    for(long unsigned int i = 0; i < jList.size(); i++) {
+        string eventRegex = jList[i]["regex"];
+        vector<string> params = jList[i]["params"];
+        params.insert(params.begin(), { "month", "day", "time" });
+        RegexStruct rs = RegexStruct();
+        rs.tag = jList[i]["tag"];
+        rs.regexExpression = regex(timestampRegex + eventRegex);
+        rs.params = createEventParams(params, vector<string>(params.size(), ""));
+        rs.literal = SyslogParser::requiredLiteral(eventRegex);
+        regexList.push_back(rs);
+    }
+
+    ifstream corpusFile("./rsyslog_plugin_tests/test_syslogs_corpus.txt");
+    vector<string> corpus;
+    string line;
+    while(getline(corpusFile, line)) {
+        corpus.push_back(line);
+    }
+    ASSERT_FALSE(corpus.empty());
+
+    lua_State* luaState = luaL_newstate();
+    luaL_openlibs(luaState);
+    unique_ptr<SyslogParser> filtered(new SyslogParser());
+    filtered->setRegexList(regexList, luaState);
+    // no literals to filter on, every regex is tried as before
+    vector<RegexStruct> unfilteredList = regexList;
+    for(auto& rs : unfilteredList) {
+        rs.literal.clear();
+    }
+    unique_ptr<SyslogParser> scanned(new SyslogParser());
+    scanned->setRegexList(unfilteredList, luaState);
+
+    const int rounds = 50;
+    int matched = 0;
+    double elapsed[2] = { 0, 0 };
+    SyslogParser* parsers[2] = { scanned.get(), filtered.get() };
+    vector<string> tags[2];
+    vector<event_params_t> dicts[2];
+    for(int p = 0; p < 2; p++) {
+        auto start = chrono::steady_clock::now();
+        for(int r = 0; r < rounds; r++) {
+            for(const auto& msg : corpus) {
+                string tag;
+                event_params_t paramDict;
+                parsers[p]->parseMessage(msg, tag, paramDict, luaState);
+                if(r == 0) {
+                    tags[p].push_back(tag);
+                    dicts[p].push_back(paramDict);
+                }
+            }
+        }
+        elapsed[p] = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+    EXPECT_EQ(tags[0], tags[1]);
+    EXPECT_EQ(dicts[0], dicts[1]);
+    for(const auto& tag : tags[1]) {
+        matched += tag.empty() ? 0 : 1;
+    }
+    EXPECT_LT(0, matched);
+
+    double lines = (double)rounds * corpus.size();
+    cout << "corpus " << corpus.size() << " lines, " << matched << " matching, " << regexList.size() << " regexes" << endl;
+    cout << "full scan: " << (long)(lines / elapsed[0]) << " lines/sec" << endl;
+    cout << "prefiltered: " << (long)(lines / elapsed[1]) << " lines/sec" << endl;
+
+    lua_close(luaState);
+}
+
 TEST(rsyslog_plugin, onInit_emptyJSON) {
     unique_ptr<RsyslogPlugin> plugin(new RsyslogPlugin("test_mod_name", "./rsyslog_plugin_tests/test_regex_1.rc.json"));
     EXPECT_NE(0, plugin->onInit());
@@ -264,6 +513,30 @@ TEST(rsyslog_plugin, run) {
     cin.rdbuf(cinbuf);
 }
 
+TEST(rsyslog_plugin, run_batched) {
+    unique_ptr<RsyslogPlugin> plugin(new RsyslogPlugin("test_mod_name", "./rsyslog_plugin_tests/test_regex_2.rc.json"));
+    EXPECT_EQ(0, plugin->onInit());
+    string adjChange = "Aug 17 02:46:42.615668 SN6-0101-0114-02T0 INFO bgp#bgpd[62]: %ADJCHANGE: neighbor 100.126.188.90 Up ";
+    const int lineCount = 5000;
+    string input;
+    for(int i = 0; i < lineCount; i++) {
+        input += adjChange + "\n";
+        if(i % 1000 == 0) {
+            input += "\n";
+        }
+    }
+    // line longer than a read chunk, and a last line without newline
+    input += string(RSYSLOG_READ_CHUNK_SIZE + 100, 'x') + "\n";
+    input += adjChange;
+
+    istringstream ss(input);
+    streambuf* cinbuf = cin.rdbuf();
+    cin.rdbuf(ss.rdbuf());
+    plugin->run();
+    cin.rdbuf(cinbuf);
+    EXPECT_EQ((uint64_t)lineCount + 1, plugin->getPublishCount());
+}
+
 TEST(rsyslog_plugin, run_SIGTERM) {
     unique_ptr<RsyslogPlugin> plugin(new RsyslogPlugin("test_mod_name", "./rsyslog_plugin_tests/test_regex_5.rc.json"));
     EXPECT_EQ(0, plugin->onInit());
@@ -310,6 +583,48 @@ TEST(timestampFormatter, changeTimestampFormat) {
     EXPECT_EQ("2025-12-31T23:59:59.000000Z", formattedTimestampThree);
 }
 
+TEST(timestampFormatter, sameSecondPrefix) {
+    unique_ptr<TimestampFormatter> formatter(new TimestampFormatter());
+    formatter->m_storedTimestamp = "010100:00:00.000000";
+    formatter->m_storedYear = g_stored_year;
+
+    EXPECT_EQ(g_stored_year + "-07-20T10:09:40.000001Z", formatter->changeTimestampFormat("Jul", "20", "10:09:40.000001"));
+    EXPECT_EQ(g_stored_year + "-07-20T10:09:40.5Z", formatter->changeTimestampFormat("Jul", "20", "10:09:40.5"));
+    EXPECT_EQ(g_stored_year + "-07-20T10:09:41Z", formatter->changeTimestampFormat("Jul", "20", "10:09:41"));
+    EXPECT_EQ(g_stored_year + "-07-21T10:09:41.000000Z", formatter->changeTimestampFormat("Jul", "21", "10:09:41.000000"));
+    EXPECT_EQ("072110:09:41.000000", formatter->m_storedTimestamp);
+
+    // cached prefix must follow a year change
+    formatter->m_storedYear = "2025";
+    EXPECT_EQ("2025-07-21T10:09:41.000001Z", formatter->changeTimestampFormat("Jul", "21", "10:09:41.000001"));
+    EXPECT_EQ("", formatter->changeTimestampFormat("Foo", "21", "10:09:41.000001"));
+    EXPECT_EQ("", formatter->changeTimestampFormat(vector<string>{ "Jul", "21" }));
+}
+
+TEST(timestampFormatter, throughput) {
+    unique_ptr<TimestampFormatter> formatter(new TimestampFormatter());
+    formatter->m_storedTimestamp = "010100:00:00.000000";
+    formatter->m_storedYear = g_stored_year;
+
+    const int iterations = 1000000;
+    string month = "Jul";
+    string day = "4";
+    char time[16];
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++) {
+        // a storm of 1000 messages per second
+        int second = i / 1000;
+        snprintf(time, sizeof(time), "%02d:%02d:%02d.%06d", (second / 3600) % 24, (second / 60) % 60, second % 60, (i % 1000) * 1000);
+        string formatted = formatter->changeTimestampFormat(month, day, time);
+        if(i == iterations - 1) {
+            EXPECT_EQ(g_stored_year + "-07-04T00:16:39.999000Z", formatted);
+        }
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(g_stored_year, formatter->m_storedYear);
+    cout << "timestamp formatter: " << (long)(iterations / elapsed) << " timestamps/sec" << endl;
+}
+
 int main(int argc, char* argv[]) {
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
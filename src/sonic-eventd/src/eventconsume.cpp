@@ -3,6 +3,7 @@
 #include <syslog.h>
 #include <limits>
 #include <queue>
+#include <unordered_set>
 #include <unistd.h>
 #include <swss/events_common.h>
 #include "eventconsume.h"
@@ -18,6 +19,9 @@ using namespace std::chrono;
 // map to store sequence-id for alarms
 unordered_map<string, uint64_t> cal_lookup_map;
 
+// map to store flood control token bucket, keyed like cal_lookup_map
+unordered_map<string, FloodBucket> flood_bucket_map;
+
 // temporary map to hold merge of default map of events and any event profile
 EventMap static_event_table;
 
@@ -27,8 +31,10 @@ volatile bool g_run = true;
 uint64_t seq_id = 0;
 uint64_t PURGE_SECONDS = 86400;
 
-typedef pair<uint64_t, uint64_t> pi;
-priority_queue<pi, vector<pi>, greater<pi> > event_history_list;
+EventHistoryList event_history_list;
+
+// sequence-ids of records in event history table that are acknowledged
+unordered_set<uint64_t> event_acked_set;
 
 map<string, int> SYSLOG_SEVERITY = {
     {EVENT_SEVERITY_CRITICAL_STR,      LOG_ALERT},
@@ -54,12 +60,23 @@ static string flood_ev_msg;
 EventConsume::EventConsume(DBConnector* dbConn,
                            string evProfile,
                            string dbProfile):
-    m_eventTable(dbConn, EVENT_HISTORY_TABLE_NAME),
-    m_alarmTable(dbConn, EVENT_CURRENT_ALARM_TABLE_NAME),
-    m_eventStatsTable(dbConn, EVENT_STATS_TABLE_NAME),
-    m_alarmStatsTable(dbConn, EVENT_ALARM_STATS_TABLE_NAME),
+    m_pipeline(dbConn),
+    m_eventTable(&m_pipeline, EVENT_HISTORY_TABLE_NAME, true),
+    m_alarmTable(&m_pipeline, EVENT_CURRENT_ALARM_TABLE_NAME, true),
+    m_eventStatsTable(&m_pipeline, EVENT_STATS_TABLE_NAME, true),
+    m_alarmStatsTable(&m_pipeline, EVENT_ALARM_STATS_TABLE_NAME, true),
     m_evProfile(evProfile),
-    m_dbProfile(dbProfile) {
+    m_dbProfile(dbProfile),
+    m_floodRate(EHT_FLOOD_RATE),
+    m_floodBurst(EHT_FLOOD_BURST),
+    m_eventStats(),
+    m_alarmStats(),
+    m_statsDirty(false),
+    m_pending(0),
+    m_lastFlush(steady_clock::now()),
+    m_lastPurge(steady_clock::now()),
+    m_purgeCount(0),
+    m_lastFloodReport(steady_clock::now()) {
 
     // open syslog connection
     openSyslog();
@@ -75,17 +92,29 @@ EventConsume::EventConsume(DBConnector* dbConn,
     // read default and custom profiles, build static_event_table
     read_eventd_config();
 
+    flush();
+
     SWSS_LOG_NOTICE("DONE WITH EventConsume constructor");
 }
 
 EventConsume::~EventConsume() {
 }
 
+void EventConsume::flush()
+{
+    if (m_statsDirty) {
+        writeStats();
+    }
+    m_pipeline.flush();
+    m_pending = 0;
+    m_lastFlush = steady_clock::now();
+}
+
 void EventConsume::run()
 {
 
     SWSS_LOG_ENTER();
-    event_handle_t hsub = events_init_subscriber(false, 1000);
+    event_handle_t hsub = events_init_subscriber(false, EVENTDB_FLUSH_INTERVAL_MS);
 
     if (hsub == nullptr) {
         SWSS_LOG_ERROR("Failed to initialize event subscriber");
@@ -103,14 +132,35 @@ void EventConsume::run()
         int rc = event_receive(hsub, evt);
         if (rc != 0) {
             if (rc == 11) {
-                // Timeout - loop will check g_run
+                // Timeout - write out anything pending; loop will check g_run
+                if (steady_clock::now() - m_lastFloodReport >= seconds(EHT_FLOOD_REPORT_SECS)) {
+                    reportFloodedEvents();
+                }
+                if (purge_due()) {
+                    purge_events();
+                } else if (m_pending > 0 || m_statsDirty) {
+                    flush();
+                }
                 continue;
             }
             SWSS_LOG_ERROR("Failed to receive rc=%d", rc);
             continue;
         }
         handle_notification(evt);
+
+        if (steady_clock::now() - m_lastFloodReport >= seconds(EHT_FLOOD_REPORT_SECS)) {
+            reportFloodedEvents();
+        }
+
+        if (purge_due()) {
+            // purge flushes too
+            purge_events();
+        } else if ((++m_pending >= EVENTDB_FLUSH_BATCH_SIZE) ||
+            (steady_clock::now() - m_lastFlush >= milliseconds(EVENTDB_FLUSH_INTERVAL_MS))) {
+            flush();
+        }
     }
+    flush();
     events_deinit_subscriber(hsub);
 }
 
@@ -152,6 +202,11 @@ void EventConsume::handle_notification(const event_receive_op_t& evt)
         return;
     }
 
+    // rate limit each source, so that one flapping source can not starve others
+    if (isRateLimited(ev_src, ev_act, ev_id)) {
+        return;
+    }
+
     // get static info
     if (!staticInfoExists(ev_id, ev_act, ev_sev, ev_static_msg, vec)) {
         return;
@@ -247,7 +302,7 @@ void EventConsume::handle_notification(const event_receive_op_t& evt)
     }
     // verify the size of history table; delete older entry; add new entry
     seq_id = new_seq_id;
-    update_events(to_string(seq_id), ev_timestamp, vec);
+    update_events(to_string(seq_id), ev_timestamp, vec, is_raise, is_clear);
 
     updateEventStatistics(true, is_raise, is_ack, is_clear);
 
@@ -265,158 +320,128 @@ void EventConsume::read_events() {
     SWSS_LOG_ENTER();
     // find out last sequence-id; build local history list
     for (auto tuple: tuples) {
+        EventHistoryEntry entry = {};
+        bool found = false;
+        bool is_ack = false;
+        char* end;
+
+        entry.seq = strtoull(kfvKey(tuple).c_str(), &end,10);
         for (auto fv: kfvFieldsValues(tuple)) {
             if (fvField(fv) == "time-created") {
-                char* end;
-                uint64_t seq = strtoull(kfvKey(tuple).c_str(), &end,10);
-                if (seq > seq_id) {
-                    seq_id = seq;
-                }
-                uint64_t val = strtoull(fvValue(fv).c_str(), &end,10);
-                event_history_list.push(make_pair( seq, val ));
+                entry.ts = strtoull(fvValue(fv).c_str(), &end,10);
+                found = true;
+            } else if (fvField(fv) == "action") {
+                entry.is_raise = (fvValue(fv) == EVENT_ACTION_RAISE_STR);
+                entry.is_clear = (fvValue(fv) == EVENT_ACTION_CLEAR_STR);
+            } else if (fvField(fv) == "acknowledged") {
+                is_ack = (fvValue(fv) == "true");
+            }
+        }
+        if (found) {
+            if (entry.seq > seq_id) {
+                seq_id = entry.seq;
+            }
+            event_history_list.push(entry);
+            if (is_ack) {
+                event_acked_set.insert(entry.seq);
             }
         }
     }
     SWSS_LOG_NOTICE("eventd sequence-id intialized to %lu", seq_id);
 }
 
+int64_t *EventConsume::alarmSeverityCounter(string sev) {
+    transform(sev.begin(), sev.end(), sev.begin(), ::toupper);
+    if (sev == EVENT_SEVERITY_CRITICAL_STR) {
+        return &m_alarmStats.critical;
+    } else if (sev == EVENT_SEVERITY_MAJOR_STR) {
+        return &m_alarmStats.major;
+    } else if (sev == EVENT_SEVERITY_MINOR_STR) {
+        return &m_alarmStats.minor;
+    } else if (sev == EVENT_SEVERITY_WARNING_STR) {
+        return &m_alarmStats.warning;
+    }
+    // there wont be any informational alarms
+    return nullptr;
+}
+
 void EventConsume::updateAlarmStatistics(string ev_sev, string ev_act) {
-    vector<FieldValueTuple> vec;
-    vector<FieldValueTuple> temp;
+    int64_t delta = ((ev_act.compare(EVENT_ACTION_RAISE_STR) == 0) ||
+                     (ev_act.compare(EVENT_ACTION_UNACK_STR) == 0)) ? 1 : -1;
 
-    // severity counter names are of lower case
-    transform(ev_sev.begin(), ev_sev.end(), ev_sev.begin(), ::tolower);
+    m_alarmStats.alarms += delta;
 
-    if (m_alarmStatsTable.get("state", vec)) {
-        for (auto fv: vec) {
-            if (!fv.first.compare("alarms")) {
-                if ((ev_act.compare(EVENT_ACTION_RAISE_STR) == 0) || (ev_act.compare(EVENT_ACTION_UNACK_STR) == 0)) {
-                    fv.second = to_string(stoi(fv.second.c_str())+1);
-                } else {
-                    fv.second = to_string(stoi(fv.second.c_str())-1);
-                }
-                temp.push_back(fv);
-            } else if (!fv.first.compare(ev_sev)) {
-                if ((ev_act.compare(EVENT_ACTION_RAISE_STR) == 0) || (ev_act.compare(EVENT_ACTION_UNACK_STR) == 0)) {
-                    fv.second = to_string(stoi(fv.second.c_str())+1);
-                } else {
-                    fv.second = to_string(stoi(fv.second.c_str())-1);
-                }
-                temp.push_back(fv);
-            } else if (!fv.first.compare("acknowledged")) {
-                if (ev_act.compare(EVENT_ACTION_ACK_STR) == 0)  {
-                    fv.second = to_string(stoi(fv.second.c_str())+1);
-                } else if (ev_act.compare(EVENT_ACTION_UNACK_STR) == 0) { 
-                    fv.second = to_string(stoi(fv.second.c_str())-1);
-                }
-                temp.push_back(fv);
-            }
-        }
-        m_alarmStatsTable.set("state", temp);
-    } else {
-        SWSS_LOG_ERROR("Can not update alarm statistics (table does not exist)");
+    int64_t *sev_counter = alarmSeverityCounter(ev_sev);
+    if (sev_counter != nullptr) {
+        *sev_counter += delta;
     }
+
+    if (ev_act.compare(EVENT_ACTION_ACK_STR) == 0)  {
+        m_alarmStats.acknowledged++;
+    } else if (ev_act.compare(EVENT_ACTION_UNACK_STR) == 0) {
+        m_alarmStats.acknowledged--;
+    }
+    m_statsDirty = true;
 }
 
 void EventConsume::updateEventStatistics(bool is_add, bool is_raise, bool is_ack, bool is_clear) {
-    vector<FieldValueTuple> vec;
-    vector<FieldValueTuple> temp;
-
-    if (m_eventStatsTable.get("state", vec)) {
-        for (auto fv: vec) {
-            if (!fv.first.compare("events")) {
-                if (is_add) {
-                    fv.second = to_string(stoi(fv.second.c_str())+1);
-                } else {
-                    fv.second = to_string(stoi(fv.second.c_str())-1);
-                }
-            } else if (!fv.first.compare("raised")) {
-                if (is_raise) {
-                    if (is_add) {
-                        fv.second = to_string(stoi(fv.second.c_str())+1);
-                    } else {
-                        fv.second = to_string(stoi(fv.second.c_str())-1);
-                    }
-                }
-            } else if (!fv.first.compare("cleared")) {
-                if (is_clear) {
-                    if (is_add) {
-                        fv.second = to_string(stoi(fv.second.c_str())+1);
-                    } else {
-                        fv.second = to_string(stoi(fv.second.c_str())-1);
-                    }
-                }
-            } else if (!fv.first.compare("acked")) {
-                if (is_ack) {
-                    if (is_add) {
-                        fv.second = to_string(stoi(fv.second.c_str())+1);
-                    } else {
-                        fv.second = to_string(stoi(fv.second.c_str())-1);
-                    }
-                }
-            }
-            temp.push_back(fv);
-        }
+    int64_t delta = is_add ? 1 : -1;
 
-        m_eventStatsTable.set("state", temp);
-    } else {
-        SWSS_LOG_ERROR("Can not update event statistics (table does not exist)");
+    m_eventStats.events += delta;
+    if (is_raise) {
+        m_eventStats.raised += delta;
+    }
+    if (is_clear) {
+        m_eventStats.cleared += delta;
     }
+    if (is_ack) {
+        m_eventStats.acked += delta;
+    }
+    m_statsDirty = true;
 }
 
-void EventConsume::modifyEventStats(string seq_id) { 
-    vector<FieldValueTuple> rec;
-    m_eventTable.get(seq_id, rec);
-    bool is_raise = false;
-    bool is_clear = false;
-    bool is_ack = false;
-    for (auto fvr: rec) {
-        if (!fvr.first.compare("action")) {
-            if (!fvr.second.compare(EVENT_ACTION_RAISE_STR)) {
-                is_raise = true;
-            } else if (!fvr.second.compare(EVENT_ACTION_CLEAR_STR)) {
-                is_clear = true;
-            }
-        }
-        if (!fvr.first.compare("acknowledged")) {
-            if (!fvr.second.compare("true")) {
-                is_ack = true;
-            }
-        }
-    }
-    updateEventStatistics(false, is_raise, is_ack, is_clear);
+bool EventConsume::purge_due() const {
+    return (event_history_list.size() >= static_cast<size_t>(m_count) + EVENTDB_PURGE_SLACK) ||
+           (steady_clock::now() - m_lastPurge >= milliseconds(EVENTDB_PURGE_INTERVAL_MS));
 }
 
 void EventConsume::purge_events() {
-
-    uint32_t size = event_history_list.size();
-
-    while (size >= m_count) {
-        pair <uint64_t,uint64_t> oldest_entry = event_history_list.top();
-        SWSS_LOG_NOTICE("Rollover based on count(%d/%d). Deleting %lu", size, m_count, oldest_entry.first);
-        modifyEventStats(to_string(oldest_entry.first));
-        m_eventTable.del(to_string(oldest_entry.first));
-        event_history_list.pop();
-        --size;
-    }
+    size_t size = event_history_list.size();
+    size_t by_count = 0;
+    size_t by_time = 0;
 
     const auto p1 = system_clock::now();
     uint64_t tnow_seconds = duration_cast<seconds>(p1.time_since_epoch()).count();
 
+    // Queue deletes of all expired records into the pipeline and send them
+    // as one batch, rather than a delete per incoming event.
     while (!event_history_list.empty()) {
-        pair <uint64_t,uint64_t> oldest_entry = event_history_list.top();
-	    uint64_t old_seconds = oldest_entry.second / 1000000000ULL;
-
-        if ((tnow_seconds - old_seconds) > PURGE_SECONDS) {
-            SWSS_LOG_NOTICE("Rollover based on time (%u days). Deleting %lu.. now %lu old %lu", m_days, oldest_entry.second, tnow_seconds, old_seconds);
-            modifyEventStats(to_string(oldest_entry.first));
-            m_eventTable.del(to_string(oldest_entry.first));
-            event_history_list.pop();
+        const EventHistoryEntry &oldest_entry = event_history_list.top();
+        uint64_t old_seconds = oldest_entry.ts / 1000000000ULL;
+
+        if (size > m_count) {
+            ++by_count;
+        } else if ((tnow_seconds - old_seconds) > PURGE_SECONDS) {
+            ++by_time;
         } else {
-            return;
+            break;
         }
+
+        bool is_ack = (event_acked_set.erase(oldest_entry.seq) > 0);
+        updateEventStatistics(false, oldest_entry.is_raise, is_ack, oldest_entry.is_clear);
+        m_eventTable.del(to_string(oldest_entry.seq));
+        event_history_list.pop();
+        --size;
     }
-    return;
+
+    if (by_count || by_time) {
+        SWSS_LOG_NOTICE("Rollover deleted %zu records based on count(%zu/%u) and %zu based on time (%u days)",
+                        by_count, size, m_count, by_time, m_days);
+    }
+
+    ++m_purgeCount;
+    m_lastPurge = steady_clock::now();
+    flush();
 }
 
 void EventConsume::read_config_and_purge() {
@@ -426,6 +451,10 @@ void EventConsume::read_config_and_purge() {
     parse_config(m_dbProfile.c_str(), m_days, m_count);
     SWSS_LOG_NOTICE("max-days %d max-records %d", m_days, m_count);
 
+    parse_flood_config(m_dbProfile.c_str(), m_floodRate, m_floodBurst);
+    SWSS_LOG_NOTICE("flood-rate %d flood-burst %d", m_floodRate, m_floodBurst);
+    flood_bucket_map.clear();
+
     // calculate purge interval in seconds, 84600 seconds per day
     PURGE_SECONDS = static_cast<uint64_t>(m_days) * 86400;
 
@@ -433,62 +462,55 @@ void EventConsume::read_config_and_purge() {
     purge_events();
 }
 
-void EventConsume::update_events(string seq_id, string ts, vector<FieldValueTuple> vec) {
-    // purge events based on # of days
-    purge_events();
-
-    // now add the event to the event table
+void EventConsume::update_events(string seq_id, string ts, vector<FieldValueTuple> vec,
+                                 bool is_raise, bool is_clear) {
+    // add the event to the event table; older records are purged in bulk by run()
     m_eventTable.set(seq_id, vec);
 
     // store it into the event history list
     char* end;
-    uint64_t seq = strtoull(seq_id.c_str(), &end, 10);
-    uint64_t val = strtoull(ts.c_str(), &end, 10);
-    event_history_list.push(make_pair( seq, val ));
+    EventHistoryEntry entry = {};
+    entry.seq = strtoull(seq_id.c_str(), &end, 10);
+    entry.ts = strtoull(ts.c_str(), &end, 10);
+    entry.is_raise = is_raise;
+    entry.is_clear = is_clear;
+    event_history_list.push(entry);
 }
 
 void EventConsume::resetAlarmStats(int alarms, int critical, int major, int minor, int warning, int acknowledged) {
-    vector<FieldValueTuple> temp;
-    FieldValueTuple fv;
-    map<int, string>::iterator it;
-    for (it = SYSLOG_SEVERITY_STR.begin(); it != SYSLOG_SEVERITY_STR.end(); it++) {
-        // there wont be any informational alarms
-        if (it->second.compare(EVENT_SEVERITY_CRITICAL_STR) == 0) {
-            fv = FieldValueTuple("critical", to_string(critical));
-            temp.push_back(fv);
-        } else if (it->second.compare(EVENT_SEVERITY_MAJOR_STR) == 0) {
-            fv = FieldValueTuple("major", to_string(major));
-            temp.push_back(fv);
-        } else if (it->second.compare(EVENT_SEVERITY_MINOR_STR) == 0) {
-            fv = FieldValueTuple("minor", to_string(minor));
-            temp.push_back(fv);
-        } else if (it->second.compare(EVENT_SEVERITY_WARNING_STR) == 0) {
-            fv = FieldValueTuple("warning", to_string(warning));
-            temp.push_back(fv);
-        }
-    }
-    fv = FieldValueTuple("alarms", to_string(alarms));
-    temp.push_back(fv);
-    fv = FieldValueTuple("acknowledged", to_string(acknowledged));
-    temp.push_back(fv);
-    m_alarmStatsTable.set("state", temp);
+    m_alarmStats.alarms = alarms;
+    m_alarmStats.critical = critical;
+    m_alarmStats.major = major;
+    m_alarmStats.minor = minor;
+    m_alarmStats.warning = warning;
+    m_alarmStats.acknowledged = acknowledged;
+    m_statsDirty = true;
 }
 
 void EventConsume::clearAckAlarmStatistic() {
-    vector<FieldValueTuple> vec;
+    m_alarmStats.acknowledged--;
+    m_statsDirty = true;
+}
+
+void EventConsume::writeStats() {
     vector<FieldValueTuple> temp;
 
-    if (m_alarmStatsTable.get("state", vec)) {
-        bool ack_found = false;
-        for (auto fv: vec) {
-            if (!ack_found && !fv.first.compare("acknowledged")) {
-                fv.second = to_string(stoi(fv.second.c_str())-1);
-                ack_found = true;
-            }
-            temp.push_back(fv);
-        }
-        m_alarmStatsTable.set("state", temp);
-    }
+    temp.push_back(FieldValueTuple("events", to_string(m_eventStats.events)));
+    temp.push_back(FieldValueTuple("raised", to_string(m_eventStats.raised)));
+    temp.push_back(FieldValueTuple("cleared", to_string(m_eventStats.cleared)));
+    temp.push_back(FieldValueTuple("acked", to_string(m_eventStats.acked)));
+    m_eventStatsTable.set("state", temp);
+
+    temp.clear();
+    temp.push_back(FieldValueTuple("critical", to_string(m_alarmStats.critical)));
+    temp.push_back(FieldValueTuple("major", to_string(m_alarmStats.major)));
+    temp.push_back(FieldValueTuple("minor", to_string(m_alarmStats.minor)));
+    temp.push_back(FieldValueTuple("warning", to_string(m_alarmStats.warning)));
+    temp.push_back(FieldValueTuple("alarms", to_string(m_alarmStats.alarms)));
+    temp.push_back(FieldValueTuple("acknowledged", to_string(m_alarmStats.acknowledged)));
+    m_alarmStatsTable.set("state", temp);
+
+    m_statsDirty = false;
 }
 
 
@@ -539,6 +561,101 @@ bool EventConsume::isFloodedEvent(string ev_src, string ev_act, string ev_id, st
     return false;
 }
 
+bool EventConsume::isRateLimited(const string &ev_src, const string &ev_act, const string &ev_id) {
+    string key = ev_id;
+    if (!ev_src.empty()) {
+        key += "|" + ev_src;
+    }
+
+    bool is_raise = (ev_act.compare(EVENT_ACTION_RAISE_STR) == 0);
+    if (ev_act.compare(EVENT_ACTION_CLEAR_STR) == 0) {
+        // a clear is dropped only along with its raise, when there is no alarm left for it to clear
+        auto it = flood_bucket_map.find(key);
+        if ((it == flood_bucket_map.end()) || !it->second.raise_dropped || cal_lookup_map.count(key)) {
+            return false;
+        }
+        it->second.raise_dropped = false;
+        it->second.suppressed++;
+        return true;
+    }
+    // otherwise only events & alarm raise are limited; dropping an ack would leave alarm table stale
+    if (!ev_act.empty() && !is_raise) {
+        return false;
+    }
+
+    unsigned int rate = m_floodRate;
+    unsigned int burst = m_floodBurst;
+    auto itc = static_event_table.find(ev_id);
+    if (itc != static_event_table.end()) {
+        if (itc->second.flood_rate != EHT_FLOOD_UNSET) {
+            rate = (unsigned int)itc->second.flood_rate;
+        }
+        if (itc->second.flood_burst != EHT_FLOOD_UNSET) {
+            burst = (unsigned int)itc->second.flood_burst;
+        }
+    }
+    if (rate == 0) {
+        return false;
+    }
+    if (burst == 0) {
+        burst = 1;
+    }
+
+    const auto now = steady_clock::now();
+    auto it = flood_bucket_map.find(key);
+    if (it == flood_bucket_map.end()) {
+        it = flood_bucket_map.emplace(key, FloodBucket{(double)burst, now, 0, false}).first;
+    }
+
+    FloodBucket &bucket = it->second;
+    double elapsed = duration<double>(now - bucket.last).count();
+    bucket.tokens = min((double)burst, bucket.tokens + elapsed * rate);
+    bucket.last = now;
+
+    if (bucket.tokens < 1.0) {
+        if (bucket.suppressed++ == 0) {
+            SWSS_LOG_NOTICE("Rate limiting event %s from %s; over %u/sec burst %u",
+                            ev_id.c_str(), ev_src.c_str(), rate, burst);
+        }
+        if (is_raise) {
+            bucket.raise_dropped = true;
+        }
+        return true;
+    }
+    bucket.tokens -= 1.0;
+    if (is_raise) {
+        bucket.raise_dropped = false;
+    }
+    return false;
+}
+
+void EventConsume::reportFloodedEvents() {
+    const auto now = steady_clock::now();
+    auto interval = duration_cast<seconds>(now - m_lastFloodReport).count();
+
+    for (auto it = flood_bucket_map.begin(); it != flood_bucket_map.end(); ) {
+        FloodBucket &bucket = it->second;
+        if (bucket.suppressed > 0) {
+            string ev_id = it->first.substr(0, it->first.find('|'));
+            string ev_src = (it->first.size() > ev_id.size()) ? it->first.substr(ev_id.size() + 1) : "";
+            string msg = "suppressed " + to_string(bucket.suppressed) + " events in last " +
+                         to_string(interval) + " seconds";
+
+            SWSS_LOG_WARN("Event %s from %s: %s", ev_id.c_str(), ev_src.c_str(), msg.c_str());
+            writeToSyslog(ev_id.c_str(), LOG_WARNING, "EVENT", "", ev_src.c_str(), msg.c_str(), "flood control:");
+            bucket.suppressed = 0;
+            ++it;
+        } else if (!bucket.raise_dropped &&
+                   (duration_cast<seconds>(now - bucket.last).count() >= EHT_FLOOD_REPORT_SECS)) {
+            // idle for a whole interval; its bucket would be full again. Kept while its clear is to be dropped
+            it = flood_bucket_map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_lastFloodReport = now;
+}
+
 bool EventConsume::staticInfoExists(string &ev_id, string &ev_act, string &ev_sev, string &ev_static_msg, vector<FieldValueTuple> &vec) {
     auto it = static_event_table.find(ev_id);
     if (it != static_event_table.end()) {
@@ -604,23 +721,44 @@ void EventConsume::initStats() {
     vector<FieldValueTuple> vec;
     // possible after a cold-boot or very first time
     if (! m_eventStatsTable.get("state", vec)) {
-        FieldValueTuple fv;
-        vector<FieldValueTuple> temp;
-
         SWSS_LOG_DEBUG("resetting Event Statistics table");
-        fv = FieldValueTuple("events", to_string(0));
-        temp.push_back(fv);
-        fv = FieldValueTuple("raised", to_string(0));
-        temp.push_back(fv);
-        fv = FieldValueTuple("cleared", to_string(0));
-        temp.push_back(fv);
-        fv = FieldValueTuple("acked", to_string(0));
-        temp.push_back(fv);
-        m_eventStatsTable.set("state", temp);
+        m_eventStats = EventStats();
+        m_statsDirty = true;
+    } else {
+        for (const auto &fv: vec) {
+            int64_t val = strtoll(fv.second.c_str(), nullptr, 10);
+            if (!fv.first.compare("events")) {
+                m_eventStats.events = val;
+            } else if (!fv.first.compare("raised")) {
+                m_eventStats.raised = val;
+            } else if (!fv.first.compare("cleared")) {
+                m_eventStats.cleared = val;
+            } else if (!fv.first.compare("acked")) {
+                m_eventStats.acked = val;
+            }
+        }
     }
+    vec.clear();
     if (! m_alarmStatsTable.get("state", vec)) {
         SWSS_LOG_DEBUG("resetting Alarm Statistics table");
         resetAlarmStats(0, 0, 0, 0, 0, 0);
+    } else {
+        for (const auto &fv: vec) {
+            int64_t val = strtoll(fv.second.c_str(), nullptr, 10);
+            if (!fv.first.compare("alarms")) {
+                m_alarmStats.alarms = val;
+            } else if (!fv.first.compare("acknowledged")) {
+                m_alarmStats.acknowledged = val;
+            } else {
+                int64_t *sev_counter = alarmSeverityCounter(fv.first);
+                if (sev_counter != nullptr) {
+                    *sev_counter = val;
+                }
+            }
+        }
+    }
+    if (m_statsDirty) {
+        writeStats();
     }
 }
 
@@ -640,6 +778,13 @@ void EventConsume::updateAckInfo(bool is_ack, string ev_timestamp, string ev_sev
     // for ack/unack, ev_src contains the "seq-id"
     m_alarmTable.set(ev_src, ack_vec);
     m_eventTable.set(ev_src, ack_vec);
+
+    uint64_t raise_seq = strtoull(ev_src.c_str(), nullptr, 10);
+    if (is_ack) {
+        event_acked_set.insert(raise_seq);
+    } else {
+        event_acked_set.erase(raise_seq);
+    }
 }
 
 
@@ -3,14 +3,70 @@
 
 #include <string>
 #include <map>
+#include <queue>
+#include <vector>
+#include <chrono>
 #include <swss/events.h>
 #include <swss/dbconnector.h>
+#include <swss/redispipeline.h>
 #include <swss/subscriberstatetable.h>
 #include "eventutils.h"
 
 extern std::atomic<bool> reload_config_flag;
 extern volatile bool g_run;
 
+// Writes to EVENT_DB are queued and flushed as one pipelined batch, every
+// EVENTDB_FLUSH_BATCH_SIZE events or EVENTDB_FLUSH_INTERVAL_MS, whichever
+// is hit first.
+constexpr uint32_t EVENTDB_FLUSH_BATCH_SIZE = 64;
+constexpr int EVENTDB_FLUSH_INTERVAL_MS = 1000;
+
+// Event history table is purged in bulk, every EVENTDB_PURGE_INTERVAL_MS or
+// once it grows EVENTDB_PURGE_SLACK past its max-records limit.
+constexpr int EVENTDB_PURGE_INTERVAL_MS = 1000;
+constexpr uint32_t EVENTDB_PURGE_SLACK = 256;
+
+// Index entry of an event history table record. Flags needed to adjust
+// statistics are held here, so that purge need not read the record back.
+typedef struct EventHistoryEntry_t {
+    uint64_t seq;
+    uint64_t ts;
+    bool is_raise;
+    bool is_clear;
+
+    bool operator>(const EventHistoryEntry_t &other) const {
+        return seq > other.seq;
+    }
+} EventHistoryEntry;
+
+// Min-heap by sequence-id, hence oldest record at the top
+typedef std::priority_queue<EventHistoryEntry, std::vector<EventHistoryEntry>,
+        std::greater<EventHistoryEntry> > EventHistoryList;
+
+// Token bucket of one (type-id, resource) pair for flood control
+typedef struct FloodBucket_t {
+    double tokens;
+    std::chrono::steady_clock::time_point last;
+    uint64_t suppressed;
+    bool raise_dropped;    // last alarm raise was dropped, so is its clear
+} FloodBucket;
+
+typedef struct EventStats_t {
+    int64_t events;
+    int64_t raised;
+    int64_t cleared;
+    int64_t acked;
+} EventStats;
+
+typedef struct AlarmStats_t {
+    int64_t alarms;
+    int64_t critical;
+    int64_t major;
+    int64_t minor;
+    int64_t warning;
+    int64_t acknowledged;
+} AlarmStats;
+
 class EventConsume
 {
 public:
@@ -20,31 +76,51 @@ public:
     ~EventConsume();
     void read_eventd_config(bool read_all=true);
     void run();
+    void flush();
+    void purge_events();
+    uint64_t getPurgeCount() const { return m_purgeCount; }
 
 private:
+    // Shared by all tables below, so that queued writes stay in order
+    swss::RedisPipeline m_pipeline;
     swss::Table m_eventTable;
     swss::Table m_alarmTable;
     swss::Table m_eventStatsTable;
     swss::Table m_alarmStatsTable;
     u_int32_t m_days, m_count;
+    u_int32_t m_floodRate, m_floodBurst;
     std::string m_evProfile;
     std::string m_dbProfile;
 
+    // Statistics are kept here and written out on flush
+    EventStats m_eventStats;
+    AlarmStats m_alarmStats;
+    bool m_statsDirty;
+    uint32_t m_pending;
+    std::chrono::steady_clock::time_point m_lastFlush;
+    std::chrono::steady_clock::time_point m_lastPurge;
+    uint64_t m_purgeCount;
+    std::chrono::steady_clock::time_point m_lastFloodReport;
+
     void handle_notification(const event_receive_op_t& evt);
     void read_events();
     void updateAlarmStatistics(std::string ev_sev, std::string ev_act);
     void updateEventStatistics(bool is_add, bool is_alarm, bool is_ack, bool is_clear);
     void read_config_and_purge();
-    void update_events(std::string seq_id, std::string ts, std::vector<swss::FieldValueTuple> vec);
-    void purge_events();
-    void modifyEventStats(std::string seq_id);
+    void update_events(std::string seq_id, std::string ts, std::vector<swss::FieldValueTuple> vec,
+                       bool is_raise, bool is_clear);
+    bool purge_due() const;
     void clearAckAlarmStatistic();
     void resetAlarmStats(int, int, int, int, int, int);
     void fetchFieldValues(const event_receive_op_t& evt , std::vector<swss::FieldValueTuple> &, std::string &, std::string &, std::string &, std::string &, std::string &);
     bool isFloodedEvent(std::string, std::string, std::string, std::string);
+    bool isRateLimited(const std::string &, const std::string &, const std::string &);
+    void reportFloodedEvents();
     bool staticInfoExists(std::string &, std::string &, std::string &, std::string &, std::vector<swss::FieldValueTuple> &);
     bool udpateLocalCacheAndAlarmTable(std::string, bool &);
     void initStats();
+    void writeStats();
+    int64_t *alarmSeverityCounter(std::string sev);
     void updateAckInfo(bool, std::string, std::string, std::string, std::string);
     bool fetchRaiseInfo(std::vector<swss::FieldValueTuple> &, std::string, std::string &, std::string &, std::string &, std::string &, std::string &);
 };
@@ -1,5 +1,6 @@
 #include <thread>
 #include <memory>
+#include <cstring>
 #include <swss/dbconnector.h>
 #include "eventd.h"
 #include "zmq.h"
@@ -27,11 +28,6 @@
 using namespace std;
 using namespace swss;
 
-#define MB(N) ((N) * 1024 * 1024)
-#define EVT_SIZE_AVG 150
-
-#define MAX_CACHE_SIZE (MB(100) / (EVT_SIZE_AVG))
-
 /* Count of elements returned in each read */
 #define READ_SET_SIZE 100
 
@@ -124,6 +120,7 @@ out:
 
 
 stats_collector::stats_collector() :
+    m_write_interval_ms(STATS_WRITE_INTERVAL_MS), m_stats_writes(0),
     m_shutdown(false), m_pause_heartbeat(false), m_heartbeats_published(0),
     m_heartbeats_interval_cnt(0)
 {
@@ -198,10 +195,24 @@ out:
 void
 stats_collector::run_writer()
 {
+    unique_lock<mutex> lock(m_write_mutex);
+
     while (true) {
-        if (m_updated.exchange(false)) {
-            /* Update if there had been any update */
+        /* Sleep until a counter changes; no periodic wake up when idle */
+        m_write_cv.wait(lock, [this] { return m_updated || m_shutdown; });
 
+        /* Coalesce updates that arrive within the interval */
+        if (!m_shutdown) {
+            m_write_cv.wait_for(lock, chrono::milliseconds(m_write_interval_ms),
+                    [this] { return m_shutdown.load(); });
+        }
+
+        /*
+         * Always do an update if needed before checking shutdown flag,
+         * as any counters collected during the wait needs to be updated.
+         */
+        if (m_updated.exchange(false)) {
+            lock.unlock();
             for (int i = 0; i < COUNTERS_EVENTS_TOTAL; ++i) {
                 vector<FieldValueTuple> fv;
 
@@ -209,17 +220,14 @@ stats_collector::run_writer()
 
                 m_stats_table->set(counter_keys[i], fv);
             }
+            ++m_stats_writes;
+            lock.lock();
         }
         if (m_shutdown) {
             break;
         }
-        this_thread::sleep_for(chrono::milliseconds(10));
-        /*
-         * After sleep always do an update if needed before checking
-         * shutdown flag, as any counters collected during sleep
-         * needs to be updated.
-         */
     }
+    lock.unlock();
 
     m_stats_table.reset();
     m_counters_db.reset();
@@ -309,9 +317,143 @@ out:
 
     events_deinit_subscriber(subs_handle);
     events_deinit_publisher(pub_handle);
-    m_shutdown = true;
+    _set_shutdown();
+}
+
+event_cache_t::event_cache_t(size_t max_bytes, int max_cnt) :
+    m_capacity(max_bytes), m_max_cnt(max_cnt), m_head(0), m_tail(0),
+    m_end(0), m_wrapped(false), m_used(0), m_cnt(0)
+{
+    /*
+     * Default-initialized; pages are not touched until an event is
+     * written, hence an idle cache costs only the address space.
+     */
+    if (m_capacity > 0) {
+        m_buf.reset(new char[m_capacity]);
+    }
+}
+
+
+bool
+event_cache_t::push(const char *data, size_t len)
+{
+    size_t need = CACHE_REC_HDR_SIZE + len;
+    size_t off;
+    uint32_t hdr = (uint32_t)len;
+
+    if (full() || (len > UINT32_MAX) || (need > m_capacity)) {
+        return false;
+    }
+
+    if (m_cnt == 0) {
+        m_head = m_tail = m_end = 0;
+        m_wrapped = false;
+    }
+
+    if (!m_wrapped) {
+        if ((m_capacity - m_tail) < need) {
+            /* No room at end; restart from the top, if free */
+            if (m_head < need) {
+                return false;
+            }
+            m_end = m_tail;
+            m_tail = 0;
+            m_wrapped = true;
+        }
+    }
+    else if ((m_head - m_tail) < need) {
+        return false;
+    }
+
+    off = m_tail;
+    memcpy(m_buf.get() + off, &hdr, CACHE_REC_HDR_SIZE);
+    memcpy(m_buf.get() + off + CACHE_REC_HDR_SIZE, data, len);
+    m_tail = off + need;
+    m_used += need;
+    ++m_cnt;
+    return true;
+}
+
+
+bool
+event_cache_t::front(const char *&data, size_t &len) const
+{
+    uint32_t hdr;
+
+    if (m_cnt == 0) {
+        return false;
+    }
+    memcpy(&hdr, m_buf.get() + m_head, CACHE_REC_HDR_SIZE);
+    data = m_buf.get() + m_head + CACHE_REC_HDR_SIZE;
+    len = hdr;
+    return true;
+}
+
+
+void
+event_cache_t::pop()
+{
+    uint32_t hdr;
+
+    if (m_cnt == 0) {
+        return;
+    }
+    memcpy(&hdr, m_buf.get() + m_head, CACHE_REC_HDR_SIZE);
+    m_head += CACHE_REC_HDR_SIZE + hdr;
+    m_used -= CACHE_REC_HDR_SIZE + hdr;
+
+    if (--m_cnt == 0) {
+        m_head = m_tail = m_end = 0;
+        m_wrapped = false;
+    }
+    else if (m_wrapped && (m_head == m_end)) {
+        m_head = 0;
+        m_end = 0;
+        m_wrapped = false;
+    }
+}
+
+
+int
+event_cache_t::read(int cnt, event_serialized_lst_t &lst)
+{
+    int i = 0;
+    const char *data;
+    size_t len;
+
+    for (; (i < cnt) && front(data, len); ++i) {
+        lst.emplace_back(data, len);
+        pop();
+    }
+    return i;
+}
+
+
+void
+event_cache_t::clear()
+{
+    m_head = m_tail = m_end = 0;
+    m_wrapped = false;
+    m_used = 0;
+    m_cnt = 0;
+}
+
+
+void
+event_cache_t::swap(event_cache_t &other)
+{
+    std::swap(m_buf, other.m_buf);
+    std::swap(m_capacity, other.m_capacity);
+    std::swap(m_max_cnt, other.m_max_cnt);
+    std::swap(m_head, other.m_head);
+    std::swap(m_tail, other.m_tail);
+    std::swap(m_end, other.m_end);
+    std::swap(m_wrapped, other.m_wrapped);
+    std::swap(m_used, other.m_used);
+    std::swap(m_cnt, other.m_cnt);
 }
 
+
 capture_service::~capture_service()
 {
     stop_capture();
@@ -352,6 +494,60 @@ validate_event(const internal_event_t &event, runtime_id_t &rid, sequence_t &seq
 }
 
 
+/*
+ * Read an event off the capture socket as raw bytes of its second part,
+ * so it can be cached in wire form w/o re-serializing.
+ * The first part, the source, is for filtering only and dropped.
+ *
+ * Returns 0 on success, EAGAIN on timeout, ERR_MESSAGE_INVALID for
+ * message w/o a data part (e.g. subscribe requests) and errno otherwise.
+ */
+static int
+read_capture_event(void *sock, string &evt_str)
+{
+    int rc = 0;
+    int more = 0;
+    size_t more_size = sizeof(more);
+    zmq_msg_t msg;
+
+    zmq_msg_init(&msg);
+    if (zmq_msg_recv(&msg, sock, 0) == -1) {
+        rc = zmq_errno();
+        goto out;
+    }
+    zmq_getsockopt(sock, ZMQ_RCVMORE, &more, &more_size);
+    if (!more) {
+        rc = ERR_MESSAGE_INVALID;
+        goto out;
+    }
+
+    zmq_msg_close(&msg);
+    zmq_msg_init(&msg);
+    if (zmq_msg_recv(&msg, sock, 0) == -1) {
+        rc = zmq_errno();
+        goto out;
+    }
+    zmq_getsockopt(sock, ZMQ_RCVMORE, &more, &more_size);
+
+    /* Reuse the caller's buffer to avoid an allocation per event */
+    evt_str.assign((const char *)zmq_msg_data(&msg), zmq_msg_size(&msg));
+
+    /* Drain any unexpected trailing parts */
+    while (more) {
+        zmq_msg_close(&msg);
+        zmq_msg_init(&msg);
+        if (zmq_msg_recv(&msg, sock, 0) == -1) {
+            break;
+        }
+        zmq_getsockopt(sock, ZMQ_RCVMORE, &more, &more_size);
+        rc = ERR_MESSAGE_INVALID;
+    }
+out:
+    zmq_msg_close(&msg);
+    return rc;
+}
+
+
 /*
  * Initialize cache with set of events provided.
  * Events read by cache service will be appended
@@ -362,7 +558,8 @@ capture_service::init_capture_cache(const event_serialized_lst_t &lst)
     /* Cache given events as initial stock.
      * Save runtime ID with last seen seq to avoid duplicates, while reading
      * from capture socket.
-     * No check for max cache size here, as most likely not needed.
+     * The ring enforces its own limits; any event that does not fit
+     * is dropped.
      */
     for (event_serialized_lst_t::const_iterator itc = lst.begin(); itc != lst.end(); ++itc) {
         internal_event_t event;
@@ -371,15 +568,40 @@ capture_service::init_capture_cache(const event_serialized_lst_t &lst)
             runtime_id_t rid;
             sequence_t seq;
 
-            if (validate_event(event, rid, seq)) {
+            if (validate_event(event, rid, seq) && m_events.push(*itc)) {
                 m_pre_exist_id[rid] = seq;
-                m_events.push_back(*itc);
             }
         }
     }
 }
 
 
+void
+capture_service::start_last_events()
+{
+    /* Clear the map, created to ensure memory space available */
+    m_last_events.clear();
+    m_last_events_init = true;
+}
+
+
+/*
+ * Once the cache is full, only the last event of each runtime ID is kept.
+ * Any event beyond one per runtime ID is counted as missed.
+ */
+void
+capture_service::save_last_event(const runtime_id_t &rid, const string &evt_str,
+        counters_t &total_overflow)
+{
+    total_overflow++;
+    m_last_events[rid] = evt_str;
+    if (total_overflow > m_last_events.size()) {
+        m_total_missed_cache++;
+        m_stats_instance->increment_missed_cache(1);
+    }
+}
+
+
 void
 capture_service::do_capture()
 {
@@ -405,6 +627,9 @@ capture_service::do_capture()
 
     cap_state_t cap_state = CAP_STATE_INIT;
 
+    /* Wire form of current event; reused across reads */
+    string evt_str;
+
     /*
      * Need subscription for publishers to publish.
      * The stats collector service already has active subscriber for all.
@@ -442,16 +667,15 @@ capture_service::do_capture()
      * Hence until as many events as in initial stock or until the cached id map
      * is empty, do this check.
      */
-    init_cnt = (int)m_events.size();
+    init_cnt = m_events.size();
 
     /* Read until STOP_CAPTURE */
     while(m_ctrl == START_CAPTURE) {
         runtime_id_t rid;
         sequence_t seq;
         internal_event_t event;
-        string source, evt_str;
 
-        if ((rc = zmq_message_read(cap_sub_sock, 0, source, event)) != 0) {
+        if ((rc = read_capture_event(cap_sub_sock, evt_str)) != 0) {
             /*
              * The capture socket captures SUBSCRIBE requests too.
              * The messge could contain subscribe filter strings and binary code.
@@ -462,10 +686,10 @@ capture_service::do_capture()
                 "0:Failed to read from capture socket");
             continue;
         }
-        if (!validate_event(event, rid, seq)) {
+        if ((deserialize(evt_str, event) != 0) ||
+                !validate_event(event, rid, seq)) {
             continue;
         }
-        serialize(event, evt_str);
 
         switch(cap_state) {
         case CAP_STATE_INIT:
@@ -491,8 +715,13 @@ capture_service::do_capture()
                         m_pre_exist_id.erase(it);
                     }
                 }
-                if (add) {
-                    m_events.push_back(evt_str);
+                if (add && !m_events.push(evt_str)) {
+                    /* Cache is full already with init stock */
+                    pre_exist_id_t().swap(m_pre_exist_id);
+                    cap_state = CAP_STATE_LAST;
+                    start_last_events();
+                    save_last_event(rid, evt_str, total_overflow);
+                    break;
                 }
             }
             if(m_pre_exist_id.empty() || (init_cnt <= 0)) {
@@ -504,34 +733,24 @@ capture_service::do_capture()
 
         case CAP_STATE_ACTIVE:
             /* Save until max allowed */
-            try
-            {
-                m_events.push_back(evt_str);
-                if (VEC_SIZE(m_events) >= m_cache_max) {
+            if (m_events.push(evt_str)) {
+                if (m_events.full()) {
                     cap_state = CAP_STATE_LAST;
-                    /* Clear the map, created to ensure memory space available */
-                    m_last_events.clear();
-                    m_last_events_init = true;
+                    start_last_events();
                 }
                 break;
             }
-            catch (bad_alloc& e)
-            {
-                stringstream ss;
-                ss << e.what();
-                SWSS_LOG_ERROR("Cache save event failed with %s events:size=%d",
-                        ss.str().c_str(), VEC_SIZE(m_events));
-                cap_state = CAP_STATE_LAST;
-                // fall through to save this event in last set.
+            if (!m_events.full()) {
+                SWSS_LOG_ERROR("Cache is out of space; events:size=%d bytes=%zu",
+                        m_events.size(), m_events.bytes_used());
             }
+            cap_state = CAP_STATE_LAST;
+            start_last_events();
+            save_last_event(rid, evt_str, total_overflow);
+            break;
 
         case CAP_STATE_LAST:
-            total_overflow++;
-            m_last_events[rid] = evt_str;
-            if (total_overflow > m_last_events.size()) {
-                m_total_missed_cache++;
-                m_stats_instance->increment_missed_cache(1);
-            }
+            save_last_event(rid, evt_str, total_overflow);
             break;
         }
     }
@@ -609,7 +828,7 @@ out:
 }
 
 int
-capture_service::read_cache(event_serialized_lst_t &lst_fifo,
+capture_service::read_cache(event_cache_t &lst_fifo,
         last_events_t &lst_last, counters_t &overflow_cnt)
 {
     lst_fifo.swap(m_events);
@@ -619,11 +838,24 @@ capture_service::read_cache(event_serialized_lst_t &lst_fifo,
         last_events_t().swap(lst_last);
     }
     last_events_t().swap(m_last_events);
-    event_serialized_lst_t().swap(m_events);
+    event_cache_t().swap(m_events);
     overflow_cnt = m_total_missed_cache;
     return 0;
 }
 
+int
+capture_service::read_cache(event_serialized_lst_t &lst_fifo,
+        last_events_t &lst_last, counters_t &overflow_cnt)
+{
+    event_cache_t cache;
+    int rc = read_cache(cache, lst_last, overflow_cnt);
+
+    event_serialized_lst_t().swap(lst_fifo);
+    lst_fifo.reserve(cache.size());
+    cache.read(cache.size(), lst_fifo);
+    return rc;
+}
+
 static int
 process_options(stats_collector *stats, const event_serialized_lst_t &req_data,
         event_serialized_lst_t &resp_data)
@@ -663,7 +895,7 @@ run_eventd_service()
     unique_ptr<capture_service> capture;
     bool skip_caching = false;
 
-    event_serialized_lst_t capture_fifo_events;
+    event_cache_t capture_fifo_events;
     last_events_t capture_last_events;
 
     SWSS_LOG_INFO("Eventd service starting\n");
@@ -716,7 +948,7 @@ run_eventd_service()
                 if (capture != NULL) {
                     capture.reset();
                 }
-                event_serialized_lst_t().swap(capture_fifo_events);
+                event_cache_t().swap(capture_fifo_events);
                 last_events_t().swap(capture_last_events);
 
                 capture = make_unique<capture_service>(zctx, cache_max, &stats_instance);
@@ -771,28 +1003,21 @@ run_eventd_service()
                 }
                 resp = 0;
 
-                if (capture_fifo_events.empty()) {
-                    for (last_events_t::iterator it = capture_last_events.begin();
-                            it != capture_last_events.end(); ++it) {
-                        capture_fifo_events.push_back(it->second);
+                /* Drain the ring first, then the last event per runtime ID */
+                if (!capture_fifo_events.empty()) {
+                    capture_fifo_events.read(READ_SET_SIZE, resp_data);
+                    if (capture_fifo_events.empty()) {
+                        /* Release the ring memory, once drained */
+                        event_cache_t().swap(capture_fifo_events);
                     }
-                    last_events_t().swap(capture_last_events);
                 }
+                else {
+                    last_events_t::iterator it = capture_last_events.begin();
 
-                {
-                    int sz = VEC_SIZE(capture_fifo_events) < READ_SET_SIZE ?
-                        VEC_SIZE(capture_fifo_events) : READ_SET_SIZE;
-
-                    if (sz != 0) {
-                        auto it = std::next(capture_fifo_events.begin(), sz);
-                        move(capture_fifo_events.begin(), capture_fifo_events.end(),
-                                back_inserter(resp_data));
-
-                        if (sz == VEC_SIZE(capture_fifo_events)) {
-                            event_serialized_lst_t().swap(capture_fifo_events);
-                        } else {
-                            capture_fifo_events.erase(capture_fifo_events.begin(), it);
-                        }
+                    while ((it != capture_last_events.end()) &&
+                            (VEC_SIZE(resp_data) < READ_SET_SIZE)) {
+                        resp_data.push_back(move(it->second));
+                        it = capture_last_events.erase(it);
                     }
                 }
                 break;
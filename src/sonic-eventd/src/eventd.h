@@ -2,6 +2,8 @@
  * Header file for eventd daemon
  */
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include <swss/table.h>
 #include <swss/events_service.h>
 #include <swss/events.h>
@@ -22,11 +24,27 @@ typedef enum {
 
 #define EVENTS_STATS_FIELD_NAME "value"
 #define STATS_HEARTBEAT_MIN 300
+/* Default gap between COUNTERS_DB writes; updates within it are coalesced */
+#define STATS_WRITE_INTERVAL_MS 100
 #define CAPTURE_SERVICE_POLLING_DURATION 10
 #define CAPTURE_SERVICE_POLLING_INCREMENT 10
 #define CAPTURE_SERVICE_POLLING_MAX_DURATION 100
 #define CAPTURE_SERVICE_POLLING_RETRIES 100
 
+#define MB(N) ((N) * 1024 * 1024)
+#define EVT_SIZE_AVG 150
+
+/* Default byte budget of the capture cache, from which its default count is derived */
+#define MAX_CACHE_BYTES MB(100)
+
+#define MAX_CACHE_SIZE (MAX_CACHE_BYTES / (EVT_SIZE_AVG))
+
+/* Size of the length header that precedes each event in the cache ring */
+#define CACHE_REC_HDR_SIZE ((int)sizeof(uint32_t))
+
+/* Bytes of cache ring for cnt events of average size */
+#define CACHE_BYTES(cnt) ((size_t)(cnt) * (EVT_SIZE_AVG + CACHE_REC_HDR_SIZE))
+
 /*
  *  Started by eventd_service.
  *  Creates XPUB & XSUB end points.
@@ -72,7 +90,7 @@ class stats_collector
 
         void stop() {
 
-            m_shutdown = true;
+            _set_shutdown();
 
             if (m_thr_collector.joinable()) {
                 m_thr_collector.join();
@@ -120,6 +138,19 @@ class stats_collector
             return m_heartbeats_published;
         }
 
+        /*
+         * Sets the least gap in milliseconds between writes to COUNTERS_DB.
+         * The writer sleeps until a counter changes and then writes once
+         * per interval.
+         */
+        void set_write_interval(int val_in_ms) {
+            m_write_interval_ms = (val_in_ms > 0) ? val_in_ms : 0;
+        }
+
+        uint64_t stats_writes() const {
+            return m_stats_writes;
+        }
+
         bool is_running()
         {
             return !m_shutdown;
@@ -129,7 +160,11 @@ class stats_collector
         void _update_stats(stats_counter_index_t index, counters_t val) {
             if (index != COUNTERS_EVENTS_TOTAL) {
                 m_lst_counters[index] += val;
-                m_updated = true;
+                /* Wake writer only on first update since its last write */
+                if (!m_updated.exchange(true)) {
+                    lock_guard<mutex> lock(m_write_mutex);
+                    m_write_cv.notify_one();
+                }
             }
             else {
                 SWSS_LOG_ERROR("Internal code error. Invalid index=%d", index);
@@ -140,8 +175,19 @@ class stats_collector
 
         void run_writer();
 
+        void _set_shutdown() {
+            lock_guard<mutex> lock(m_write_mutex);
+            m_shutdown = true;
+            m_write_cv.notify_all();
+        }
+
         std::atomic<bool> m_updated;
 
+        mutex m_write_mutex;
+        condition_variable m_write_cv;
+        std::atomic<int> m_write_interval_ms;
+        std::atomic<uint64_t> m_stats_writes;
+
         std::atomic<counters_t> m_lst_counters[COUNTERS_EVENTS_TOTAL];
 
         std::atomic<bool> m_shutdown;
@@ -159,6 +205,80 @@ class stats_collector
         std::atomic<int> m_heartbeats_interval_cnt;
 };
 
+/*
+ * Fixed size byte ring that holds cached events in their serialized
+ * wire form.
+ *
+ * The buffer is allocated once at construction and never grows. Each
+ * event is saved as a record of a 4 byte length followed by the bytes.
+ * A record never wraps; when it does not fit in the space left at the
+ * end of the buffer, the writer restarts at offset 0 and the unused tail
+ * is skipped by the reader. Hence both push & pop are O(1).
+ *
+ * The cache is bounded by both a byte limit and a count limit, whichever
+ * is hit first.
+ *
+ * The ring is not thread safe. The capture thread is the only writer
+ * until it exits, after which the ring is swapped out to the reader.
+ */
+class event_cache_t
+{
+    public:
+        event_cache_t(size_t max_bytes = 0, int max_cnt = 0);
+
+        /* Returns false if the event does not fit */
+        bool push(const char *data, size_t len);
+
+        bool push(const event_serialized_t &evt) {
+            return push(evt.data(), evt.size());
+        }
+
+        /*
+         * Returns a view into the ring for the oldest event.
+         * The view is valid until the next pop.
+         */
+        bool front(const char *&data, size_t &len) const;
+
+        void pop();
+
+        /* Move up to cnt events, oldest first, into lst. Returns count read */
+        int read(int cnt, event_serialized_lst_t &lst);
+
+        bool empty() const { return m_cnt == 0; }
+
+        int size() const { return m_cnt; }
+
+        bool full() const { return (m_max_cnt > 0) && (m_cnt >= m_max_cnt); }
+
+        size_t bytes_used() const { return m_used; }
+
+        size_t capacity() const { return m_capacity; }
+
+        void clear();
+
+        void swap(event_cache_t &other);
+
+    private:
+        unique_ptr<char[]> m_buf;
+        size_t m_capacity;
+        int m_max_cnt;
+
+        /* Offset of oldest record */
+        size_t m_head;
+
+        /* Offset to write next record */
+        size_t m_tail;
+
+        /* When wrapped, end of valid data in the upper part of buffer */
+        size_t m_end;
+        bool m_wrapped;
+
+        /* Bytes held by records including headers */
+        size_t m_used;
+        int m_cnt;
+};
+
+
 /*
  *  Capture/Cache service
  *
@@ -184,16 +304,14 @@ class stats_collector
  *  via thread.join().
  *
  *  Each event is 2 parts. It drops the first part, which is
- *  more for filtering events. It creates string from second part
- *  and saves it.
- *
- *  The string is the serialized version of internal_event_ref
+ *  more for filtering events. The second part is the serialized version
+ *  of internal_event_ref, which is saved as received, w/o re-serializing.
  *
  *  It keeps two sets of data
- *      1) List of all events received in vector in same order as received
- *      2) Map of last event from each runtime id upon list overflow max size.
+ *      1) Ring of all events received in same order as received
+ *      2) Map of last event from each runtime id upon ring overflow.
  *
- *  We add to the vector as much as allowed by vector and max limit,
+ *  We add to the ring as much as allowed by its byte and count limits,
  *  whichever comes first.
  *
  *  The sequence number in internal event will help assess the missed count
@@ -214,6 +332,7 @@ class capture_service
         capture_service(void *ctx, int cache_max, stats_collector *stats) :
             m_ctx(ctx), m_stats_instance(stats), m_cap_run(false),
             m_ctrl(NEED_INIT), m_cache_max(cache_max),
+            m_events(CACHE_BYTES(cache_max), cache_max),
             m_last_events_init(false), m_total_missed_cache(0)
         {}
 
@@ -221,6 +340,11 @@ class capture_service
 
         int set_control(capture_control_t ctrl, event_serialized_lst_t *p=NULL);
 
+        /* Hands over the cache ring as is; O(1) */
+        int read_cache(event_cache_t &lst_fifo,
+                last_events_t &lst_last, counters_t &overflow_cnt);
+
+        /* Copies out all cached events */
         int read_cache(event_serialized_lst_t &lst_fifo,
                 last_events_t &lst_last, counters_t &overflow_cnt);
 
@@ -228,6 +352,11 @@ class capture_service
         void init_capture_cache(const event_serialized_lst_t &lst);
         void do_capture();
 
+        /* Switch to keeping only the last event per runtime ID */
+        void start_last_events();
+        void save_last_event(const runtime_id_t &rid, const string &evt_str,
+                counters_t &total_overflow);
+
         void stop_capture();
 
         void *m_ctx;
@@ -239,7 +368,7 @@ class capture_service
 
         int m_cache_max;
 
-        event_serialized_lst_t m_events;
+        event_cache_t m_events;
 
         last_events_t m_last_events;
         bool m_last_events_init;
@@ -1,6 +1,7 @@
 #include "eventutils.h"
 #include <string.h>
 #include <cstdlib>
+#include <climits>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -31,6 +32,20 @@ bool isValidEnable(string enableStr) {
     return false;
 }
 
+// Reads j[key] into value if it is an unsigned integer; any other value is logged and ignored
+static bool get_unsigned(const json& j, const char *key, const char *filename, unsigned int& value) {
+    auto it = j.find(key);
+    if (it == j.end()) {
+        return false;
+    }
+    if (!it->is_number_unsigned() || it->get<uint64_t>() > UINT_MAX) {
+        SWSS_LOG_ERROR("Ignoring %s in %s: %s is not an unsigned integer", key, filename, it->dump().c_str());
+        return false;
+    }
+    value = it->get<unsigned int>();
+    return true;
+}
+
 bool parse_config(const char *filename, unsigned int& days, unsigned int& count) {
     days = EHT_MAX_DAYS;
     count = EHT_MAX_ELEMS;
@@ -65,6 +80,30 @@ bool parse_config(const char *filename, unsigned int& days, unsigned int& count)
     return true;
 }
 
+bool parse_flood_config(const char *filename, unsigned int& rate, unsigned int& burst) {
+    rate = EHT_FLOOD_RATE;
+    burst = EHT_FLOOD_BURST;
+    ifstream ifs(filename);
+
+    if (!ifs.is_open()) {
+        SWSS_LOG_ERROR("Failed to open file: %s", filename);
+        return false;
+    }
+
+    json j;
+    try {
+        j = json::parse(ifs);
+    }
+    catch (const std::exception &e) {
+        SWSS_LOG_ERROR("Error parsing config file %s: %s", filename, e.what());
+        return false;
+    }
+
+    get_unsigned(j, "flood-rate", filename, rate);
+    get_unsigned(j, "flood-burst", filename, burst);
+    return true;
+}
+
 bool parse(const char *filename, EventMap& tmp_event_table) {
     ifstream file(filename);
     if (!file.is_open()) {
@@ -104,6 +143,13 @@ bool parse(const char *filename, EventMap& tmp_event_table) {
         if (elem.contains("message")) {
             ev_info.static_event_msg = elem["message"];
         }
+        unsigned int flood_value;
+        if (get_unsigned(elem, "flood-rate", filename, flood_value)) {
+            ev_info.flood_rate = flood_value;
+        }
+        if (get_unsigned(elem, "flood-burst", filename, flood_value)) {
+            ev_info.flood_burst = flood_value;
+        }
         tmp_event_table.emplace(ev_name, ev_info);
     }
 
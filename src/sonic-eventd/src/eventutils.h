@@ -2,6 +2,7 @@
 #define __EVENTUTILS_H__
 
 #include <string>
+#include <cstdint>
 #include <unordered_map>
 
 const std::string EVENT_SEVERITY_CRITICAL_STR = "CRITICAL";
@@ -24,10 +25,22 @@ constexpr size_t EHT_MAX_ELEMS    = 40000;
 constexpr size_t EHT_MAX_DAYS     = 30;
 constexpr char EVENTD_CONF_FILE[] = "/etc/eventd.json";
 
+// Flood control: per (type-id, resource) token bucket refilled at
+// EHT_FLOOD_RATE events/sec holding at most EHT_FLOOD_BURST events.
+// A rate of 0 turns flood control off, which is the default.
+constexpr unsigned int EHT_FLOOD_RATE   = 0;
+constexpr unsigned int EHT_FLOOD_BURST  = 500;
+constexpr unsigned int EHT_FLOOD_REPORT_SECS = 60;
+// per event flood-rate/flood-burst not given in the event profile
+constexpr int64_t EHT_FLOOD_UNSET = -1;
+
 typedef struct EventInfo_t {
     std::string  severity;
     std::string  enable;
     std::string  static_event_msg;
+    // per event override of flood control, a flood_rate of 0 turns it off for the event
+    int64_t flood_rate = EHT_FLOOD_UNSET;
+    int64_t flood_burst = EHT_FLOOD_UNSET;
 } EventInfo;
 
 //unordered_map<string, EventInfo> static_event_table;
@@ -36,6 +49,7 @@ typedef std::unordered_map<std::string, EventInfo> EventMap;
 bool isValidSeverity(std::string severityStr);
 bool isValidEnable(std::string enableStr);
 bool parse_config(const char *filename, unsigned int& days, unsigned int& count);
+bool parse_flood_config(const char *filename, unsigned int& rate, unsigned int& burst);
 bool parse(const char *filename, EventMap& tmp_event_table);
 
 #endif
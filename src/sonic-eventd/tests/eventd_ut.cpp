@@ -6,6 +6,7 @@
 #include <regex>
 #include <chrono>
 #include <atomic>
+#include <cstring>
 #include <swss/events_common.h>
 #include <swss/events.h>
 #include "gtest/gtest.h"
@@ -17,6 +18,9 @@ using namespace swss;
 extern bool g_is_redis_available;
 extern const char *counter_keys[];
 
+/* Mirrors chunk size of EVENT_CACHE_READ in eventd */
+#define READ_SET_SIZE_TEST 100
+
 typedef struct {
     int id;
     string source;
@@ -553,6 +557,113 @@ TEST(eventd, captureCacheMax)
     printf("Capture TEST with matchinhg cache-max completed\n");
 }
 
+TEST(eventd, cacheRing)
+{
+    printf("Cache ring TEST started\n");
+
+    /* Sized so that MAX_CACHE_SIZE such events fill the ring bytes exactly */
+    string evt(EVT_SIZE_AVG - CACHE_REC_HDR_SIZE, 'x');
+    event_serialized_lst_t lst;
+    const char *data;
+    size_t len;
+
+    {
+        event_cache_t cache(MAX_CACHE_BYTES, MAX_CACHE_SIZE);
+
+        EXPECT_TRUE(cache.empty());
+        EXPECT_FALSE(cache.front(data, len));
+
+        for (int i = 0; i < MAX_CACHE_SIZE; ++i) {
+            /* Stamp each event to verify order on read */
+            string s = to_string(i);
+            memcpy(&evt[0], s.data(), s.size());
+            ASSERT_TRUE(cache.push(evt));
+        }
+        EXPECT_EQ(MAX_CACHE_SIZE, cache.size());
+        EXPECT_TRUE(cache.full());
+        EXPECT_LE(cache.bytes_used(), cache.capacity());
+
+        /* Count bound hit; no more */
+        EXPECT_FALSE(cache.push(evt));
+
+        EXPECT_EQ(READ_SET_SIZE_TEST, cache.read(READ_SET_SIZE_TEST, lst));
+        EXPECT_EQ(MAX_CACHE_SIZE - READ_SET_SIZE_TEST, cache.size());
+        for (int i = 0; i < READ_SET_SIZE_TEST; ++i) {
+            EXPECT_EQ(0, lst[i].compare(0, to_string(i).size(), to_string(i)));
+            EXPECT_EQ(evt.size(), lst[i].size());
+        }
+
+        /* Space freed at the start is reused by wrapping */
+        EXPECT_TRUE(cache.push(evt));
+        EXPECT_TRUE(cache.front(data, len));
+        EXPECT_EQ(string(data, 3), to_string(READ_SET_SIZE_TEST));
+
+        /* Drain the rest in place w/o copying out */
+        int drained = 0;
+        while (cache.front(data, len)) {
+            if (cache.size() == 1) {
+                EXPECT_EQ(evt, string(data, len));
+            }
+            cache.pop();
+            ++drained;
+        }
+        EXPECT_EQ(MAX_CACHE_SIZE - READ_SET_SIZE_TEST + 1, drained);
+        EXPECT_TRUE(cache.empty());
+        EXPECT_EQ(0, (int)cache.bytes_used());
+    }
+
+    {
+        /* Byte bound hits before count bound */
+        int cnt = 10;
+        event_cache_t cache(cnt * EVT_SIZE_AVG, cnt * 2);
+
+        for (int i = 0; i < cnt; ++i) {
+            EXPECT_TRUE(cache.push(evt));
+        }
+        EXPECT_FALSE(cache.full());
+        EXPECT_FALSE(cache.push(evt));
+        EXPECT_EQ(cnt, cache.size());
+
+        /* Drain one; record of different size wraps to the start */
+        cache.pop();
+        EXPECT_FALSE(cache.push(evt + "y"));
+        EXPECT_TRUE(cache.push(evt.substr(1)));
+        EXPECT_FALSE(cache.push(evt));
+
+        for (int i = 0; i < cnt - 1; ++i) {
+            EXPECT_TRUE(cache.front(data, len));
+            EXPECT_EQ(evt.size(), len);
+            cache.pop();
+        }
+        EXPECT_TRUE(cache.front(data, len));
+        EXPECT_EQ(evt.size() - 1, len);
+        cache.pop();
+        EXPECT_TRUE(cache.empty());
+
+        /* Event larger than whole ring is rejected */
+        EXPECT_FALSE(cache.push(string(cnt * EVT_SIZE_AVG, 'z')));
+    }
+
+    {
+        /* Capture ring is sized from the configured count */
+        int cnt = 10;
+        stats_collector stats_instance;
+        capture_service cap(NULL, cnt, &stats_instance);
+        event_cache_t ring;
+        last_events_t last;
+        counters_t overflow;
+
+        EXPECT_EQ(0, cap.read_cache(ring, last, overflow));
+        EXPECT_EQ(CACHE_BYTES(cnt), ring.capacity());
+        for (int i = 0; i < cnt; ++i) {
+            EXPECT_TRUE(ring.push(string(EVT_SIZE_AVG, 'x')));
+        }
+        EXPECT_TRUE(ring.full());
+    }
+
+    printf("Cache ring TEST completed\n");
+}
+
 TEST(eventd, service)
 {
     /*
@@ -925,4 +1036,69 @@ TEST(eventd, testDB)
 }
 
 
+TEST(eventd, statsWriteCoalesce)
+{
+    printf("Stats write TEST started\n");
+
+    stats_collector stats_instance;
+
+    if (!g_is_redis_available) {
+        printf("redis not available; Hence stats write TEST skipped\n");
+        return;
+    }
+
+    /* Not testing heartbeat; Hence set high val as 10 seconds */
+    const int write_interval_ms = 500;
+    stats_instance.set_heartbeat_interval(10000);
+    stats_instance.set_write_interval(write_interval_ms);
+
+    /* Drop a value left by an earlier write, the test waits for this one */
+    DBConnector db("COUNTERS_DB", 0, true);
+    string key = string("COUNTERS_EVENTS:") + COUNTERS_EVENTS_PUBLISHED;
+    db.del(key);
+
+    EXPECT_EQ(0, stats_instance.start());
+
+    /* Idle; writer writes nothing without an update, however long it waits */
+    this_thread::sleep_for(chrono::milliseconds(write_interval_ms));
+    EXPECT_EQ(0, (int)stats_instance.stats_writes());
+
+    /*
+     * A burst of updates is coalesced. Each write waits a full interval
+     * after the first update since the previous write, so the writes done
+     * by any time are bounded by the intervals passed since the burst began.
+     */
+    auto burst_start = chrono::steady_clock::now();
+    for (int i = 0; i < 1000; ++i) {
+        stats_instance.increment_published(1);
+    }
+    auto deadline = burst_start + chrono::seconds(10);
+    bool written = false;
+    while (!written && (chrono::steady_clock::now() < deadline)) {
+        auto val = db.hget(key, EVENTS_STATS_FIELD_NAME);
+        written = (val != nullptr) && (*val == "1000");
+        if (!written) {
+            this_thread::sleep_for(chrono::milliseconds(20));
+        }
+    }
+    auto elapsed_ms = chrono::duration_cast<chrono::milliseconds>(
+            chrono::steady_clock::now() - burst_start).count();
+    uint64_t writes = stats_instance.stats_writes();
+    EXPECT_TRUE(written);
+    EXPECT_LE(1, (int)writes);
+    EXPECT_LE((long)writes, elapsed_ms / write_interval_ms);
+
+    /*
+     * Idle again; at most one write of an update that raced the last one,
+     * then nothing more.
+     */
+    this_thread::sleep_for(chrono::milliseconds(3 * write_interval_ms));
+    EXPECT_LE(stats_instance.stats_writes(), writes + 1);
+
+    stats_instance.stop();
+
+    printf("Stats write TEST completed\n");
+}
+
+
 // TODO -- Add unit tests for stats
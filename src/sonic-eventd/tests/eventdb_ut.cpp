@@ -3,7 +3,11 @@
 #include <swss/events_common.h>
 #include <swss/events.h>
 #include <unordered_map>
+#include <unordered_set>
+#include <fstream>
 #include <swss/dbconnector.h>
+#include <swss/redispipeline.h>
+#include <swss/table.h>
 #include <iostream>
 
 #include<sstream>
@@ -17,8 +21,9 @@ extern volatile bool g_run;
 extern uint64_t seq_id;
 extern uint64_t PURGE_SECONDS;
 extern unordered_map<string, uint64_t> cal_lookup_map;
-typedef pair<uint64_t, uint64_t> pi;
-extern priority_queue<pi, vector<pi>, greater<pi> > event_history_list;
+extern unordered_map<string, FloodBucket> flood_bucket_map;
+extern EventHistoryList event_history_list;
+extern unordered_set<uint64_t> event_acked_set;
 extern EventMap static_event_table;
 
 
@@ -79,8 +84,10 @@ void clear_eventdb_data()
     g_run = true;
     seq_id =0;
     cal_lookup_map.clear();
+    flood_bucket_map.clear();
     PURGE_SECONDS = 86400;
-    event_history_list = priority_queue<pi, vector<pi>, greater<pi> >();
+    event_history_list = EventHistoryList();
+    event_acked_set.clear();
     static_event_table.clear();
 }
 
@@ -380,6 +387,278 @@ TEST_F(EventDbFixture, rollover_purge)
     printf("Rollover purge TEST completed\n");
 }
 
+TEST(EventDbFlood, per_source_rate_limit)
+{
+    printf("Flood control TEST started\n");
+
+    const string profile = "/tmp/eventd_flood_ut.json";
+    const int burst = 5;
+    const int flood_cnt = 40;
+
+    {
+        ofstream ofs(profile);
+        ofs << "{\"max-records\": 200, \"max-days\": 30, \"flood-rate\": 1, \"flood-burst\": " << burst << "}";
+    }
+
+    void *zctx = zmq_ctx_new();
+    EXPECT_TRUE(NULL != zctx);
+    eventd_proxy *pxy = new eventd_proxy(zctx);
+    EXPECT_EQ(0, pxy->init());
+
+    DBConnector *eventDb = new DBConnector("EVENT_DB", 0, true);
+    delete_evdb(*eventDb);
+
+    g_run = true;
+    EventConsume *evtConsume = new EventConsume(eventDb, event_profile, profile);
+    thread consumerThread(&EventConsume::run, evtConsume);
+    void *mock_pub = init_publish(zctx);
+
+    // A flooding source interleaved with a quiet one; the last event check
+    // alone would let all of them through.
+    for (int i = 0; i < flood_cnt; ++i) {
+        for (const string res : {"flapping", "quiet"}) {
+            if ((res == "quiet") && (i % 10 != 0)) {
+                continue;
+            }
+            internal_event_t ev;
+            map<string, string> params = {{"type-id", "SYSTEM_STATE"},
+                                          {"resource", res},
+                                          {"text", "flap " + to_string(i)}};
+            ev[EVENT_STR_DATA] = convert_to_json("source:tag", params);
+            ev[EVENT_RUNTIME_ID] = "guid-flood";
+            ev[EVENT_SEQUENCE] = to_string(2 * i + (res == "quiet") + 1);
+            ev[EVENT_EPOCH] = to_string(duration_cast<nanoseconds>(
+                        system_clock::now().time_since_epoch()).count());
+            EXPECT_EQ(0, zmq_message_send(mock_pub, "eventd-test", ev));
+        }
+    }
+
+    this_thread::sleep_for(chrono::milliseconds(2000));
+    g_run = false;
+    consumerThread.join();
+
+    int flapping = 0, quiet = 0;
+    for (const auto &key : eventDb->keys("EVENT:*")) {
+        auto ev = eventDb->hgetall(key);
+        if (ev["resource"] == "flapping") {
+            ++flapping;
+        } else if (ev["resource"] == "quiet") {
+            ++quiet;
+        }
+    }
+
+    // burst plus refill at 1/sec over the run
+    EXPECT_LE(burst, flapping);
+    EXPECT_GE(burst + 3, flapping);
+    EXPECT_EQ(flood_cnt / 10, quiet);
+    EXPECT_EQ((uint64_t)(flood_cnt - flapping), flood_bucket_map["SYSTEM_STATE|flapping"].suppressed);
+
+    zmq_close(mock_pub);
+    delete evtConsume;
+    delete_evdb(*eventDb);
+    delete eventDb;
+    zmq_ctx_term(zctx);
+    delete pxy;
+    remove(profile.c_str());
+    clear_eventdb_data();
+
+    printf("Flood control TEST completed\n");
+}
+
+TEST(EventDbFlood, clear_follows_dropped_raise)
+{
+    printf("Flood control clear TEST started\n");
+
+    const string profile = "/tmp/eventd_flood_clear_ut.json";
+    {
+        ofstream ofs(profile);
+        ofs << "{\"max-records\": 200, \"max-days\": 30, \"flood-rate\": 1, \"flood-burst\": 1}";
+    }
+
+    void *zctx = zmq_ctx_new();
+    EXPECT_TRUE(NULL != zctx);
+    eventd_proxy *pxy = new eventd_proxy(zctx);
+    EXPECT_EQ(0, pxy->init());
+
+    DBConnector *eventDb = new DBConnector("EVENT_DB", 0, true);
+    delete_evdb(*eventDb);
+
+    g_run = true;
+    EventConsume *evtConsume = new EventConsume(eventDb, event_profile, profile);
+    thread consumerThread(&EventConsume::run, evtConsume);
+    void *mock_pub = init_publish(zctx);
+
+    // the plain event takes the only token, the raise after it is dropped
+    // and so is its clear, there is no alarm for it to clear
+    int seq = 0;
+    for (const string act : {"", "RAISE", "CLEAR"}) {
+        internal_event_t ev;
+        map<string, string> params = {{"type-id", "SENSOR_TEMP_HIGH"},
+                                      {"resource", "cpu_sensor"},
+                                      {"text", "sensor temp " + to_string(50 + seq) + "C"}};
+        if (!act.empty()) {
+            params["action"] = act;
+        }
+        ev[EVENT_STR_DATA] = convert_to_json("source:tag", params);
+        ev[EVENT_RUNTIME_ID] = "guid-flood-clear";
+        ev[EVENT_SEQUENCE] = to_string(++seq);
+        ev[EVENT_EPOCH] = to_string(duration_cast<nanoseconds>(
+                    system_clock::now().time_since_epoch()).count());
+        EXPECT_EQ(0, zmq_message_send(mock_pub, "eventd-test", ev));
+    }
+
+    this_thread::sleep_for(chrono::milliseconds(2000));
+    g_run = false;
+    consumerThread.join();
+
+    EXPECT_EQ(1u, eventDb->keys("EVENT:*").size());
+    EXPECT_EQ(0u, eventDb->keys("ALARM:*").size());
+    EXPECT_EQ(2u, flood_bucket_map["SENSOR_TEMP_HIGH|cpu_sensor"].suppressed);
+    EXPECT_FALSE(flood_bucket_map["SENSOR_TEMP_HIGH|cpu_sensor"].raise_dropped);
+
+    zmq_close(mock_pub);
+    delete evtConsume;
+    delete_evdb(*eventDb);
+    delete eventDb;
+    zmq_ctx_term(zctx);
+    delete pxy;
+    remove(profile.c_str());
+    clear_eventdb_data();
+
+    printf("Flood control clear TEST completed\n");
+}
+
+TEST(EventDbFlood, flood_config_values)
+{
+    const string config = "/tmp/eventd_flood_config_ut.json";
+    const string evprofile = "/tmp/eventd_flood_profile_ut.json";
+    {
+        ofstream ofs(config);
+        ofs << "{\"flood-rate\": \"fast\", \"flood-burst\": 7}";
+    }
+    {
+        ofstream ofs(evprofile);
+        ofs << "{\"events\": ["
+            << "{\"name\": \"OFF\", \"severity\": \"MAJOR\", \"enable\": \"true\", \"flood-rate\": 0},"
+            << "{\"name\": \"DEFAULT\", \"severity\": \"MAJOR\", \"enable\": \"true\"},"
+            << "{\"name\": \"BAD\", \"severity\": \"MAJOR\", \"enable\": \"true\", \"flood-rate\": -3, \"flood-burst\": 2.5}"
+            << "]}";
+    }
+
+    // a value of the wrong type is ignored, not thrown
+    unsigned int rate = 0, burst = 0;
+    EXPECT_TRUE(parse_flood_config(config.c_str(), rate, burst));
+    EXPECT_EQ(EHT_FLOOD_RATE, rate);
+    EXPECT_EQ(7u, burst);
+
+    // per event 0 turns flood control off, it is not the same as leaving it out
+    EventMap table;
+    EXPECT_TRUE(parse(evprofile.c_str(), table));
+    EXPECT_EQ(0, table["OFF"].flood_rate);
+    EXPECT_EQ(EHT_FLOOD_UNSET, table["OFF"].flood_burst);
+    EXPECT_EQ(EHT_FLOOD_UNSET, table["DEFAULT"].flood_rate);
+    EXPECT_EQ(EHT_FLOOD_UNSET, table["BAD"].flood_rate);
+    EXPECT_EQ(EHT_FLOOD_UNSET, table["BAD"].flood_burst);
+
+    remove(config.c_str());
+    remove(evprofile.c_str());
+}
+
+TEST(EventDbPurge, bulk_purge_40k)
+{
+    printf("Bulk purge TEST started\n");
+
+    const int max_records = 40000;
+    const int burst = 2000;
+    const string profile = "/tmp/eventd_purge_ut.json";
+
+    {
+        ofstream ofs(profile);
+        ofs << "{\"max-records\": " << max_records << ", \"max-days\": 30, \"flood-rate\": 0}";
+    }
+
+    void *zctx = zmq_ctx_new();
+    EXPECT_TRUE(NULL != zctx);
+    eventd_proxy *pxy = new eventd_proxy(zctx);
+    EXPECT_EQ(0, pxy->init());
+
+    DBConnector *eventDb = new DBConnector("EVENT_DB", 0, true);
+    delete_evdb(*eventDb);
+
+    // Fill history table to its limit, so that every new event needs a purge
+    {
+        RedisPipeline pipeline(eventDb);
+        Table table(&pipeline, "EVENT", true);
+        auto now_ns = duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+
+        for (int i = 1; i <= max_records; ++i) {
+            table.set(to_string(i), {{"type-id", "SYSTEM_STATE"}, {"text", "seed"},
+                                     {"severity", "INFORMATIONAL"}, {"id", to_string(i)},
+                                     {"time-created", to_string(now_ns)}});
+        }
+        table.flush();
+    }
+
+    g_run = true;
+    EventConsume *evtConsume = new EventConsume(eventDb, event_profile, profile);
+    EXPECT_EQ((size_t)max_records, event_history_list.size());
+    EXPECT_EQ((uint64_t)max_records, seq_id);
+
+    thread consumerThread(&EventConsume::run, evtConsume);
+    void *mock_pub = init_publish(zctx);
+
+    // Publish a burst as fast as possible; distinct text avoids flood check
+    auto start = steady_clock::now();
+    for (int i = 0; i < burst; ++i) {
+        internal_event_t ev;
+        map<string, string> params = {{"type-id", "SYSTEM_STATE"},
+                                      {"resource", "system-state"},
+                                      {"text", "burst " + to_string(i)}};
+        ev[EVENT_STR_DATA] = convert_to_json("source:tag", params);
+        ev[EVENT_RUNTIME_ID] = "guid-purge";
+        ev[EVENT_SEQUENCE] = to_string(i + 1);
+        ev[EVENT_EPOCH] = to_string(duration_cast<nanoseconds>(
+                    system_clock::now().time_since_epoch()).count());
+        EXPECT_EQ(0, zmq_message_send(mock_pub, "eventd-test", ev));
+    }
+
+    this_thread::sleep_for(chrono::milliseconds(3000));
+    auto elapsed_ms = duration_cast<milliseconds>(steady_clock::now() - start).count();
+
+    g_run = false;
+    consumerThread.join();
+
+    uint64_t added = seq_id - max_records;
+    EXPECT_LT(0UL, added);
+
+    // Table is held at its limit with the oldest records removed
+    auto dbKeys = eventDb->keys("EVENT:*");
+    EXPECT_EQ((size_t)max_records, dbKeys.size());
+    EXPECT_EQ((size_t)max_records, event_history_list.size());
+    EXPECT_FALSE(eventDb->exists("EVENT:" + to_string(added)));
+    EXPECT_TRUE(eventDb->exists("EVENT:" + to_string(added + 1)));
+    EXPECT_TRUE(eventDb->exists("EVENT:" + to_string(seq_id)));
+
+    // Purge passes are bounded by time & slack, not by events received
+    uint64_t max_purges = 2 + (elapsed_ms / EVENTDB_PURGE_INTERVAL_MS) +
+                          (added / EVENTDB_PURGE_SLACK);
+    printf("events added=%lu purges=%lu bound=%lu\n", added,
+           evtConsume->getPurgeCount(), max_purges);
+    EXPECT_LE(evtConsume->getPurgeCount(), max_purges);
+    EXPECT_LT(evtConsume->getPurgeCount(), added);
+
+    zmq_close(mock_pub);
+    delete evtConsume;
+    delete_evdb(*eventDb);
+    delete eventDb;
+    zmq_ctx_term(zctx);
+    delete pxy;
+    remove(profile.c_str());
+    clear_eventdb_data();
+
+    printf("Bulk purge TEST completed\n");
+}
+
 class SwsscommonEnvironment : public ::testing::Environment {
 public:
     // Override this to define how to set up the environment
@@ -1,8 +1,11 @@
 #include <thread>
 #include <iostream>
 #include <stdlib.h>
+#include <algorithm>
+#include <cinttypes>
 #include <swss/events.h>
 #include <swss/events_common.h>
+#include "../src/eventd.h"
 
 /*
  * Sample i/p file contents for send
@@ -64,7 +67,15 @@ Note:\n\
 \n\
 -c  - Use offline cache in receive mode\n\
 -o  - O/p file to write received events\n\
-      Default: STDOUT\n";
+      Default: STDOUT\n\
+\n\
+-b  - Benchmark. Runs eventd proxy, capture service, publishers and a\n\
+      subscriber in this process and reports end to end latency, drops and\n\
+      missed sequences. eventd must not be running on this host.\n\
+      -n is count of events per publisher. Default: 10000\n\
+-t  - Count of publisher threads in benchmark. Default: 1\n\
+-R  - Events per second per publisher in benchmark. Default: 0 implying no limit\n\
+-z  - Bytes of param data per event in benchmark. Default: 64\n";
 
 
 bool term_receive = false;
@@ -235,6 +246,206 @@ do_send(const string infile, int cnt, int pause)
     return 0;
 }
 
+#define BENCH_PARAM_TS "bench_ts"
+#define BENCH_PARAM_SEQ "bench_seq"
+#define BENCH_PARAM_DATA "bench_data"
+#define BENCH_SOURCE "bench"
+#define BENCH_DRAIN_TIMEOUT_MS 2000
+
+typedef struct {
+    int threads;
+    int cnt;
+    int rate;
+    int size;
+} bench_cfg_t;
+
+typedef struct {
+    vector<uint64_t> latency_ns;
+    uint64_t received;
+    uint64_t missed;        /* missed count as reported by events lib */
+    uint64_t seq_gaps;      /* events found missing from per publisher sequence */
+    uint64_t out_of_order;
+} bench_result_t;
+
+static uint64_t
+bench_now_ns()
+{
+    return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void
+bench_publish(event_handle_t h, const bench_cfg_t &cfg, int id)
+{
+    event_params_t params;
+    string tag = string("bench-tag-") + to_string(id);
+    auto start = chrono::steady_clock::now();
+
+    params[BENCH_PARAM_DATA] = string(cfg.size, 'x');
+
+    for(int i = 0; i < cfg.cnt; ++i) {
+        if (cfg.rate > 0) {
+            this_thread::sleep_until(start + chrono::nanoseconds(
+                        (uint64_t)i * 1000000000ULL / (uint64_t)cfg.rate));
+        }
+        params[BENCH_PARAM_SEQ] = to_string(i);
+        params[BENCH_PARAM_TS] = to_string(bench_now_ns());
+
+        int rc = event_publish(h, tag, &params);
+        ASSERT(rc == 0, "Failed to publish publisher=%d index=%d rc=%d", id, i, rc);
+    }
+}
+
+static void
+bench_receive(event_handle_t h, uint64_t expected, atomic<bool> &pub_done,
+        bench_result_t &res)
+{
+    map<string, int64_t> last_seq;
+    uint64_t idle_since = 0;
+
+    res.latency_ns.reserve(expected);
+
+    while (res.received < expected) {
+        event_receive_op_t evt;
+
+        int rc = event_receive(h, evt);
+        if (rc != 0) {
+            ASSERT(rc == EAGAIN, "Failed to receive rc=%d", rc);
+            if (!pub_done) {
+                continue;
+            }
+            /* Publishers done; stop once nothing arrives for a while */
+            if (idle_since == 0) {
+                idle_since = bench_now_ns();
+            }
+            else if ((bench_now_ns() - idle_since) > (BENCH_DRAIN_TIMEOUT_MS * 1000000ULL)) {
+                break;
+            }
+            continue;
+        }
+        uint64_t now = bench_now_ns();
+        idle_since = 0;
+
+        const auto itc_ts = evt.params.find(BENCH_PARAM_TS);
+        const auto itc_seq = evt.params.find(BENCH_PARAM_SEQ);
+        if ((itc_ts == evt.params.end()) || (itc_seq == evt.params.end())) {
+            /* Not a benchmark event, e.g. heartbeat */
+            continue;
+        }
+        ++res.received;
+        res.missed += evt.missed_cnt;
+        res.latency_ns.push_back(now - stoull(itc_ts->second));
+
+        int64_t seq = stoll(itc_seq->second);
+        auto itl = last_seq.find(evt.key);
+        int64_t prev = (itl == last_seq.end()) ? -1 : itl->second;
+        if (seq > prev) {
+            res.seq_gaps += (uint64_t)(seq - prev - 1);
+            last_seq[evt.key] = seq;
+        }
+        else {
+            ++res.out_of_order;
+        }
+    }
+}
+
+static double
+bench_percentile_us(const vector<uint64_t> &sorted, double pct)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t i = min(sorted.size() - 1, (size_t)(pct * (double)sorted.size()));
+    return (double)sorted[i] / 1000.0;
+}
+
+int
+do_benchmark(const bench_cfg_t &cfg)
+{
+    stats_collector stats_instance;
+    event_cache_t cache;
+    last_events_t last_events;
+    counters_t overflow = 0;
+    bench_result_t res = {};
+    atomic<bool> pub_done(false);
+    vector<event_handle_t> pubs;
+    vector<thread> thrs;
+    uint64_t expected = (uint64_t)cfg.threads * (uint64_t)cfg.cnt;
+
+    /* No redis access for stats */
+    set_unit_testing(true);
+
+    void *zctx = zmq_ctx_new();
+    ASSERT(zctx != NULL, "Failed to get zmq ctx");
+
+    eventd_proxy *pxy = new eventd_proxy(zctx);
+    ASSERT(pxy->init() == 0, "Failed to start eventd proxy; is eventd running?");
+
+    capture_service *pcap = new capture_service(zctx, MAX_CACHE_SIZE, &stats_instance);
+    ASSERT(pcap->set_control(INIT_CAPTURE) == 0, "Failed to init capture");
+    ASSERT(pcap->set_control(START_CAPTURE) == 0, "Failed to start capture");
+
+    event_handle_t hsub = events_init_subscriber(false, 100);
+    ASSERT(hsub != NULL, "Failed to get subscriber handle");
+
+    for (int i = 0; i < cfg.threads; ++i) {
+        event_handle_t h = events_init_publisher(string(BENCH_SOURCE) + to_string(i));
+        ASSERT(h != NULL, "failed to init publisher %d", i);
+        pubs.push_back(h);
+    }
+
+    /* Let subscriptions propagate through proxy before first publish */
+    this_thread::sleep_for(chrono::milliseconds(500));
+
+    printf("Benchmark: publishers=%d count=%d rate=%d size=%d\n",
+            cfg.threads, cfg.cnt, cfg.rate, cfg.size);
+
+    thread thr_sub(&bench_receive, hsub, expected, ref(pub_done), ref(res));
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < cfg.threads; ++i) {
+        thrs.push_back(thread(&bench_publish, pubs[i], cref(cfg), i));
+    }
+    for (auto &thr : thrs) {
+        thr.join();
+    }
+    double pub_secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    pub_done = true;
+
+    thr_sub.join();
+    double recv_secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    ASSERT(pcap->set_control(STOP_CAPTURE) == 0, "Failed to stop capture");
+    ASSERT(pcap->read_cache(cache, last_events, overflow) == 0, "Failed to read cache");
+
+    for (auto h : pubs) {
+        events_deinit_publisher(h);
+    }
+    events_deinit_subscriber(hsub);
+
+    sort(res.latency_ns.begin(), res.latency_ns.end());
+
+    printf("Published: %" PRIu64 " in %.3f secs (%.0f events/sec)\n",
+            expected, pub_secs, pub_secs > 0 ? (double)expected / pub_secs : 0);
+    printf("Received: %" PRIu64 " in %.3f secs (%.0f events/sec)\n",
+            res.received, recv_secs, recv_secs > 0 ? (double)res.received / recv_secs : 0);
+    printf("Dropped: %" PRIu64 " missed(reported): %" PRIu64 " missed(sequence): %" PRIu64
+            " out-of-order: %" PRIu64 "\n",
+            expected - res.received, res.missed, res.seq_gaps, res.out_of_order);
+    printf("Captured: %d overflow: %" PRIu64 " last-events: %d\n",
+            cache.size(), (uint64_t)overflow, (int)last_events.size());
+    printf("Latency us: p50=%.1f p99=%.1f p999=%.1f max=%.1f\n",
+            bench_percentile_us(res.latency_ns, 0.50),
+            bench_percentile_us(res.latency_ns, 0.99),
+            bench_percentile_us(res.latency_ns, 0.999),
+            bench_percentile_us(res.latency_ns, 1.0));
+
+    delete pcap;
+    zmq_ctx_term(zctx);
+    delete pxy;
+    return 0;
+}
+
 void usage()
 {
     printf("%s", s_usage);
@@ -244,6 +455,8 @@ void usage()
 int main(int argc, char **argv)
 {
     bool use_cache = false;
+    bool bench = false;
+    bench_cfg_t bench_cfg = { 1, 0, 0, 64 };
     int op = OP_INIT;
     int cnt=0, pause=0;
     string json_str_msg, outfile("STDOUT"), infile;
@@ -251,12 +464,28 @@ int main(int argc, char **argv)
 
     for(;;)
     {
-        switch(getopt(argc, argv, "srn:p:i:o:f:c")) // note the colon (:) to indicate that 'b' has a parameter and is not a switch
+        switch(getopt(argc, argv, "srn:p:i:o:f:cbt:R:z:")) // note the colon (:) to indicate that 'b' has a parameter and is not a switch
         {
         case 'c':
             use_cache = true;
             continue;
 
+        case 'b':
+            bench = true;
+            continue;
+
+        case 't':
+            bench_cfg.threads = stoi(optarg);
+            continue;
+
+        case 'R':
+            bench_cfg.rate = stoi(optarg);
+            continue;
+
+        case 'z':
+            bench_cfg.size = stoi(optarg);
+            continue;
+
         case 's':
             op |= OP_SEND;
             continue;
@@ -309,7 +538,12 @@ int main(int argc, char **argv)
     printf("op=%d n=%d pause=%d i=%s o=%s\n",
             op, cnt, pause, infile.c_str(), outfile.c_str());
 
-    if (op == OP_SEND_RECV) {
+    if (bench) {
+        bench_cfg.cnt = (cnt > 0) ? cnt : 10000;
+        ASSERT(bench_cfg.threads > 0, "Need at least one publisher thread");
+        do_benchmark(bench_cfg);
+    }
+    else if (op == OP_SEND_RECV) {
         thread thr(&do_receive, filter, outfile, 0, 0, use_cache);
         do_send(infile, cnt, pause);
     }
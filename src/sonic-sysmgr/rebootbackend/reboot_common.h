@@ -7,6 +7,22 @@
 namespace rebootbackend {
 
 extern bool sigterm_requested;
+
+// STATE_DB table/key holding the phase timings of the latest reboot attempt.
+constexpr char REBOOT_PHASE_TABLE[] = "REBOOT_PHASE_TABLE";
+constexpr char REBOOT_PHASE_KEY[] = "latest";
+
+// STATE_DB table/key the platform writes reboot progress to, so a definitive
+// outcome ends the wait for the platform without sitting out the timeout.
+// Fields are "status", one of the REBOOT_PROGRESS_* values, and "message".
+constexpr char REBOOT_PROGRESS_TABLE[] = "REBOOT_PROGRESS_TABLE";
+constexpr char REBOOT_PROGRESS_KEY[] = "latest";
+constexpr char REBOOT_PROGRESS_STATUS_FIELD[] = "status";
+constexpr char REBOOT_PROGRESS_MESSAGE_FIELD[] = "message";
+constexpr char REBOOT_PROGRESS_IN_PROGRESS[] = "in_progress";
+constexpr char REBOOT_PROGRESS_SUCCESS[] = "success";
+constexpr char REBOOT_PROGRESS_FAILURE[] = "failure";
+
 struct NotificationResponse {
   swss::StatusCode status;
   std::string json_string;
@@ -3,6 +3,7 @@
 #include <google/protobuf/util/json_util.h>
 
 #include <chrono>
+#include <deque>
 
 #include "dbconnector.h"
 #include "logger.h"
@@ -14,6 +15,7 @@
 #include "selectabletimer.h"
 #include "subscriberstatetable.h"
 #include "system/system.pb.h"
+#include "table.h"
 #include "timestamp.h"
 
 namespace rebootbackend {
@@ -25,11 +27,35 @@ namespace gpu = ::google::protobuf::util;
 
 bool sigterm_requested = false;
 
+const char *reboot_phase_name(RebootPhase phase) {
+  switch (phase) {
+    case RebootPhase::REQUEST_RECEIVED:
+      return "request_received";
+    case RebootPhase::DBUS_REBOOT_SENT:
+      return "dbus_reboot_sent";
+    case RebootPhase::DBUS_RESPONSE_RECEIVED:
+      return "dbus_response_received";
+    case RebootPhase::WAITING_FOR_PLATFORM:
+      return "waiting_for_platform";
+    case RebootPhase::PLATFORM_SUCCESS:
+      return "platform_success";
+    case RebootPhase::PLATFORM_FAILURE:
+      return "platform_failure";
+    case RebootPhase::TIMEOUT:
+      return "timeout";
+    case RebootPhase::STOP_REQUESTED:
+      return "stop_requested";
+  }
+  return "unknown";
+}
+
 RebootThread::RebootThread(DbusInterface &dbus_interface,
                            swss::SelectableEvent &m_finished)
     : m_db("STATE_DB", 0),
       m_finished(m_finished),
-      m_dbus_interface(dbus_interface) {}
+      m_dbus_interface(dbus_interface),
+      m_phase_table(&m_db, REBOOT_PHASE_TABLE),
+      m_progress_table(&m_db, REBOOT_PROGRESS_TABLE) {}
 
 void RebootThread::Stop(void) {
   SWSS_LOG_ENTER();
@@ -61,8 +87,73 @@ RebootStatusResponse RebootThread::GetResponse(void) {
 
 bool RebootThread::HasRun() { return m_status.get_reboot_count() > 0; }
 
-Progress RebootThread::platform_reboot_select(swss::Select &s,
-                                              swss::SelectableTimer &l_timer) {
+RebootPhaseTimes RebootThread::GetPhaseTimes(void) {
+  return m_status.get_phase_times();
+}
+
+void RebootThread::record_phase(RebootPhase phase) {
+  std::chrono::nanoseconds offset = m_status.record_phase(phase);
+  SWSS_LOG_NOTICE(
+      "Reboot phase %s reached %lld ms after request", reboot_phase_name(phase),
+      static_cast<long long>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(offset)
+              .count()));
+  persist_phase_times();
+}
+
+void RebootThread::persist_phase_times(void) {
+  // Values are nanoseconds since the request was received.
+  std::vector<swss::FieldValueTuple> fvs;
+  fvs.emplace_back("method", RebootMethod_Name(m_request.method()));
+  for (const auto &phase_time : m_status.get_phase_times()) {
+    fvs.emplace_back(reboot_phase_name(phase_time.first),
+                     std::to_string(phase_time.second.count()));
+  }
+  m_phase_table.set(REBOOT_PHASE_KEY, fvs);
+}
+
+RebootThread::Status RebootThread::handle_platform_progress(
+    swss::SubscriberStateTable &progress) {
+  SWSS_LOG_ENTER();
+
+  std::deque<swss::KeyOpFieldsValuesTuple> entries;
+  progress.pops(entries);
+
+  for (const auto &entry : entries) {
+    if (kfvKey(entry) != REBOOT_PROGRESS_KEY || kfvOp(entry) != SET_COMMAND) {
+      continue;
+    }
+
+    std::string status;
+    std::string message;
+    for (const auto &fv : kfvFieldsValues(entry)) {
+      if (fvField(fv) == REBOOT_PROGRESS_STATUS_FIELD) {
+        status = fvValue(fv);
+      } else if (fvField(fv) == REBOOT_PROGRESS_MESSAGE_FIELD) {
+        message = fvValue(fv);
+      }
+    }
+    SWSS_LOG_NOTICE("Platform reported reboot progress: %s: %s",
+                    status.c_str(), message.c_str());
+
+    if (status == REBOOT_PROGRESS_FAILURE) {
+      record_phase(RebootPhase::PLATFORM_FAILURE);
+      log_error_and_set_non_retry_failure(
+          message.empty() ? "platform reported reboot failure" : message);
+      return Status::FAILURE;
+    } else if (status == REBOOT_PROGRESS_SUCCESS) {
+      record_phase(RebootPhase::PLATFORM_SUCCESS);
+      m_status.set_completed_status(
+          RebootStatus_Status::RebootStatus_Status_STATUS_SUCCESS, message);
+      return Status::SUCCESS;
+    }
+  }
+  return Status::KEEP_WAITING;
+}
+
+Progress RebootThread::platform_reboot_select(
+    swss::Select &s, swss::SelectableTimer &l_timer,
+    swss::SubscriberStateTable &progress) {
   SWSS_LOG_ENTER();
 
   while (true) {
@@ -77,9 +168,15 @@ Progress RebootThread::platform_reboot_select(swss::Select &s,
         // SIGTERM expected after platform reboot request
         SWSS_LOG_NOTICE(
             "m_stop rx'd (SIGTERM) while waiting for platform reboot");
+        record_phase(RebootPhase::STOP_REQUESTED);
         return Progress::EXIT_EARLY;
       } else if (sel == &l_timer) {
+        record_phase(RebootPhase::TIMEOUT);
         return Progress::PROCEED;
+      } else if (sel == &progress) {
+        if (handle_platform_progress(progress) != Status::KEEP_WAITING) {
+          return Progress::EXIT_EARLY;
+        }
       }
     }
   }
@@ -94,13 +191,22 @@ Progress RebootThread::wait_for_platform_reboot(swss::Select &s) {
       timespec{.tv_sec = m_reboot_timeout, .tv_nsec = 0});
   s.addSelectable(&l_timer);
 
+  // Unless the platform reports the outcome first. Progress written since
+  // this request started, e.g. during the dbus call, is read on subscribe.
+  swss::SubscriberStateTable progress(&m_db, REBOOT_PROGRESS_TABLE);
+  s.addSelectable(&progress);
+
+  m_status.set_wait_deadline(steady_clock::now() +
+                             std::chrono::seconds(m_reboot_timeout));
   l_timer.start();
+  record_phase(RebootPhase::WAITING_FOR_PLATFORM);
 
-  Progress progress = platform_reboot_select(s, l_timer);
+  Progress result = platform_reboot_select(s, l_timer, progress);
 
   l_timer.stop();
+  s.removeSelectable(&progress);
   s.removeSelectable(&l_timer);
-  return progress;
+  return result;
 }
 
 void RebootThread::do_reboot(void) {
@@ -112,6 +218,7 @@ void RebootThread::do_reboot(void) {
   // Check if stop was requested before Selectable was setup
   if (sigterm_requested) {
     SWSS_LOG_ERROR("sigterm_requested was raised, exiting");
+    record_phase(RebootPhase::STOP_REQUESTED);
     return;
   }
 
@@ -142,8 +249,10 @@ RebootThread::Progress RebootThread::send_dbus_reboot_request() {
   }
 
   // Send the reboot request to the reboot host service via dbus.
+  record_phase(RebootPhase::DBUS_REBOOT_SENT);
   DbusInterface::DbusResponse dbus_response =
       m_dbus_interface.Reboot(json_string);
+  record_phase(RebootPhase::DBUS_RESPONSE_RECEIVED);
 
   if (dbus_response.status == DbusInterface::DbusStatus::DBUS_FAIL) {
     log_error_and_set_non_retry_failure(dbus_response.json_string);
@@ -212,6 +321,9 @@ void RebootThread::do_warm_reboot(swss::Select &s) {
 void RebootThread::reboot_thread(void) {
   SWSS_LOG_ENTER();
 
+  // Start() has dropped what a previous attempt left, persist the request.
+  persist_phase_times();
+
   do_reboot();
 
   // Notify calling thread that reboot thread has exited.
@@ -264,6 +376,17 @@ bool RebootThread::check_start_preconditions(const RebootRequest &request,
   return false;
 }
 
+NotificationResponse RebootThread::CheckStart(const RebootRequest &request) {
+  SWSS_LOG_ENTER();
+
+  NotificationResponse response = {.status = swss::StatusCode::SWSS_RC_SUCCESS,
+                                   .json_string = ""};
+  RebootRequest immediate = request;
+  immediate.clear_delay();
+  check_start_preconditions(immediate, response);
+  return response;
+}
+
 NotificationResponse RebootThread::Start(const RebootRequest &request) {
   SWSS_LOG_ENTER();
 
@@ -281,6 +404,12 @@ NotificationResponse RebootThread::Start(const RebootRequest &request) {
   // From this point errors will be reported via RebootStatusRequest.
   m_status.set_start_status(request.method(), request.message());
 
+  // Drop phases and platform progress left over from a previous attempt
+  // before replying, so that progress the platform writes for this request
+  // once Start() returns can not be deleted by the reboot thread.
+  m_phase_table.del(REBOOT_PHASE_KEY);
+  m_progress_table.del(REBOOT_PROGRESS_KEY);
+
   try {
     m_thread = std::thread(&RebootThread::reboot_thread, this);
   } catch (const std::system_error &e) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <map>
 #include <mutex>
 #include <thread>
 
@@ -13,9 +14,30 @@
 #include "selectabletimer.h"
 #include "subscriberstatetable.h"
 #include "system/system.pb.h"
+#include "table.h"
 
 namespace rebootbackend {
 
+// Phases of a reboot attempt, in the order they happen.
+enum class RebootPhase {
+  REQUEST_RECEIVED,        // Start() accepted the request
+  DBUS_REBOOT_SENT,        // dbus Reboot call issued to the host service
+  DBUS_RESPONSE_RECEIVED,  // dbus Reboot call returned
+  WAITING_FOR_PLATFORM,    // waiting for the platform to take us down
+  PLATFORM_SUCCESS,        // platform reported the reboot succeeded
+  PLATFORM_FAILURE,        // platform reported the reboot failed
+  TIMEOUT,                 // platform didn't reboot within the timeout
+  STOP_REQUESTED           // m_stop/SIGTERM rx'd, normally the platform
+                           // shutting us down
+};
+
+// Name of phase as persisted to STATE_DB.
+const char *reboot_phase_name(RebootPhase phase);
+
+// Monotonic time each recorded phase was reached, relative to
+// REQUEST_RECEIVED.
+using RebootPhaseTimes = std::map<RebootPhase, std::chrono::nanoseconds>;
+
 // Hold/manage the contents of a RebootStatusResponse as defined
 // in system.proto
 // Thread-safe: expectation is one thread will write and multiple
@@ -61,9 +83,38 @@ class ThreadStatus {
         std::chrono::system_clock::now().time_since_epoch();
     m_proto_status.set_when(ns.count());
 
+    // Phase timings use the monotonic clock: wall clock may be stepped
+    // while a reboot is in progress.
+    m_start_time = std::chrono::steady_clock::now();
+    m_phase_times.clear();
+    m_phase_times[RebootPhase::REQUEST_RECEIVED] = std::chrono::nanoseconds(0);
+    m_wait_deadline = std::chrono::steady_clock::time_point();
+
     m_mutex.unlock();
   }
 
+  // Record that phase was reached now. Returns the time since the request
+  // was received.
+  std::chrono::nanoseconds record_phase(RebootPhase phase) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::nanoseconds offset =
+        std::chrono::steady_clock::now() - m_start_time;
+    m_phase_times[phase] = offset;
+    return offset;
+  }
+
+  // Time at which we give up waiting for the platform to reboot.
+  // Reported as "wait" in the RebootStatusResponse while active.
+  void set_wait_deadline(std::chrono::steady_clock::time_point deadline) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_wait_deadline = deadline;
+  }
+
+  RebootPhaseTimes get_phase_times(void) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    return m_phase_times;
+  }
+
   bool get_active(void) {
     m_mutex.lock();
     bool ret = m_proto_status.active();
@@ -104,8 +155,21 @@ class ThreadStatus {
     m_mutex.lock();
     // make a copy
     gnoi::system::RebootStatusResponse lstatus = m_proto_status;
+    std::chrono::steady_clock::time_point deadline = m_wait_deadline;
     m_mutex.unlock();
 
+    // Wait is time left until the platform reboot timeout expires.
+    // Only known once we're waiting for the platform.
+    lstatus.set_wait(0);
+    if (lstatus.active() &&
+        deadline != std::chrono::steady_clock::time_point()) {
+      std::chrono::nanoseconds left =
+          deadline - std::chrono::steady_clock::now();
+      if (left.count() > 0) {
+        lstatus.set_wait(left.count());
+      }
+    }
+
     if (lstatus.active()) {
       // RebootStatus isn't applicable if we're active
       lstatus.mutable_status()->set_status(
@@ -124,6 +188,9 @@ class ThreadStatus {
  private:
   std::mutex m_mutex;
   gnoi::system::RebootStatusResponse m_proto_status;
+  std::chrono::steady_clock::time_point m_start_time;
+  std::chrono::steady_clock::time_point m_wait_deadline;
+  RebootPhaseTimes m_phase_times;
 };
 
 // RebootThread performs reboot actions leading up to a platform
@@ -142,6 +209,10 @@ class RebootThread {
 
   NotificationResponse Start(const gnoi::system::RebootRequest &request);
 
+  // Check that request could be started now, ignoring its delay.
+  // Used to reject a delayed request up front instead of when it fires.
+  NotificationResponse CheckStart(const gnoi::system::RebootRequest &request);
+
   // Request thread stop/exit. Only used when platform is shutting down
   // all containers/processes.
   void Stop(void);
@@ -156,6 +227,10 @@ class RebootThread {
   // and false otherwise.
   bool HasRun();
 
+  // Return the phase timings of the last reboot attempt.
+  // These are also persisted to STATE_DB as each phase is reached.
+  RebootPhaseTimes GetPhaseTimes();
+
  private:
   void reboot_thread(void);
   void do_reboot(void);
@@ -167,18 +242,28 @@ class RebootThread {
   // Inner loop select handler to wait for platform reboot.
   //   wait for timeout
   //   wait for a stop request (sigterm)
+  //   wait for platform reported success or failure
   // Returns:
-  //   EXIT_EARLY: an issue occurred that stops WARM
+  //   EXIT_EARLY: an issue occurred that stops WARM, or the platform
+  //               reported the outcome (status already set)
   //   PROCEED: if reboot timeout expired
   Progress platform_reboot_select(swss::Select &s,
-                                  swss::SelectableTimer &l_timer);
+                                  swss::SelectableTimer &l_timer,
+                                  swss::SubscriberStateTable &progress);
 
   // Wait for platform to reboot while waiting for possible stop
   // Returns:
-  //   EXIT_EARLY: an issue occurred that stops WARM
+  //   EXIT_EARLY: an issue occurred that stops WARM, or the platform
+  //               reported the outcome (status already set)
   //   PROCEED: if reboot timeout expired
   Progress wait_for_platform_reboot(swss::Select &s);
 
+  // Read platform progress updates from REBOOT_PROGRESS_TABLE.
+  // Returns:
+  //   SUCCESS/FAILURE: platform reported the outcome, status is set
+  //   KEEP_WAITING: no definitive update yet
+  Status handle_platform_progress(swss::SubscriberStateTable &progress);
+
   // Log error string, set status to RebootStatus_Status_STATUS_FAILURE
   // Set status message to error_string.
   void log_error_and_set_non_retry_failure(const std::string error_string);
@@ -193,6 +278,14 @@ class RebootThread {
   // Return true if preconditions met, false otherwise.
   bool check_start_preconditions(const gnoi::system::RebootRequest &request,
                                  NotificationResponse &response);
+
+  // Record phase in m_status, log it and persist it.
+  void record_phase(RebootPhase phase);
+
+  // Write all phases recorded so far to STATE_DB, so the breakdown survives
+  // the system going down.
+  void persist_phase_times(void);
+
   std::thread m_thread;
 
   // Signal m_finished to let main thread know weve completed.
@@ -203,6 +296,8 @@ class RebootThread {
   swss::SelectableEvent m_stop;
   DbusInterface &m_dbus_interface;
   swss::DBConnector m_db;
+  swss::Table m_phase_table;
+  swss::Table m_progress_table;
   ThreadStatus m_status;
   gnoi::system::RebootRequest m_request;
 
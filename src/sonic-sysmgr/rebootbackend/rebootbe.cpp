@@ -3,6 +3,9 @@
 #include <google/protobuf/util/json_util.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cinttypes>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -25,11 +28,13 @@ RebootBE::RebootBE(DbusInterface &dbus_interface)
       m_RebootResponse(&m_db, REBOOT_RESPONSE_NOTIFICATION_CHANNEL),
       m_NotificationConsumer(&m_db, REBOOT_REQUEST_NOTIFICATION_CHANNEL),
       m_dbus(dbus_interface),
-      m_RebootThread(dbus_interface, m_RebootThreadFinished) {
+      m_RebootThread(dbus_interface, m_RebootThreadFinished),
+      m_DelayTimer(timespec{.tv_sec = 0, .tv_nsec = 0}) {
   swss::Logger::linkToDbNative("rebootbackend");
 }
 
 RebootBE::RebManagerStatus RebootBE::GetCurrentStatus() {
+  const std::lock_guard<std::mutex> lock(m_StatusMutex);
   return m_CurrentStatus;
 }
 
@@ -49,6 +54,7 @@ void RebootBE::Start() {
   s.addSelectable(&m_NotificationConsumer);
   s.addSelectable(&m_Done);
   s.addSelectable(&m_RebootThreadFinished);
+  s.addSelectable(&m_DelayTimer);
 
   SWSS_LOG_NOTICE("RebootBE entering operational loop");
   while (true) {
@@ -63,6 +69,8 @@ void RebootBE::Start() {
         DoTask(m_NotificationConsumer);
       } else if (sel == &m_RebootThreadFinished) {
         HandleRebootFinish();
+      } else if (sel == &m_DelayTimer) {
+        HandleDelayExpired();
       } else if (sel == &m_Done) {
         HandleDone();
         break;
@@ -182,6 +190,10 @@ NotificationResponse RebootBE::HandleRebootRequest(
     		response.json_string =
         	"Reboot not allowed at this time. Warm Reboot in progress";
 		break;
+    	case RebManagerStatus::DELAYED_REBOOT_PENDING:
+    		response.json_string =
+        	"Reboot not allowed at this time. Delayed Reboot pending";
+		break;
 	default:
     		response.json_string =
         	"Reboot not allowed at this time,current reboot status is unknown.";
@@ -192,9 +204,19 @@ NotificationResponse RebootBE::HandleRebootRequest(
     return response;
   }
 
+  if (request.delay() != 0) {
+    return ScheduleDelayedReboot(request);
+  }
+  return StartReboot(request);
+}
+
+NotificationResponse RebootBE::StartReboot(
+    const gnoi::system::RebootRequest &request) {
+  SWSS_LOG_ENTER();
+
   SWSS_LOG_NOTICE("Forwarding request to RebootThread: %s",
                   request.DebugString().c_str());
-  response = m_RebootThread.Start(request);
+  NotificationResponse response = m_RebootThread.Start(request);
   if (response.status == swss::StatusCode::SWSS_RC_SUCCESS) {
     if (request.method() == gnoi::system::RebootMethod::COLD) {
       SetCurrentStatus(RebManagerStatus::COLD_REBOOT_IN_PROGRESS);
@@ -207,12 +229,67 @@ NotificationResponse RebootBE::HandleRebootRequest(
   return response;
 }
 
+NotificationResponse RebootBE::ScheduleDelayedReboot(
+    const gnoi::system::RebootRequest &request) {
+  SWSS_LOG_ENTER();
+
+  // Reject now anything the reboot thread would refuse when the delay
+  // expires: there is nobody left to report the failure to at that point.
+  NotificationResponse response = m_RebootThread.CheckStart(request);
+  if (response.status != swss::StatusCode::SWSS_RC_SUCCESS) {
+    return response;
+  }
+
+  // delay is in nanoseconds. The timer is stopped as soon as it fires, so
+  // the periodic interval it is armed with only sets the first expiration.
+  const uint64_t delay = request.delay();
+  timespec interval = {
+      .tv_sec = static_cast<time_t>(delay / 1000000000ULL),
+      .tv_nsec = static_cast<long>(delay % 1000000000ULL)};
+  m_DelayTimer.setInterval(interval);
+  m_DelayTimer.start();
+
+  m_DelayedRequest = request;
+  m_DelayDeadline =
+      std::chrono::steady_clock::now() + std::chrono::nanoseconds(delay);
+  m_DelayWhen = static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::system_clock::now().time_since_epoch())
+                        .count()) +
+                delay;
+  SetCurrentStatus(RebManagerStatus::DELAYED_REBOOT_PENDING);
+
+  SWSS_LOG_NOTICE("Delayed reboot scheduled in %" PRIu64 " ns: %s", delay,
+                  request.DebugString().c_str());
+  return response;
+}
+
+void RebootBE::HandleDelayExpired() {
+  SWSS_LOG_ENTER();
+
+  m_DelayTimer.stop();
+  if (GetCurrentStatus() != RebManagerStatus::DELAYED_REBOOT_PENDING) {
+    // Cancelled after the timer had already expired.
+    return;
+  }
+  SetCurrentStatus(RebManagerStatus::IDLE);
+
+  gnoi::system::RebootRequest request = m_DelayedRequest;
+  request.clear_delay();
+  NotificationResponse response = StartReboot(request);
+  if (response.status != swss::StatusCode::SWSS_RC_SUCCESS) {
+    SWSS_LOG_ERROR("Delayed reboot failed to start: %s",
+                   response.json_string.c_str());
+  }
+}
+
 bool RebootBE::RebootAllowed(const gnoi::system::RebootMethod rebMethod) {
   RebManagerStatus current_status = GetCurrentStatus();
   switch (current_status) {
     case RebManagerStatus::COLD_REBOOT_IN_PROGRESS:
     case RebManagerStatus::HALT_REBOOT_IN_PROGRESS:
-    case RebManagerStatus::WARM_REBOOT_IN_PROGRESS: {
+    case RebManagerStatus::WARM_REBOOT_IN_PROGRESS:
+    case RebManagerStatus::DELAYED_REBOOT_PENDING: {
       return false;
     }
     case RebManagerStatus::IDLE: {
@@ -228,14 +305,31 @@ NotificationResponse RebootBE::HandleStatusRequest(
     const std::string &jsonStatusRequest) {
   SWSS_LOG_ENTER();
 
+  RebManagerStatus current_status = GetCurrentStatus();
+
   //For Halt reboot, we need to send the status request to the platform
-  if (m_CurrentStatus == RebManagerStatus::HALT_REBOOT_IN_PROGRESS) {
+  if (current_status == RebManagerStatus::HALT_REBOOT_IN_PROGRESS) {
     return RequestRebootStatus(jsonStatusRequest);
   }
 
   gnoi::system::RebootStatusResponse reboot_response =
       m_RebootThread.GetResponse();
 
+  // A pending delayed reboot is active: report the scheduled reboot time
+  // and the time left until then.
+  if (current_status == RebManagerStatus::DELAYED_REBOOT_PENDING) {
+    std::chrono::nanoseconds left = std::max(
+        std::chrono::nanoseconds(0),
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            m_DelayDeadline - std::chrono::steady_clock::now()));
+    reboot_response.set_active(true);
+    reboot_response.set_wait(left.count());
+    reboot_response.set_when(m_DelayWhen);
+    reboot_response.set_reason(m_DelayedRequest.message());
+    reboot_response.set_method(m_DelayedRequest.method());
+    reboot_response.clear_status();
+  }
+
   std::string json_reboot_response_string;
   google::protobuf::util::Status status =
       gpu::MessageToJsonString(reboot_response, &json_reboot_response_string);
@@ -260,13 +354,40 @@ NotificationResponse RebootBE::HandleCancelRequest(
     const std::string &jsonCancelRequest) {
   SWSS_LOG_ENTER();
 
-  NotificationResponse response;
+  // On success an emtpy string is returned. CancelRebootResponse in
+  // system.proto is an empty proto.
+  NotificationResponse response = {.status = swss::StatusCode::SWSS_RC_SUCCESS,
+                                   .json_string = ""};
 
-  // CancelReboot isn't supported: not needed until/unless delayed support
-  // is added: return unimplemented.
-  response.status = swss::StatusCode::SWSS_RC_UNIMPLEMENTED;
-  response.json_string = "Cancel reboot isn't supported";
-  SWSS_LOG_WARN("%s", response.json_string.c_str());
+  gnoi::system::CancelRebootRequest request;
+  google::protobuf::util::Status status =
+      gpu::JsonStringToMessage(jsonCancelRequest, &request);
+
+  if (!status.ok()) {
+    std::string error_string =
+        "unable to convert json to cancelRebootRequest protobuf: " +
+        status.message().as_string();
+    SWSS_LOG_ERROR("%s", error_string.c_str());
+    SWSS_LOG_ERROR("json = |%s|", jsonCancelRequest.c_str());
+    response.status = swss::StatusCode::SWSS_RC_INTERNAL;
+    response.json_string = error_string;
+    return response;
+  }
+
+  // Only a delayed reboot that hasn't started yet can be cancelled.
+  if (GetCurrentStatus() != RebManagerStatus::DELAYED_REBOOT_PENDING) {
+    response.status = swss::StatusCode::SWSS_RC_FAILED_PRECONDITION;
+    response.json_string =
+        GetCurrentStatus() == RebManagerStatus::IDLE
+            ? "Cancel reboot not allowed: no delayed reboot pending"
+            : "Cancel reboot not allowed: reboot in progress";
+    SWSS_LOG_WARN("%s", response.json_string.c_str());
+    return response;
+  }
+
+  m_DelayTimer.stop();
+  SetCurrentStatus(RebManagerStatus::IDLE);
+  SWSS_LOG_NOTICE("Delayed reboot cancelled: %s", request.message().c_str());
   return response;
 }
 
@@ -311,6 +432,11 @@ void RebootBE::HandleRebootFinish() {
 void RebootBE::HandleDone() {
   SWSS_LOG_INFO("RebootBE received signal to stop");
 
+  if (GetCurrentStatus() == RebManagerStatus::DELAYED_REBOOT_PENDING) {
+    m_DelayTimer.stop();
+    SetCurrentStatus(RebManagerStatus::IDLE);
+  }
+
   if (m_RebootThread.GetResponse().active()) {
     m_RebootThread.Stop();
     m_RebootThread.Join();
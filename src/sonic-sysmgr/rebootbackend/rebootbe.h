@@ -1,4 +1,6 @@
 #pragma once
+#include <chrono>
+
 #include "dbconnector.h"
 #include "notificationconsumer.h"
 #include "notificationproducer.h"
@@ -6,6 +8,7 @@
 #include "reboot_interfaces.h"
 #include "reboot_thread.h"
 #include "selectableevent.h"
+#include "selectabletimer.h"
 #include "status_code_util.h"
 
 namespace rebootbackend {
@@ -24,7 +27,8 @@ class RebootBE {
     IDLE,
     COLD_REBOOT_IN_PROGRESS,
     HALT_REBOOT_IN_PROGRESS,
-    WARM_REBOOT_IN_PROGRESS
+    WARM_REBOOT_IN_PROGRESS,
+    DELAYED_REBOOT_PENDING
   };
 
   struct NotificationRequest {
@@ -58,6 +62,14 @@ class RebootBE {
   swss::SelectableEvent m_RebootThreadFinished;
   RebootThread m_RebootThread;
 
+  // Delayed reboot: m_DelayTimer is armed for the requested delay while
+  // status is DELAYED_REBOOT_PENDING and fires m_DelayedRequest on expiry.
+  // Only accessed from the Start() loop.
+  swss::SelectableTimer m_DelayTimer;
+  gnoi::system::RebootRequest m_DelayedRequest;
+  std::chrono::steady_clock::time_point m_DelayDeadline;
+  uint64_t m_DelayWhen = 0;  // nanoseconds since epoch
+
   void SetCurrentStatus(RebManagerStatus newStatus);
 
   // Reboot_Request_Channel notifications should all contain {"MESSAGE" : Data}
@@ -77,6 +89,17 @@ class RebootBE {
       const std::string &jsonStatusRequest);
   NotificationResponse HandleCancelRequest(
       const std::string &jsonCancelRequest);
+
+  // Forward request to the reboot thread and update current status.
+  NotificationResponse StartReboot(const gnoi::system::RebootRequest &request);
+
+  // Validate request and arm m_DelayTimer for request.delay() nanoseconds.
+  NotificationResponse ScheduleDelayedReboot(
+      const gnoi::system::RebootRequest &request);
+
+  // Delay expired: start the pending reboot.
+  void HandleDelayExpired();
+
   void SendNotificationResponse(const std::string key,
                                 const swss::StatusCode code,
                                 const std::string message);
@@ -16,6 +16,7 @@
 #include "selectableevent.h"
 #include "status_code_util.h"
 #include "system/system.pb.h"
+#include "table.h"
 #include "timestamp.h"
 
 namespace rebootbackend {
@@ -28,6 +29,7 @@ using RebootThread = ::rebootbackend::RebootThread;
 using ::testing::_;
 using ::testing::ExplainMatchResult;
 using ::testing::HasSubstr;
+using ::testing::Invoke;
 using ::testing::NiceMock;
 using ::testing::Return;
 using ::testing::StrEq;
@@ -155,6 +157,38 @@ TEST_F(RebootStatusTest, TestGetWarmStatus) {
   EXPECT_EQ(0, response.when());
 }
 
+TEST_F(RebootStatusTest, TestPhaseTimes) {
+  m_status.set_start_status(gnoi::system::RebootMethod::WARM, "");
+  RebootPhaseTimes phases = m_status.get_phase_times();
+  ASSERT_EQ(phases.size(), 1u);
+  EXPECT_EQ(phases[RebootPhase::REQUEST_RECEIVED].count(), 0);
+
+  std::chrono::nanoseconds sent =
+      m_status.record_phase(RebootPhase::DBUS_REBOOT_SENT);
+  std::chrono::nanoseconds waiting =
+      m_status.record_phase(RebootPhase::WAITING_FOR_PLATFORM);
+  EXPECT_LE(sent, waiting);
+  phases = m_status.get_phase_times();
+  EXPECT_EQ(phases.size(), 3u);
+  EXPECT_EQ(phases[RebootPhase::WAITING_FOR_PLATFORM], waiting);
+
+  // Wait is reported while active and a deadline is known.
+  EXPECT_EQ(m_status.get_response().wait(), 0u);
+  m_status.set_wait_deadline(std::chrono::steady_clock::now() +
+                             std::chrono::seconds(10));
+  uint64_t wait = m_status.get_response().wait();
+  EXPECT_GT(wait, 0u);
+  EXPECT_LE(wait, 10000000000ULL);
+
+  m_status.set_inactive();
+  EXPECT_EQ(m_status.get_response().wait(), 0u);
+
+  // A new request starts from scratch.
+  m_status.set_start_status(gnoi::system::RebootMethod::COLD, "");
+  EXPECT_EQ(m_status.get_phase_times().size(), 1u);
+  EXPECT_EQ(m_status.get_response().wait(), 0u);
+}
+
 class RebootThreadTest : public ::testing::Test {
  protected:
   RebootThreadTest()
@@ -163,6 +197,16 @@ class RebootThreadTest : public ::testing::Test {
         m_config_db("CONFIG_DB", 0),
         m_reboot_thread(m_dbus_interface, m_finished) {
     sigterm_requested = false;
+    swss::Table(&m_db, REBOOT_PROGRESS_TABLE).del(REBOOT_PROGRESS_KEY);
+  }
+
+  // Fake the platform reporting reboot progress.
+  void set_platform_progress(const std::string &status,
+                             const std::string &message) {
+    swss::Table table(&m_db, REBOOT_PROGRESS_TABLE);
+    table.set(REBOOT_PROGRESS_KEY,
+              {{REBOOT_PROGRESS_STATUS_FIELD, status},
+               {REBOOT_PROGRESS_MESSAGE_FIELD, message}});
   }
 
   void overwrite_reboot_timeout(uint32_t timeout_seconds) {
@@ -206,6 +250,22 @@ class RebootThreadTest : public ::testing::Test {
     return m_reboot_thread.m_stop;
   }
 
+  // Phases in STATE_DB must match the in-memory breakdown.
+  void check_persisted_phases(const RebootPhaseTimes &phases,
+                              const std::string &method) {
+    swss::Table table(&m_db, REBOOT_PHASE_TABLE);
+    std::vector<swss::FieldValueTuple> fvs;
+    ASSERT_TRUE(table.get(REBOOT_PHASE_KEY, fvs));
+    EXPECT_EQ(fvs.size(), phases.size() + 1);
+
+    std::map<std::string, std::string> fields(fvs.begin(), fvs.end());
+    EXPECT_EQ(fields["method"], method);
+    for (const auto &phase_time : phases) {
+      EXPECT_EQ(fields[reboot_phase_name(phase_time.first)],
+                std::to_string(phase_time.second.count()));
+    }
+  }
+
   swss::DBConnector m_db;
   swss::DBConnector m_config_db;
   NiceMock<MockDbusInterface> m_dbus_interface;
@@ -388,4 +448,211 @@ TEST_F(RebootThreadTest, TestWaitForRebootPositive) {
   EXPECT_EQ(progress, RebootThread::Progress::PROCEED);
 }
 
+TEST_F(RebootThreadTest, TestPlatformReportsFailure) {
+  EXPECT_CALL(m_dbus_interface, Reboot(_))
+      .Times(1)
+      .WillOnce(Return(DbusInterface::DbusResponse{
+          DbusInterface::DbusStatus::DBUS_SUCCESS, ""}));
+
+  swss::Select s;
+  s.addSelectable(&m_finished);
+
+  gnoi::system::RebootRequest request;
+  request.set_method(gnoi::system::RebootMethod::WARM);
+  m_reboot_thread.Start(request);
+
+  // Progress updates don't end the wait.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  set_platform_progress(REBOOT_PROGRESS_IN_PROGRESS, "saving state");
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_TRUE(get_response().active());
+
+  // A failure ends it long before the reboot timeout.
+  set_platform_progress(REBOOT_PROGRESS_FAILURE, "orchagent freeze failed");
+  wait_for_finish(s, m_finished, 1);
+  m_reboot_thread.Join();
+
+  EXPECT_THAT(m_reboot_thread.GetResponse(),
+              IsStatus(gnoi::system::RebootStatus_Status::
+                           RebootStatus_Status_STATUS_FAILURE,
+                       "orchagent freeze failed"));
+  RebootPhaseTimes phases = m_reboot_thread.GetPhaseTimes();
+  EXPECT_EQ(phases.count(RebootPhase::PLATFORM_FAILURE), 1u);
+  EXPECT_EQ(phases.count(RebootPhase::TIMEOUT), 0u);
+  check_persisted_phases(phases, "WARM");
+
+  // Like a timeout, a platform failure blocks further warm reboots.
+  NotificationResponse response = m_reboot_thread.Start(request);
+  EXPECT_EQ(response.status, swss::StatusCode::SWSS_RC_FAILED_PRECONDITION);
+}
+
+TEST_F(RebootThreadTest, TestPlatformFailureDuringDbusCall) {
+  // Platform fails the request before the dbus call returns: the update is
+  // picked up as soon as the wait starts.
+  EXPECT_CALL(m_dbus_interface, Reboot(_))
+      .Times(1)
+      .WillOnce(Invoke([this](const std::string &) {
+        set_platform_progress(REBOOT_PROGRESS_FAILURE, "");
+        return DbusInterface::DbusResponse{
+            DbusInterface::DbusStatus::DBUS_SUCCESS, ""};
+      }));
+
+  swss::Select s;
+  s.addSelectable(&m_finished);
+
+  gnoi::system::RebootRequest request;
+  request.set_method(gnoi::system::RebootMethod::COLD);
+  m_reboot_thread.Start(request);
+  wait_for_finish(s, m_finished, 1);
+  m_reboot_thread.Join();
+
+  EXPECT_THAT(m_reboot_thread.GetResponse(),
+              IsStatus(gnoi::system::RebootStatus_Status::
+                           RebootStatus_Status_STATUS_FAILURE,
+                       "platform reported reboot failure"));
+}
+
+TEST_F(RebootThreadTest, TestPlatformReportsSuccess) {
+  EXPECT_CALL(m_dbus_interface, Reboot(_))
+      .Times(1)
+      .WillOnce(Return(DbusInterface::DbusResponse{
+          DbusInterface::DbusStatus::DBUS_SUCCESS, ""}));
+
+  swss::Select s;
+  s.addSelectable(&m_finished);
+
+  gnoi::system::RebootRequest request;
+  request.set_method(gnoi::system::RebootMethod::HALT);
+  m_reboot_thread.Start(request);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  set_platform_progress(REBOOT_PROGRESS_SUCCESS, "halted");
+  wait_for_finish(s, m_finished, 1);
+  m_reboot_thread.Join();
+
+  gnoi::system::RebootStatusResponse response = m_reboot_thread.GetResponse();
+  EXPECT_FALSE(response.active());
+  EXPECT_THAT(response, IsStatus(gnoi::system::RebootStatus_Status::
+                                     RebootStatus_Status_STATUS_SUCCESS,
+                                 "halted"));
+  EXPECT_EQ(m_reboot_thread.GetPhaseTimes().count(RebootPhase::PLATFORM_SUCCESS),
+            1u);
+}
+
+TEST_F(RebootThreadTest, TestStalePlatformProgressIgnored) {
+  EXPECT_CALL(m_dbus_interface, Reboot(_))
+      .Times(1)
+      .WillOnce(Return(DbusInterface::DbusResponse{
+          DbusInterface::DbusStatus::DBUS_SUCCESS, ""}));
+  overwrite_reboot_timeout(1);
+
+  // Left over from an earlier attempt: cleared when the request starts.
+  set_platform_progress(REBOOT_PROGRESS_SUCCESS, "stale");
+
+  swss::Select s;
+  s.addSelectable(&m_finished);
+
+  gnoi::system::RebootRequest request;
+  request.set_method(gnoi::system::RebootMethod::COLD);
+  m_reboot_thread.Start(request);
+  wait_for_finish(s, m_finished, 3);
+  m_reboot_thread.Join();
+
+  EXPECT_THAT(m_reboot_thread.GetResponse(),
+              IsStatus(gnoi::system::RebootStatus_Status::
+                           RebootStatus_Status_STATUS_FAILURE,
+                       "platform failed to reboot"));
+  EXPECT_EQ(m_reboot_thread.GetPhaseTimes().count(RebootPhase::TIMEOUT), 1u);
+}
+
+TEST_F(RebootThreadTest, TestPhaseTimesOnTimeout) {
+  // Fake a slow host service so the dbus phases are measurably apart.
+  EXPECT_CALL(m_dbus_interface, Reboot(_))
+      .Times(1)
+      .WillOnce(Invoke([](const std::string &) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return DbusInterface::DbusResponse{
+            DbusInterface::DbusStatus::DBUS_SUCCESS, ""};
+      }));
+
+  overwrite_reboot_timeout(1);
+
+  swss::Select s;
+  s.addSelectable(&m_finished);
+
+  gnoi::system::RebootRequest request;
+  request.set_method(gnoi::system::RebootMethod::COLD);
+  m_reboot_thread.Start(request);
+
+  // While waiting for the platform, wait is the time left until timeout.
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  gnoi::system::RebootStatusResponse response = get_response();
+  EXPECT_TRUE(response.active());
+  EXPECT_GT(response.wait(), 0u);
+  EXPECT_LT(response.wait(), 1000000000ULL);
+
+  wait_for_finish(s, m_finished, 5);
+  m_reboot_thread.Join();
+
+  RebootPhaseTimes phases = m_reboot_thread.GetPhaseTimes();
+  ASSERT_EQ(phases.size(), 5u);
+  EXPECT_EQ(phases.count(RebootPhase::STOP_REQUESTED), 0u);
+  EXPECT_EQ(phases[RebootPhase::REQUEST_RECEIVED].count(), 0);
+  EXPECT_LE(phases[RebootPhase::REQUEST_RECEIVED],
+            phases[RebootPhase::DBUS_REBOOT_SENT]);
+  EXPECT_GE(phases[RebootPhase::DBUS_RESPONSE_RECEIVED] -
+                phases[RebootPhase::DBUS_REBOOT_SENT],
+            std::chrono::milliseconds(50));
+  EXPECT_LE(phases[RebootPhase::DBUS_RESPONSE_RECEIVED],
+            phases[RebootPhase::WAITING_FOR_PLATFORM]);
+  EXPECT_GE(phases[RebootPhase::TIMEOUT] -
+                phases[RebootPhase::WAITING_FOR_PLATFORM],
+            std::chrono::seconds(1));
+
+  check_persisted_phases(phases, "COLD");
+}
+
+TEST_F(RebootThreadTest, TestPhaseTimesOnDbusFailure) {
+  EXPECT_CALL(m_dbus_interface, Reboot(_))
+      .Times(1)
+      .WillOnce(Return(DbusInterface::DbusResponse{
+          DbusInterface::DbusStatus::DBUS_FAIL, "dbus reboot failed"}));
+
+  swss::Select s;
+  s.addSelectable(&m_finished);
+
+  gnoi::system::RebootRequest request;
+  request.set_method(gnoi::system::RebootMethod::WARM);
+  m_reboot_thread.Start(request);
+  wait_for_finish(s, m_finished, 5);
+  m_reboot_thread.Join();
+
+  // Phases of earlier tests must not leak into STATE_DB.
+  RebootPhaseTimes phases = m_reboot_thread.GetPhaseTimes();
+  ASSERT_EQ(phases.size(), 3u);
+  EXPECT_EQ(phases.count(RebootPhase::DBUS_RESPONSE_RECEIVED), 1u);
+  EXPECT_EQ(phases.count(RebootPhase::WAITING_FOR_PLATFORM), 0u);
+  check_persisted_phases(phases, "WARM");
+}
+
+TEST_F(RebootThreadTest, TestPhaseTimesOnStop) {
+  EXPECT_CALL(m_dbus_interface, Reboot(_))
+      .Times(1)
+      .WillOnce(Return(DbusInterface::DbusResponse{
+          DbusInterface::DbusStatus::DBUS_SUCCESS, ""}));
+  overwrite_reboot_timeout(5);
+
+  gnoi::system::RebootRequest request;
+  request.set_method(gnoi::system::RebootMethod::WARM);
+  m_reboot_thread.Start(request);
+  m_reboot_thread.Stop();
+  m_reboot_thread.Join();
+
+  RebootPhaseTimes phases = m_reboot_thread.GetPhaseTimes();
+  EXPECT_EQ(phases.count(RebootPhase::STOP_REQUESTED), 1u);
+  EXPECT_EQ(phases.count(RebootPhase::TIMEOUT), 0u);
+  EXPECT_LT(phases[RebootPhase::STOP_REQUESTED], std::chrono::seconds(5));
+  check_persisted_phases(phases, "WARM");
+}
+
 }  // namespace rebootbackend
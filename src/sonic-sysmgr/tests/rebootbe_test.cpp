@@ -85,6 +85,15 @@ class RebootBETestWithoutStop : public ::testing::Test {
         std::make_unique<std::thread>(&RebootBE::Start, &m_rebootbe);
   }
 
+  // Fake the platform reporting reboot progress.
+  void set_platform_progress(const std::string &status,
+                             const std::string &message) {
+    swss::Table table(&m_db, REBOOT_PROGRESS_TABLE);
+    table.set(REBOOT_PROGRESS_KEY,
+              {{REBOOT_PROGRESS_STATUS_FIELD, status},
+               {REBOOT_PROGRESS_MESSAGE_FIELD, message}});
+  }
+
   void set_mock_defaults() {
     ON_CALL(m_dbus_interface, Reboot(_))
         .WillByDefault(Return(DbusInterface::DbusResponse{
@@ -112,6 +121,11 @@ class RebootBETestWithoutStop : public ::testing::Test {
     SendRebootRequest("Reboot", "StatusCode", DATA_TUPLE_KEY, json_string);
   }
 
+  void SendCancelRebootRequest(void) {
+    SendRebootRequest("CancelReboot", "StatusCode", DATA_TUPLE_KEY,
+                      "{\"message\":\"cancel delayed reboot\"}");
+  }
+
   void SendRebootStatusRequest(void) {
     SendRebootRequest("RebootStatus", "StatusCode", DATA_TUPLE_KEY,
                       "json status request");
@@ -176,6 +190,25 @@ class RebootBETestWithoutStop : public ::testing::Test {
     consumer.pop(op, data, values);
   }
 
+  void do_cancel_reboot_rpc(
+      swss::StatusCode expected_result = swss::StatusCode::SWSS_RC_SUCCESS) {
+    SendCancelRebootRequest();
+    while (true) {
+      int ret;
+      swss::Selectable *sel;
+      ret = m_s.select(&sel, SELECT_TIMEOUT_250_MS);
+      if (ret != swss::Select::OBJECT) continue;
+      if (sel != &m_rebootbeReponseChannel) continue;
+      break;
+    }
+    std::string op, data;
+    std::vector<swss::FieldValueTuple> ret_values;
+    m_rebootbeReponseChannel.pop(op, data, ret_values);
+
+    EXPECT_THAT(op, StrEq("CancelReboot"));
+    EXPECT_THAT(data, StrEq(swss::statusCodeToStr(expected_result)));
+  }
+
   NotificationResponse handle_reboot_request(std::string &json_request) {
     return m_rebootbe.HandleRebootRequest(json_request);
   }
@@ -242,8 +275,9 @@ TEST_P(RebootBEAutoStartTest, TestCancelReboot) {
   swss::NotificationConsumer consumer(&m_db,
                                       REBOOT_RESPONSE_NOTIFICATION_CHANNEL);
 
+  // Nothing to cancel without a pending delayed reboot.
   SendRebootRequest("CancelReboot", "StatusCode", DATA_TUPLE_KEY,
-                    "json cancelreboot request");
+                    "{\"message\":\"cancel\"}");
   EXPECT_EQ(m_rebootbe.GetCurrentStatus(), RebootBE::RebManagerStatus::IDLE);
 
   std::string op, data;
@@ -251,9 +285,8 @@ TEST_P(RebootBEAutoStartTest, TestCancelReboot) {
   GetNotificationResponse(consumer, op, data, ret_values);
 
   EXPECT_THAT(op, StrEq("CancelReboot"));
-  EXPECT_THAT(
-      data,
-      StrEq(swss::statusCodeToStr(swss::StatusCode::SWSS_RC_UNIMPLEMENTED)));
+  EXPECT_THAT(data, StrEq(swss::statusCodeToStr(
+                        swss::StatusCode::SWSS_RC_FAILED_PRECONDITION)));
 }
 
 TEST_P(RebootBEAutoStartTest, TestUnrecognizedOP) {
@@ -417,6 +450,34 @@ TEST_P(RebootBEAutoStartTest, TestWarmBootDbusError) {
                        "dbus reboot failed"));
 }
 
+TEST_P(RebootBEAutoStartTest, TestWarmBootPlatformFailure) {
+  set_mock_defaults();
+
+  RebootRequest request;
+  request.set_method(RebootMethod::WARM);
+  start_reboot_via_rpc(request);
+  EXPECT_EQ(m_rebootbe.GetCurrentStatus(),
+            RebootBE::RebManagerStatus::WARM_REBOOT_IN_PROGRESS);
+
+  // Failure is reported without waiting out the reboot timeout.
+  set_platform_progress(REBOOT_PROGRESS_FAILURE, "warm reboot failed");
+  std::this_thread::sleep_for(std::chrono::milliseconds(TENTH_SECOND_MS));
+  EXPECT_EQ(m_rebootbe.GetCurrentStatus(), RebootBE::RebManagerStatus::IDLE);
+
+  gnoi::system::RebootStatusResponse response = do_reboot_status_rpc();
+  EXPECT_THAT(response, ActiveCountMethod(false, 1, RebootMethod::WARM));
+  EXPECT_THAT(response,
+              IsStatus(RebootStatus_Status::RebootStatus_Status_STATUS_FAILURE,
+                       "warm reboot failed"));
+
+  // Cold reboot is still allowed to recover.
+  request.set_method(RebootMethod::COLD);
+  start_reboot_via_rpc(request);
+  send_stop_reboot_thread();
+  std::this_thread::sleep_for(std::chrono::milliseconds(TENTH_SECOND_MS));
+  EXPECT_EQ(m_rebootbe.GetCurrentStatus(), RebootBE::RebManagerStatus::IDLE);
+}
+
 TEST_P(RebootBEAutoStartTest, TestStopDuringColdBoot) {
   set_mock_defaults();
 
@@ -458,6 +519,105 @@ TEST_P(RebootBEAutoStartTest, TestStopDuringWarmBoot) {
       IsStatus(RebootStatus_Status::RebootStatus_Status_STATUS_UNKNOWN, ""));
 }
 
+TEST_P(RebootBEAutoStartTest, TestDelayedColdBoot) {
+  EXPECT_CALL(m_dbus_interface, Reboot(_))
+      .Times(1)
+      .WillOnce(Return(DbusInterface::DbusResponse{
+          DbusInterface::DbusStatus::DBUS_SUCCESS, ""}));
+  overwrite_reboot_timeout(1);
+
+  const uint64_t delay_ns = 500 * 1000 * 1000ULL;
+  uint64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::system_clock::now().time_since_epoch())
+                        .count();
+  RebootRequest request;
+  request.set_method(RebootMethod::COLD);
+  request.set_delay(delay_ns);
+  request.set_message("delayed cold reboot");
+  start_reboot_via_rpc(request);
+  EXPECT_EQ(m_rebootbe.GetCurrentStatus(),
+            RebootBE::RebManagerStatus::DELAYED_REBOOT_PENDING);
+
+  // Pending reboot reports the countdown.
+  gnoi::system::RebootStatusResponse response = do_reboot_status_rpc();
+  EXPECT_THAT(response, ActiveCountMethod(true, 0, RebootMethod::COLD));
+  EXPECT_EQ(response.reason(), "delayed cold reboot");
+  EXPECT_GT(response.wait(), 0u);
+  EXPECT_LE(response.wait(), delay_ns);
+  EXPECT_GE(response.when(), now_ns + delay_ns);
+
+  // Other reboots are rejected while one is pending.
+  RebootRequest warm_request;
+  warm_request.set_method(RebootMethod::WARM);
+  start_reboot_via_rpc(warm_request, swss::StatusCode::SWSS_RC_IN_USE);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(ONE_SECOND_MS));
+  EXPECT_EQ(m_rebootbe.GetCurrentStatus(),
+            RebootBE::RebManagerStatus::COLD_REBOOT_IN_PROGRESS);
+
+  // Delayed reboot runs like an immediate one once started.
+  sleep(TWO_SECONDS);
+  EXPECT_EQ(m_rebootbe.GetCurrentStatus(), RebootBE::RebManagerStatus::IDLE);
+  response = do_reboot_status_rpc();
+  EXPECT_THAT(response, ActiveCountMethod(false, 1, RebootMethod::COLD));
+  EXPECT_THAT(response,
+              IsStatus(RebootStatus_Status::RebootStatus_Status_STATUS_FAILURE,
+                       "platform failed to reboot"));
+}
+
+TEST_P(RebootBEAutoStartTest, TestCancelDelayedReboot) {
+  EXPECT_CALL(m_dbus_interface, Reboot(_)).Times(0);
+
+  RebootRequest request;
+  request.set_method(RebootMethod::WARM);
+  request.set_delay(ONE_SECOND * 1000 * 1000 * 1000ULL);
+  start_reboot_via_rpc(request);
+  EXPECT_EQ(m_rebootbe.GetCurrentStatus(),
+            RebootBE::RebManagerStatus::DELAYED_REBOOT_PENDING);
+
+  do_cancel_reboot_rpc();
+  EXPECT_EQ(m_rebootbe.GetCurrentStatus(), RebootBE::RebManagerStatus::IDLE);
+
+  // Nothing fires once the delay has passed.
+  sleep(TWO_SECONDS);
+  EXPECT_EQ(m_rebootbe.GetCurrentStatus(), RebootBE::RebManagerStatus::IDLE);
+  gnoi::system::RebootStatusResponse response = do_reboot_status_rpc();
+  EXPECT_FALSE(response.active());
+  EXPECT_EQ(response.wait(), 0u);
+
+  do_cancel_reboot_rpc(swss::StatusCode::SWSS_RC_FAILED_PRECONDITION);
+}
+
+TEST_P(RebootBEAutoStartTest, TestCancelRebootInProgress) {
+  set_mock_defaults();
+
+  RebootRequest request;
+  request.set_method(RebootMethod::COLD);
+  start_reboot_via_rpc(request);
+  EXPECT_EQ(m_rebootbe.GetCurrentStatus(),
+            RebootBE::RebManagerStatus::COLD_REBOOT_IN_PROGRESS);
+
+  // Only a pending delayed reboot can be cancelled.
+  do_cancel_reboot_rpc(swss::StatusCode::SWSS_RC_FAILED_PRECONDITION);
+  EXPECT_EQ(m_rebootbe.GetCurrentStatus(),
+            RebootBE::RebManagerStatus::COLD_REBOOT_IN_PROGRESS);
+
+  send_stop_reboot_thread();
+  std::this_thread::sleep_for(std::chrono::milliseconds(TENTH_SECOND_MS));
+  EXPECT_EQ(m_rebootbe.GetCurrentStatus(), RebootBE::RebManagerStatus::IDLE);
+}
+
+TEST_P(RebootBEAutoStartTest, TestDelayedRebootUnsupportedMethod) {
+  EXPECT_CALL(m_dbus_interface, Reboot(_)).Times(0);
+
+  // Rejected when requested, not when the delay expires.
+  RebootRequest request;
+  request.set_method(RebootMethod::POWERDOWN);
+  request.set_delay(ONE_SECOND * 1000 * 1000 * 1000ULL);
+  start_reboot_via_rpc(request, swss::StatusCode::SWSS_RC_INVALID_PARAM);
+  EXPECT_EQ(m_rebootbe.GetCurrentStatus(), RebootBE::RebManagerStatus::IDLE);
+}
+
 TEST_P(RebootBEAutoStartTest, TestInvalidJsonRebootRequest) {
   std::string json_request = "abcd";
   NotificationResponse response = handle_reboot_request(json_request);